@@ -0,0 +1,24 @@
+#shader vertex
+#version 330 core
+
+// Corner of the unit cube [-1, 1], scaled to the queried box
+layout(location = 0) in vec3 position;
+
+uniform mat4 u_ViewProjection;
+uniform vec4 u_Center;
+uniform vec4 u_Extents;
+
+void main()
+{
+   gl_Position = u_ViewProjection * vec4(u_Center.xyz + position * u_Extents.xyz, 1.0);
+};
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+void main()
+{
+	color = vec4(1.0);
+};
@@ -0,0 +1,33 @@
+#shader vertex
+#version 330 core
+
+layout(location = 0) in vec4 position;
+layout(location = 1) in vec2 texCoord;
+layout(location = 7) in uint a_DrawID;    // IndirectDrawList::DrawIDLocation
+
+out vec2 v_TexCoord;
+
+uniform mat4 u_MVP;
+// Per-draw translation, indexed by the draw id of IndirectDrawList
+uniform vec4 u_DrawOffsets[256];
+
+void main()
+{
+   gl_Position = u_MVP * (position + vec4(u_DrawOffsets[a_DrawID].xyz, 0.0));
+   v_TexCoord = texCoord;
+};
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec2 v_TexCoord;
+
+uniform sampler2D u_Texture;
+
+void main()
+{
+	vec4 texColor = texture(u_Texture, v_TexCoord);
+	color = texColor;
+};
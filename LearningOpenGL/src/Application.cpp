@@ -4,17 +4,46 @@
 #include <fstream>
 #include <string>
 #include <sstream>
+#include <atomic>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
 
 #include "Renderer.h"
 #include "VertexBuffer.h"
 #include "VertexBufferLayout.h"
 #include "IndexBuffer.h"
 #include "VertexArray.h"
+#include "VertexArrayCache.h"
+#include "MeshPool.h"
 #include "Shader.h"
 #include "Texture.h"
-
-#include "glm\glm.hpp"
-#include "glm\gtc\matrix_transform.hpp"
+#include "EntityWorld.h"
+#include "Components.h"
+#include "RenderExtraction.h"
+#include "DepthRasterizer.h"
+#include "OcclusionCuller.h"
+#include "JobSystem.h"
+#include "RenderThread.h"
+#include "RenderContext.h"
+#include "CommandBuffer.h"
+#include "ResourceLoader.h"
+#include "ResourceRegistry.h"
+#include "FrameArena.h"
+#include "MemoryStats.h"
+#include "Profiler.h"
+#include "RenderStats.h"
+#include "FrameTimer.h"
+#include "MeshFile.h"
+#include "MeshImporter.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "glm/gtc/constants.hpp"
 
 void APIENTRY debugMessageCallback(
     GLenum source,
@@ -27,6 +56,8 @@ void APIENTRY debugMessageCallback(
 {
     // Ignore some not important error or warning
     if (id == 131169 || id == 131185 || id == 131218 || id == 131204) return;
+    // Profiler zones push a debug group every frame
+    if (type == GL_DEBUG_TYPE_PUSH_GROUP || type == GL_DEBUG_TYPE_POP_GROUP) return;
 
     std::cout << "---------------" << std::endl;
     std::cout << "Debug message (" << id << "): " << message << std::endl;
@@ -66,79 +97,233 @@ void APIENTRY debugMessageCallback(
 
 
 
-int main(void)
+struct Options
+{
+    bool Headless = false;
+    unsigned int Width = 640;
+    unsigned int Height = 480;
+    unsigned int Frames = 0;    // 0 runs until the window closes, headless runs default to 300
+    std::string Output;         // last headless frame as PPM
+    std::string Mesh;           // .mesh drawn by the scene instead of the generated sphere
+    std::string ConvertInput;   // OBJ/glTF to convert to ConvertOutput, nothing is rendered then
+    std::string ConvertOutput;
+    std::string StatsCsv;       // renderer counters of every frame
+    std::string Trace;          // Chrome trace of the profiler zones, written on exit
+    std::string FrameTimes;     // frame time percentiles and stutters, written on exit
+};
+
+static bool ParseOptions(int argc, char* argv[], Options& options)
 {
-    GLFWwindow* window;
+    for (int i = 1; i < argc; ++i)
+    {
+        const char* argument = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
 
-    /* Initialize the library */
-    if (!glfwInit())
-        return -1;
+        if (std::strcmp(argument, "--headless") == 0)
+        {
+            options.Headless = true;
+        }
+        else if (std::strcmp(argument, "--resolution") == 0 && value)
+        {
+            if (std::sscanf(value, "%ux%u", &options.Width, &options.Height) != 2 || !options.Width || !options.Height)
+                return false;
+            ++i;
+        }
+        else if (std::strcmp(argument, "--frames") == 0 && value)
+        {
+            options.Frames = (unsigned int)std::strtoul(value, nullptr, 10);
+            ++i;
+        }
+        else if (std::strcmp(argument, "--output") == 0 && value)
+        {
+            options.Output = value;
+            ++i;
+        }
+        else if (std::strcmp(argument, "--mesh") == 0 && value)
+        {
+            options.Mesh = value;
+            ++i;
+        }
+        else if (std::strcmp(argument, "--convert") == 0 && value && i + 2 < argc)
+        {
+            options.ConvertInput = value;
+            options.ConvertOutput = argv[i + 2];
+            i += 2;
+        }
+        else if (std::strcmp(argument, "--stats-csv") == 0 && value)
+        {
+            options.StatsCsv = value;
+            ++i;
+        }
+        else if (std::strcmp(argument, "--trace") == 0 && value)
+        {
+            options.Trace = value;
+            ++i;
+        }
+        else if (std::strcmp(argument, "--frame-times") == 0 && value)
+        {
+            options.FrameTimes = value;
+            ++i;
+        }
+        else
+        {
+            return false;
+        }
+    }
 
-    /* Specified OpenGL version and use core profile */
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_CORE_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    /* Nothing ever closes a headless context */
+    if (options.Headless && options.Frames == 0)
+        options.Frames = 300;
 
-    /* Create debug context before create OpenGL context */
-    glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GL_TRUE);
+    /* A window's back buffer is undefined after the swap */
+    return options.Output.empty() || options.Headless;
+}
 
-    /* Create a windowed mode window and its OpenGL context */
-    window = glfwCreateWindow(640, 480, "Hello World", NULL, NULL);
-    if (!window)
+/* UV sphere with the same vertex format as imported meshes: float3 position, float2 texcoord, float3 normal */
+static void CreateSphere(MeshData& mesh, float radius, unsigned int rings, unsigned int segments)
+{
+    mesh = MeshData();
+    mesh.Layout.Push<float>(3);
+    mesh.Layout.Push<float>(2);
+    mesh.Layout.Push<float>(3);
+
+    /* The first and last column meet at the texture seam, so they are separate vertices */
+    std::vector<float> vertices;
+    for (unsigned int ring = 0; ring <= rings; ++ring)
     {
-        glfwTerminate();
-        return -1;
+        float theta = glm::pi<float>() * ring / rings;
+        for (unsigned int segment = 0; segment <= segments; ++segment)
+        {
+            float phi = 2.0f * glm::pi<float>() * segment / segments;
+            glm::vec3 normal(std::sin(theta) * std::cos(phi), std::cos(theta), -std::sin(theta) * std::sin(phi));
+            glm::vec3 position = normal * radius;
+            const float vertex[] = { position.x, position.y, position.z, (float)segment / segments, 1.0f - (float)ring / rings,
+                normal.x, normal.y, normal.z };
+            vertices.insert(vertices.end(), vertex, vertex + 8);
+        }
     }
+    mesh.Vertices.resize(vertices.size() * sizeof(float));
+    std::memcpy(mesh.Vertices.data(), vertices.data(), mesh.Vertices.size());
 
-    /* Make the window's context current */
-    glfwMakeContextCurrent(window);
-
-    /* We need to create a valid OpenGL rendering context before call glewInit */
-    if (GLEW_OK != glewInit())     // we should define GLEW_STATIC if we use static library 
+    for (unsigned int ring = 0; ring < rings; ++ring)
     {
-        std::cout << "Error!" << std::endl;
+        for (unsigned int segment = 0; segment < segments; ++segment)
+        {
+            unsigned int a = ring * (segments + 1) + segment;
+            unsigned int b = a + segments + 1;
+            /* Counter-clockwise seen from outside, the pole triangles are degenerate */
+            if (ring != 0)
+                mesh.Indices.insert(mesh.Indices.end(), { a, b, a + 1 });
+            if (ring != rings - 1)
+                mesh.Indices.insert(mesh.Indices.end(), { a + 1, b, b + 1 });
+        }
     }
 
-    /* Print GL_VERSION just for check */
-    std::cout << glGetString(GL_VERSION) << std::endl;
+    mesh.Bounds = { glm::vec3(-radius), glm::vec3(radius) };
+    mesh.SubMeshes.push_back({ 0, (unsigned int)mesh.Indices.size(), 0, mesh.Bounds });
+}
 
-    /* If create debug context successfully, we can bind debug message callback */
-    GLint flags; 
-    glGetIntegerv(GL_CONTEXT_FLAGS, &flags);
-    if (flags & GL_CONTEXT_FLAG_DEBUG_BIT)
+/* Everything that owns GL objects lives in here, so it is all gone before glfwTerminate */
+static void RunScene(RenderContext& context, RenderThread& renderThread, const Options& options)
+{
+    /* Shaders and textures live behind handles, destruction waits for the GPU */
+    std::unique_ptr<ResourceRegistry> resources(new ResourceRegistry());
+
+    /* Textures and buffers are uploaded through a second, shared context */
+    std::unique_ptr<ResourceLoader> loader(new ResourceLoader(context));
+
+    /* Workers for culling, transforms and loading, the main thread is worker 0 */
+    JobSystem jobs;
+    /* Transient per-frame data, created after the job system so every worker gets an allocator */
+    FrameArena frameArena;
+
+    float positions[] = {
+        -2.0f, -0.5f, 0.0f, 0.0f,  // 0, left  down
+         0.5f, -0.5f, 1.0f, 0.0f,  // 1, right down
+         0.5f,  0.5f, 1.0f, 1.0f,  // 2, right top
+        -2.0f,  0.5f, 0.0f, 1.0f   // 3, left  top
+    };  // Vertex data
+
+    unsigned int indices[] = {
+        0, 1, 2,
+        2, 3, 0
+    };  // Index data
+
+    /* The quad hides whatever is behind it, the CPU depth buffer only needs its corners */
+    glm::vec3 occluderPositions[] = {
+        glm::vec3(-2.0f, -0.5f, 0.0f), glm::vec3(0.5f, -0.5f, 0.0f),
+        glm::vec3( 0.5f,  0.5f, 0.0f), glm::vec3(-2.0f,  0.5f, 0.0f)
+    };
+
+    /* A row of models goes off into the distance behind the quad */
+    const glm::vec3 cameraPosition(0.0f, 2.5f, 6.0f);
+    glm::mat4 proj = glm::perspective(glm::radians(60.0f), (float)options.Width / options.Height, 0.1f, 100.0f);
+    glm::mat4 view = glm::lookAt(cameraPosition, glm::vec3(0.0f, 0.0f, -8.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 viewProjection = proj * view;
+    glm::mat4 quadTransform = glm::scale(glm::mat4(1.0f), glm::vec3(2.0f));
+
+    /* CPU copy of the model, the GPU one lives in modelPool */
+    MeshData model;
+    MeshFile modelFile;
+    if (options.Mesh.empty())
     {
-        glEnable(GL_DEBUG_OUTPUT);
-        glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS); // makes sure errors are displayed synchronously
-        glDebugMessageCallback(debugMessageCallback, nullptr);
-        glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0, nullptr, GL_TRUE);
+        CreateSphere(model, 0.5f, 24, 48);
+        MeshImporter::Prepare(model);
     }
-
-    /* Create VertexBuffer and add texture coordinates */
+    else if (modelFile.Open(options.Mesh))
     {
-        float positions[] = {
-            -2.0f, -0.5f, 0.0f, 0.0f,  // 0, left  down
-             0.5f, -0.5f, 1.0f, 0.0f,  // 1, right down
-             0.5f,  0.5f, 1.0f, 1.0f,  // 2, right top
-            -2.0f,  0.5f, 0.0f, 1.0f   // 3, left  top
-        };  // Vertex data
-
-        unsigned int indices[] = {
-            0, 1, 2,
-            2, 3, 0
-        };  // Index data
+        modelFile.GetMetadata(model);
+    }
+    else
+    {
+        std::cout << "Warning: drawing the built-in sphere instead of '" << options.Mesh << "'" << std::endl;
+        CreateSphere(model, 0.5f, 24, 48);
+        MeshImporter::Prepare(model);
+    }
 
+    /* Vertex Arrays are shared by every mesh with the same layout */
+    VertexArrayCache vaoCache;
+    /* Vreate Vertex Buffer Layout */
+    VertexBufferLayout layout;
+    layout.Push<float>(2);
+    layout.Push<float>(2);
+    /* Meshes of this layout are sub-allocated from shared vertex and index buffers.
+     * GL objects are created and destroyed on the render thread */
+    MeshPool meshPool(vaoCache, layout);
+    MeshPool modelPool(vaoCache, model.Layout);
+    ResourceRef<Shader> shader;
+    MeshAllocation quad = {};
+    MeshAllocation modelMesh = {};
+    /* Models the CPU depth buffer lets through still get hardware queries on the render thread */
+    std::unique_ptr<OcclusionCuller> occlusionCuller;
+
+    /* The quad is drawn untextured until the upload has finished */
+    TextureHandle loadedTexture;
+    std::atomic<TextureHandle> texture{ TextureHandle() };
+    loader->Load([&]() { loadedTexture = resources->Create<Texture>("res/textures/AndroscogginRiver.png"); },
+        [&]() { texture.store(loadedTexture); });
+
+    renderThread.Execute([&]()
+    {
         GLCall(glEnable(GL_BLEND));
         GLCall(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
+        GLCall(glEnable(GL_DEPTH_TEST));
 
-        /* Create Vertex Array */
-        VertexArray va;
-        /* Create Vertex Buffer */
-        VertexBuffer vb(positions, 4 * 4 * sizeof(float));
-        /* Vreate Vertex Buffer Layout */
-        VertexBufferLayout layout;
-        layout.Push<float>(2);
-        layout.Push<float>(2);
-        va.AddBuffer(vb, layout);
+        /* Create VertexBuffer and add texture coordinates */
+        quad = meshPool.Allocate(positions, 4, indices, 6);
+        const VertexArray& va = meshPool.Bind(quad.Page);
+
+        /* A mapped .mesh is uploaded straight from the file */
+        if (modelFile.IsOpen())
+        {
+            modelMesh = modelPool.Allocate(modelFile.GetVertices(), modelFile.GetVertexCount(),
+                modelFile.GetIndices(), modelFile.GetIndexCount());
+        }
+        else
+        {
+            modelMesh = modelPool.Allocate(model.Vertices.data(), model.GetVertexCount(),
+                model.Indices.data(), (unsigned int)model.Indices.size());
+        }
 
         //glEnableVertexAttribArray(0);
         /* Parameters:
@@ -151,66 +336,238 @@ int main(void)
          */
         //glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(float) * 2, 0);
 
-        IndexBuffer ib(indices, 6);
-
-        glm::mat4 proj = glm::ortho(-2.0f, 2.0f, -1.5f, 1.5f, -1.0f, 1.0f);
-
         /* Now we get shader code from file */
-        Shader shader("res/shaders/Basic.shader");
-        shader.Bind();
-        shader.SetUniform4f("u_Color", 0.2f, 0.3f, 0.7f, 1.0f);
-        shader.SetUniformMat4f("u_MVP", proj);
+        shader = ResourceRef<Shader>(*resources, resources->Create<Shader>("res/shaders/Basic.shader"));
+        shader->Bind();
+        shader->SetUniform4f("u_Color", 0.2f, 0.3f, 0.7f, 1.0f);
+        shader->SetUniformMat4f("u_MVP", viewProjection * quadTransform);
+
+        shader->SetUniform1i("u_Texture", 0);    // We bind our texture to slot 0
 
-        Texture texture("res/textures/AndroscogginRiver.png");
-        texture.Bind();
-        shader.SetUniform1i("u_Texture", 0);    // We bind our texture to slot 0
+        occlusionCuller.reset(new OcclusionCuller());
 
         va.Unbind();
-        vb.Unbind();
-        ib.Unbind();
-        shader.Unbind();
+        shader->Unbind();
+    });
+
+    /* Renderable state lives in the entity world, the frame loop only sees the draw queue */
+    EntityWorld world;
+    Entity quadEntity = world.Create(
+        TransformComponent{ quadTransform },
+        MeshComponent{ &meshPool, quad, nullptr, 0 },
+        MaterialComponent{ shader.GetHandle(), TextureHandle(), glm::vec4(0.2f, 0.3f, 0.7f, 1.0f) },
+        BoundsComponent{ { glm::vec3(-2.0f, -0.5f, 0.0f), glm::vec3(0.5f, 0.5f, 0.0f) }, NoOcclusionObject },
+        OccluderComponent{ occluderPositions, 4, indices, 6 });
+
+    /* Scaled to a unit sized object, whatever the model's units are */
+    glm::vec3 modelSize = model.Bounds.Max - model.Bounds.Min;
+    float modelScale = 1.0f / std::max(std::max(modelSize.x, modelSize.y), std::max(modelSize.z, 1e-6f));
+    std::vector<Entity> models;
+    if (modelMesh.IsValid())
+    {
+        for (int row = 0; row < 8; ++row)
+        {
+            for (int column = -3; column <= 3; ++column)
+            {
+                glm::mat4 transform = glm::translate(glm::mat4(1.0f), glm::vec3(column * 1.5f, 0.0f, -1.0f - row * 3.0f));
+                transform = glm::scale(transform, glm::vec3(modelScale));
+                transform = glm::translate(transform, -model.Bounds.GetCenter());
+                models.push_back(world.Create(
+                    TransformComponent{ transform },
+                    MeshComponent{ &modelPool, modelMesh, &model, 0 },
+                    MaterialComponent{ shader.GetHandle(), TextureHandle(), glm::vec4(1.0f) },
+                    BoundsComponent{ model.Bounds, (unsigned int)models.size() }));
+            }
+        }
+    }
+    CommandRecorder recorder;
+    /* Models behind the quad are dropped before they are recorded */
+    DepthRasterizer occlusionBuffer;
+
+    /* Once caches and containers have grown, a frame should not touch the heap */
+    const unsigned int warmupFrames = 120;
+    unsigned int frame = 0;
+    bool allocationReported = false;
+    AllocationScope frameAllocations;
+
+    float r = 0.0f;
+    float increment = 0.05f;
+    /* Loop until the user closes the window or the frame limit is reached */
+    while (!context.ShouldClose() && (options.Frames == 0 || frame < options.Frames))
+    {
+        if (++frame > warmupFrames && frameAllocations.GetCount() && !allocationReported)
+        {
+            std::cout << "Warning: " << frameAllocations.GetCount() << " heap allocations in frame " << frame - 1 << std::endl;
+            allocationReported = true;
+        }
+        frameAllocations.Restart();
+
+        Profiler::BeginFrame();
+        FrameTimer::BeginFrame();
+        frameArena.BeginFrame();
 
-        Renderer renderer;
+        {
+            PROFILE_SCOPE("Update");
+            FrameTimerScope update(FramePhase::Update);
+            jobs.RunMainThreadJobs();
+
+            MaterialComponent* material = world.Get<MaterialComponent>(quadEntity);
+            material->Color = glm::vec4(r, 0.3f, 0.7f, 1.0f);
+            material->DiffuseTexture = texture.load();
+            for (Entity entity : models)
+                world.Get<MaterialComponent>(entity)->DiffuseTexture = texture.load();
+
+            /* Publish finished uploads and free released objects the GPU is done with */
+            renderThread.Submit([&]()
+            {
+                loader->Poll();
+                resources->Collect();
+            });
+
+            /* Occluders first, then workers cull against them and record draws into their own buffers */
+            RenderExtraction::RasterizeOccluders(world, viewProjection, occlusionBuffer);
+            recorder.Reset();
+            RenderExtraction::Record(world, *resources,
+                RenderView{ viewProjection, cameraPosition, (float)options.Height, &occlusionBuffer }, recorder);
+        }
 
-        float r = 0.0f;
-        float increment = 0.05f;
-        /* Loop until the user closes the window */
-        while (!glfwWindowShouldClose(window))
+        /* Record this frame while the render thread replays the last one */
         {
-            /* Render here */
-            renderer.Clear();
+            PROFILE_SCOPE("Submit");
+            FrameTimerScope submit(FramePhase::Submit);
+            CommandList& commands = renderThread.BeginFrame();
+            commands.Reset();
+            commands.Clear(glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+            commands.SetViewProjection(viewProjection);
+            commands.BeginOcclusion(occlusionCuller.get(), cameraPosition);
+            recorder.Merge(commands);
+            renderThread.EndFrame();
+        }
 
-            /* Parameters
-             * mode:  Specifies what kind of primitives to render
-             * first: Specifies the starting index in the enabled arrays
-             * count: Specifies the number of indices to be rendered
-             */
-             //glDrawArrays(GL_TRIANGLES, 0, 3);
+        if (r >= 1.0f)
+        {
+            increment = -0.05f;
+        }
+        else if (r <= 0.0f)
+        {
+            increment = 0.05f;
+        }
+        r += increment;
 
-            shader.Bind();
-            shader.SetUniform4f("u_Color", r, 0.3f, 0.7f, 1.0f);
+        context.PollEvents();
+    }
 
-            renderer.Draw(va, ib, shader);
+    /* An empty last frame, so no recorded draw outlives the objects below */
+    renderThread.BeginFrame().Reset();
+    renderThread.EndFrame();
 
-            if (r >= 1.0f)
-            {
-                increment = -0.05f;
-            }
-            else if (r <= 0.0f)
-            {
-                increment = 0.05f;
-            }
-            r += increment;
+    /* Nothing may be created in the registry while it goes away */
+    loader.reset();
 
-            /* Swap front and back buffers */
-            glfwSwapBuffers(window);
+    /* GL objects have to be deleted on the render thread while the context is alive,
+     * the pools and caches themselves are destroyed with this scope */
+    renderThread.Execute([&]()
+    {
+        resources->Release(texture.load());
+        shader.Reset();
+        resources.reset();
+        occlusionCuller.reset();
+        meshPool.Clear();
+        modelPool.Clear();
+        vaoCache.Clear();
+    });
+}
 
-            /* Poll for and process events */
-            glfwPollEvents();
-        }
+int main(int argc, char* argv[])
+{
+    Options options;
+    if (!ParseOptions(argc, argv, options))
+    {
+        std::cout << "Usage: LearningOpenGL [--headless] [--resolution 640x480] [--frames N] [--output frame.ppm] [--mesh model.mesh]" << std::endl;
+        std::cout << "                     [--stats-csv render_stats.csv] [--trace profile.json]" << std::endl;
+        std::cout << "                     [--frame-times frame_times.txt]" << std::endl;
+        std::cout << "       LearningOpenGL --convert model.obj|model.gltf|model.glb model.mesh" << std::endl;
+        std::cout << "--output needs --headless, headless runs stop after 300 frames unless --frames is given" << std::endl;
+        return -1;
     }
-    /* Deconstruction vb and ib before glfwTerminate otherwise it will cause error */
 
-    glfwTerminate();
+    /* Offline conversion, no context needed */
+    if (!options.ConvertInput.empty())
+        return MeshImporter::Convert(options.ConvertInput, options.ConvertOutput) ? 0 : -1;
+
+    /* Initialize the library, a headless context doesn't touch GLFW at all */
+    if (!options.Headless && !glfwInit())
+        return -1;
+
+    std::unique_ptr<RenderContext> context = options.Headless
+        ? RenderContext::CreateHeadless(options.Width, options.Height)
+        : RenderContext::CreateWindowed(options.Width, options.Height, "Hello World");
+    if (!context)
+    {
+        if (!options.Headless)
+            glfwTerminate();
+        return -1;
+    }
+
+    Profiler::SetThreadName("Main");
+
+    /* The context belongs to the render thread from now on, every GL call goes through it */
+    RenderThread renderThread(*context);
+    std::unique_ptr<GpuProfiler> gpuProfiler;
+
+    renderThread.Execute([&]()
+    {
+        /* Loads the GL functions, headless contexts also get their framebuffer */
+        if (!context->InitializeGL())
+        {
+            std::cout << "Error!" << std::endl;
+        }
+
+        /* Print GL_VERSION just for check */
+        std::cout << glGetString(GL_VERSION) << std::endl;
+
+        /* If create debug context successfully, we can bind debug message callback */
+        GLint flags; 
+        glGetIntegerv(GL_CONTEXT_FLAGS, &flags);
+        if (flags & GL_CONTEXT_FLAG_DEBUG_BIT)
+        {
+            glEnable(GL_DEBUG_OUTPUT);
+            glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS); // makes sure errors are displayed synchronously
+            glDebugMessageCallback(debugMessageCallback, nullptr);
+            glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0, nullptr, GL_TRUE);
+        }
+
+        gpuProfiler.reset(new GpuProfiler());
+    });
+
+    /* Renderer counters, a summary every 600 frames and every frame in the CSV if asked for */
+    RenderStats::SetLogInterval(600);
+    if (!options.StatsCsv.empty())
+        RenderStats::OpenCsv(options.StatsCsv);
+
+    RunScene(*context, renderThread, options);
+
+    renderThread.Execute([&]()
+    {
+        /* The empty last frame drew nothing, the framebuffer still holds the last real one */
+        if (!options.Output.empty())
+            context->SaveImage(options.Output);
+
+        gpuProfiler.reset();
+        context->ShutdownGL();
+    });
+    renderThread.Stop();
+    RenderStats::CloseCsv();
+
+    /* Open in chrome://tracing or ui.perfetto.dev */
+    if (!options.Trace.empty())
+        Profiler::ExportChromeTrace(options.Trace);
+    /* Percentiles and stutters, the average frame rate hides the hitches */
+    if (!options.FrameTimes.empty())
+        FrameTimer::Export(options.FrameTimes);
+
+    context.reset();
+    if (!options.Headless)
+        glfwTerminate();
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,125 @@
+#include "BuddyAllocator.h"
+
+#include "Renderer.h"
+
+const unsigned int BuddyAllocator::InvalidOffset;
+
+/* Per min-block state: 0 for blocks inside a larger block,
+ * otherwise a flag plus the order of the block starting here.
+ */
+static const unsigned char BlockFree = 0x40;
+static const unsigned char BlockAllocated = 0x80;
+static const unsigned char BlockOrderMask = 0x3f;
+
+static unsigned int Log2(unsigned int value)
+{
+    unsigned int result = 0;
+    while (value >>= 1)
+        ++result;
+    return result;
+}
+
+unsigned int BuddyAllocator::NextPowerOfTwo(unsigned int value)
+{
+    if (value > 0x80000000u)
+        return 0;
+
+    unsigned int result = 1;
+    while (result < value)
+        result <<= 1;
+    return result;
+}
+
+BuddyAllocator::BuddyAllocator(unsigned int capacity, unsigned int minBlockSize)
+    : m_Capacity(capacity), m_MinBlockShift(Log2(minBlockSize)), m_MaxOrder(0), m_Used(0)
+{
+    ASSERT(capacity == NextPowerOfTwo(capacity));
+    ASSERT(minBlockSize == NextPowerOfTwo(minBlockSize));
+    ASSERT(capacity >= minBlockSize);
+
+    unsigned int blockCount = capacity >> m_MinBlockShift;
+    m_MaxOrder = Log2(blockCount);
+
+    m_FreeHead.assign(m_MaxOrder + 1, InvalidOffset);
+    m_Next.assign(blockCount, InvalidOffset);
+    m_Prev.assign(blockCount, InvalidOffset);
+    m_State.assign(blockCount, 0);
+
+    PushFree(0, m_MaxOrder);
+}
+
+void BuddyAllocator::PushFree(unsigned int block, unsigned int order)
+{
+    m_State[block] = BlockFree | (unsigned char)order;
+    m_Prev[block] = InvalidOffset;
+    m_Next[block] = m_FreeHead[order];
+    if (m_FreeHead[order] != InvalidOffset)
+        m_Prev[m_FreeHead[order]] = block;
+    m_FreeHead[order] = block;
+}
+
+void BuddyAllocator::RemoveFree(unsigned int block, unsigned int order)
+{
+    if (m_Prev[block] != InvalidOffset)
+        m_Next[m_Prev[block]] = m_Next[block];
+    else
+        m_FreeHead[order] = m_Next[block];
+
+    if (m_Next[block] != InvalidOffset)
+        m_Prev[m_Next[block]] = m_Prev[block];
+
+    m_State[block] = 0;
+}
+
+unsigned int BuddyAllocator::Allocate(unsigned int size)
+{
+    if (size == 0 || size > m_Capacity)
+        return InvalidOffset;
+
+    unsigned int blocks = (size + (1u << m_MinBlockShift) - 1) >> m_MinBlockShift;
+    unsigned int order = Log2(NextPowerOfTwo(blocks));
+
+    unsigned int current = order;
+    while (current <= m_MaxOrder && m_FreeHead[current] == InvalidOffset)
+        ++current;
+    if (current > m_MaxOrder)
+        return InvalidOffset;
+
+    unsigned int block = m_FreeHead[current];
+    RemoveFree(block, current);
+
+    /* Split down to the requested order, the upper halves become free buddies */
+    while (current > order)
+    {
+        --current;
+        PushFree(block + (1u << current), current);
+    }
+
+    m_State[block] = BlockAllocated | (unsigned char)order;
+    m_Used += (1u << order) << m_MinBlockShift;
+    return block << m_MinBlockShift;
+}
+
+void BuddyAllocator::Free(unsigned int offset)
+{
+    unsigned int block = offset >> m_MinBlockShift;
+    ASSERT(block < m_State.size() && (m_State[block] & BlockAllocated));
+
+    unsigned int order = m_State[block] & BlockOrderMask;
+    m_Used -= (1u << order) << m_MinBlockShift;
+
+    /* Merge with the buddy for as long as it is free and of the same size */
+    while (order < m_MaxOrder)
+    {
+        unsigned int buddy = block ^ (1u << order);
+        if (m_State[buddy] != (BlockFree | order))
+            break;
+
+        RemoveFree(buddy, order);
+        m_State[block] = 0;
+        block = block < buddy ? block : buddy;
+        ++order;
+    }
+
+    PushFree(block, order);
+}
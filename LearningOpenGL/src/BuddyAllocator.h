@@ -0,0 +1,45 @@
+#pragma once
+#include <vector>
+
+/* Binary buddy allocator over an abstract range [0, capacity).
+ * It only hands out offsets, the memory itself lives somewhere else (usually a GL buffer).
+ * Capacity and minimum block size must be powers of two, both are in caller-defined units.
+ */
+class BuddyAllocator
+{
+public:
+	static const unsigned int InvalidOffset = 0xffffffff;
+
+private:
+	unsigned int m_Capacity;
+	unsigned int m_MinBlockShift;
+	unsigned int m_MaxOrder;
+	unsigned int m_Used;
+
+	// Head of the free list of every order, in min-block indices
+	std::vector<unsigned int> m_FreeHead;
+
+	// Free list links and block state, one entry per min-block
+	std::vector<unsigned int> m_Next;
+	std::vector<unsigned int> m_Prev;
+	std::vector<unsigned char> m_State;
+
+	void PushFree(unsigned int block, unsigned int order);
+
+	void RemoveFree(unsigned int block, unsigned int order);
+
+public:
+	BuddyAllocator(unsigned int capacity, unsigned int minBlockSize = 1);
+
+	// Returns the offset of a block of at least size units, or InvalidOffset when full
+	unsigned int Allocate(unsigned int size);
+
+	void Free(unsigned int offset);
+
+	inline unsigned int GetCapacity() const { return m_Capacity; }
+
+	inline unsigned int GetUsed() const { return m_Used; }
+
+	// 0 when the result would not fit 32 bits
+	static unsigned int NextPowerOfTwo(unsigned int value);
+};
@@ -0,0 +1,131 @@
+#include "CommandBuffer.h"
+#include "JobSystem.h"
+#include "ParallelFor.h"
+#include "FrameArena.h"
+#include "Profiler.h"
+
+#include <algorithm>
+#include <cstring>
+
+const unsigned int CommandRecorder::CopyBatchSize;
+
+void CommandBuffer::Sort()
+{
+    /* std::stable_sort would take a heap buffer every frame */
+    std::sort(m_Commands.begin(), m_Commands.end(), [](const SortedCommand& a, const SortedCommand& b)
+    {
+        return a.SortKey != b.SortKey ? a.SortKey < b.SortKey : a.Order < b.Order;
+    });
+}
+
+CommandRecorder::CommandRecorder()
+{
+    Reset();
+}
+
+void CommandRecorder::Reset()
+{
+    /* The job system can be created after the recorder */
+    const unsigned int workers = JobSystem::Get() ? JobSystem::Get()->GetWorkerCount() : 0;
+    while (m_Buffers.size() < workers)
+        m_Buffers.emplace_back(new CommandBuffer());
+
+    for (auto& buffer : m_Buffers)
+        buffer->Reset();
+
+    std::lock_guard<std::mutex> lock(m_ExtraMutex);
+    for (auto& buffer : m_ExtraBuffers)
+        buffer.second->Reset();
+}
+
+CommandBuffer& CommandRecorder::GetThreadBuffer()
+{
+    unsigned int index = JobSystem::GetWorkerIndex();
+    if (index < m_Buffers.size())
+        return *m_Buffers[index];
+
+    std::lock_guard<std::mutex> lock(m_ExtraMutex);
+    auto& buffer = m_ExtraBuffers[std::this_thread::get_id()];
+    if (!buffer)
+        buffer.reset(new CommandBuffer());
+    return *buffer;
+}
+
+unsigned int CommandRecorder::Merge(CommandList& list)
+{
+    PROFILE_SCOPE("Merge");
+    m_Active.clear();
+    for (const auto& buffer : m_Buffers)
+    {
+        if (buffer->GetCount())
+            m_Active.push_back(buffer.get());
+    }
+    for (const auto& buffer : m_ExtraBuffers)
+    {
+        if (buffer.second->GetCount())
+            m_Active.push_back(buffer.second.get());
+    }
+
+    unsigned int count = 0;
+    for (const CommandBuffer* buffer : m_Active)
+        count += buffer->GetCount();
+    if (count == 0)
+        return 0;
+
+    /* Every thread's run is sorted on its own, then the runs are merged */
+    ParallelFor((unsigned int)m_Active.size(), 1, [this](unsigned int begin, unsigned int end)
+    {
+        for (unsigned int i = begin; i < end; ++i)
+            m_Active[i]->Sort();
+    });
+
+    struct Cursor
+    {
+        const SortedCommand* Current;
+        const SortedCommand* End;
+        unsigned int Buffer;
+    };
+    /* Min-heap on (key, order), which buffer a draw landed in depends on work stealing */
+    auto greater = [](const Cursor& a, const Cursor& b)
+    {
+        if (a.Current->SortKey != b.Current->SortKey)
+            return a.Current->SortKey > b.Current->SortKey;
+        if (a.Current->Order != b.Current->Order)
+            return a.Current->Order > b.Current->Order;
+        return a.Buffer > b.Buffer;
+    };
+
+    FrameVector<Cursor> heap;
+    heap.reserve(m_Active.size());
+    for (unsigned int i = 0; i < m_Active.size(); ++i)
+    {
+        const auto& commands = m_Active[i]->GetCommands();
+        heap.push_back({ commands.data(), commands.data() + commands.size(), i });
+    }
+    std::make_heap(heap.begin(), heap.end(), greater);
+
+    m_Merged.resize(count);
+    unsigned int merged = 0;
+    while (heap.size() > 1)
+    {
+        std::pop_heap(heap.begin(), heap.end(), greater);
+        Cursor& cursor = heap.back();
+        m_Merged[merged++] = cursor.Current->Item;
+        if (++cursor.Current == cursor.End)
+            heap.pop_back();
+        else
+            std::push_heap(heap.begin(), heap.end(), greater);
+    }
+    for (const SortedCommand* command = heap[0].Current; command != heap[0].End; ++command)
+        m_Merged[merged++] = command->Item;
+
+    /* The copy into the list is the bulk of the work, split it across the workers */
+    unsigned char* records = list.Append<DrawCommand>(count);
+    const size_t stride = CommandList::GetRecordSize<DrawCommand>();
+    ParallelFor(count, CopyBatchSize, [this, records, stride](unsigned int begin, unsigned int end)
+    {
+        for (unsigned int i = begin; i < end; ++i)
+            memcpy(records + i * stride + sizeof(CommandHeader), m_Merged[i], sizeof(DrawItem));
+    });
+    return count;
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "CommandList.h"
+#include "LinearAllocator.h"
+
+struct SortedCommand
+{
+	unsigned long long SortKey;
+	unsigned long long Order;     // breaks SortKey ties
+	const DrawItem* Item;
+};
+
+/* Draws recorded by one thread in a frame. Items live in the buffer's arena, only
+ * key/order/pointer triples get sorted. */
+class CommandBuffer
+{
+private:
+	LinearAllocator m_Allocator;
+	std::vector<SortedCommand> m_Commands;
+
+	// Keeps the fields above off the cache line of the next thread's buffer
+	unsigned char m_Padding[64];
+
+public:
+	inline void Reset() { m_Allocator.Reset(); m_Commands.clear(); }
+
+	/* Draws with equal keys replay by order, which should not depend on the thread
+	 * that recorded them (e.g. chunk and entity index) */
+	inline void Draw(const DrawItem& item, unsigned long long order) { m_Commands.push_back({ item.SortKey, order, m_Allocator.New(item) }); }
+
+	void Sort();
+
+	inline const std::vector<SortedCommand>& GetCommands() const { return m_Commands; }
+
+	inline unsigned int GetCount() const { return (unsigned int)m_Commands.size(); }
+};
+
+/* One CommandBuffer per job system worker so jobs record draws without any locking,
+ * merged into a single sorted CommandList before the render thread replays it.
+ *
+ *   recorder.Reset();
+ *   ParallelFor(count, batch, [&](unsigned int begin, unsigned int end)
+ *   {
+ *       CommandBuffer& buffer = recorder.GetThreadBuffer();   // once per batch
+ *       ...buffer.Draw(item, order)...
+ *   });
+ *   recorder.Merge(commands);
+ */
+class CommandRecorder
+{
+public:
+	static const unsigned int CopyBatchSize = 4096;
+
+private:
+	std::vector<std::unique_ptr<CommandBuffer>> m_Buffers;
+
+	// Threads outside the job system, e.g. ParallelFor helpers when there is none
+	std::mutex m_ExtraMutex;
+	std::unordered_map<std::thread::id, std::unique_ptr<CommandBuffer>> m_ExtraBuffers;
+
+	std::vector<CommandBuffer*> m_Active;
+	std::vector<const DrawItem*> m_Merged;
+
+public:
+	CommandRecorder();
+
+	CommandRecorder(const CommandRecorder&) = delete;
+	CommandRecorder& operator=(const CommandRecorder&) = delete;
+
+	/* Rewinds every buffer, draws recorded last frame become invalid */
+	void Reset();
+
+	CommandBuffer& GetThreadBuffer();
+
+	/* Appends every recorded draw to list sorted by SortKey then order, returns the number of draws */
+	unsigned int Merge(CommandList& list);
+};
@@ -0,0 +1,15 @@
+#include "CommandList.h"
+
+const unsigned int CommandList::Alignment;
+const CommandType ClearCommand::Type;
+const CommandType SetViewProjectionCommand::Type;
+const CommandType BeginOcclusionCommand::Type;
+const CommandType DrawCommand::Type;
+
+void CommandList::Draw(const DrawQueue& queue)
+{
+    /* One resize for the whole queue instead of one per item */
+    m_Data.reserve(m_Data.size() + queue.GetCount() * (sizeof(CommandHeader) + sizeof(DrawCommand) + Alignment));
+    for (const auto& item : queue.GetItems())
+        Draw(item);
+}
@@ -0,0 +1,129 @@
+#pragma once
+#include <cstring>
+#include <vector>
+
+#include "DrawQueue.h"
+
+class OcclusionCuller;
+
+enum class CommandType : unsigned int
+{
+	Clear, SetViewProjection, BeginOcclusion, Draw
+};
+
+/* Every command starts with a header, Size covers header and payload */
+struct CommandHeader
+{
+	CommandType Type;
+	unsigned int Size;
+	unsigned int Padding[2];
+};
+
+struct ClearCommand
+{
+	static const CommandType Type = CommandType::Clear;
+
+	glm::vec4 Color;
+};
+
+struct SetViewProjectionCommand
+{
+	static const CommandType Type = CommandType::SetViewProjection;
+
+	glm::mat4 ViewProjection;
+};
+
+/* Draws after this one with an OcclusionObject go through Culler: hidden ones are only
+ * drawn once their boxes were queried at the end of the list, under conditional
+ * rendering. Record it after SetViewProjection, at most once per list. */
+struct BeginOcclusionCommand
+{
+	static const CommandType Type = CommandType::BeginOcclusion;
+
+	OcclusionCuller* Culler;
+	glm::vec3 CameraPosition;
+};
+
+struct DrawCommand
+{
+	static const CommandType Type = CommandType::Draw;
+
+	DrawItem Item;
+};
+
+/* A frame worth of render commands in one contiguous byte stream. Commands only
+ * reference engine objects, no GL names or enums, so the list can be recorded on
+ * any thread and replayed by whatever backend owns the context (Renderer::Execute).
+ */
+class CommandList
+{
+public:
+	static const unsigned int Alignment = 16;
+
+private:
+	std::vector<unsigned char> m_Data;
+	unsigned int m_Count;
+
+public:
+	CommandList() : m_Count(0) {}
+
+	inline void Reset() { m_Data.clear(); m_Count = 0; }
+
+	template<typename T>
+	static inline unsigned int GetRecordSize()
+	{
+		static_assert(sizeof(CommandHeader) % Alignment == 0, "CommandHeader breaks command alignment");
+		return (unsigned int)((sizeof(CommandHeader) + sizeof(T) + Alignment - 1) & ~(Alignment - 1));
+	}
+
+	template<typename T>
+	void Push(const T& command)
+	{
+		unsigned char* record = Append<T>(1);
+		std::memcpy(record + sizeof(CommandHeader), &command, sizeof(T));
+	}
+
+	/* Adds count commands of type T with their headers written and returns the first
+	 * record. Payload i goes to result + i * GetRecordSize<T>() + sizeof(CommandHeader),
+	 * so several threads can fill one range. Invalidated by the next Push or Append. */
+	template<typename T>
+	unsigned char* Append(unsigned int count)
+	{
+		const unsigned int size = GetRecordSize<T>();
+		const size_t offset = m_Data.size();
+		m_Data.resize(offset + (size_t)size * count);
+
+		CommandHeader header = { T::Type, size, { 0, 0 } };
+		for (unsigned int i = 0; i < count; ++i)
+			std::memcpy(&m_Data[offset + (size_t)i * size], &header, sizeof(header));
+		m_Count += count;
+		return count ? &m_Data[offset] : nullptr;
+	}
+
+	inline void Clear(const glm::vec4& color) { Push(ClearCommand{ color }); }
+
+	inline void SetViewProjection(const glm::mat4& viewProjection) { Push(SetViewProjectionCommand{ viewProjection }); }
+
+	inline void BeginOcclusion(OcclusionCuller* culler, const glm::vec3& cameraPosition) { Push(BeginOcclusionCommand{ culler, cameraPosition }); }
+
+	inline void Draw(const DrawItem& item) { Push(DrawCommand{ item }); }
+
+	void Draw(const DrawQueue& queue);
+
+	/* Calls function(header, payload) for every command in recording order */
+	template<typename Function>
+	void ForEach(Function function) const
+	{
+		size_t offset = 0;
+		while (offset < m_Data.size())
+		{
+			const CommandHeader& header = *(const CommandHeader*)&m_Data[offset];
+			function(header, &m_Data[offset + sizeof(CommandHeader)]);
+			offset += header.Size;
+		}
+	}
+
+	inline unsigned int GetCount() const { return m_Count; }
+
+	inline unsigned int GetSize() const { return (unsigned int)m_Data.size(); }
+};
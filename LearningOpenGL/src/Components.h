@@ -0,0 +1,57 @@
+#pragma once
+
+#include "MeshData.h"
+#include "MeshPool.h"
+#include "ResourcePool.h"
+
+class Shader;
+class Texture;
+
+/* Components of renderable entities, see EntityWorld and RenderExtraction */
+
+struct TransformComponent
+{
+	glm::mat4 World;
+};
+
+// Entity follows a node of a TransformHierarchy
+struct TransformNodeComponent
+{
+	unsigned int Node;
+};
+
+/* Data holds the CPU side LODs and meshlets of the mesh and may be nullptr, the whole
+ * allocation is drawn then. Lod is the level drawn last frame, kept by RenderExtraction */
+struct MeshComponent
+{
+	const MeshPool* Pool;
+	MeshAllocation Mesh;
+	const MeshData* Data;
+	unsigned int Lod;
+};
+
+// Handles into the ResourceRegistry, a stale texture handle draws untextured
+struct MaterialComponent
+{
+	Handle<Shader> Program;
+	Handle<Texture> DiffuseTexture;
+	glm::vec4 Color;
+};
+
+/* Object space bounds of the mesh. OcclusionObject picks the hardware occlusion query
+ * object the world box is tested with, NoOcclusionObject for none */
+struct BoundsComponent
+{
+	BoundingBox Local;
+	unsigned int OcclusionObject;
+};
+
+/* Marks an entity as an occluder for the CPU depth buffer. The triangles are in object
+ * space, usually a few of them standing in for the real mesh, and have to stay inside it */
+struct OccluderComponent
+{
+	const glm::vec3* Positions;
+	unsigned int VertexCount;
+	const unsigned int* Indices;
+	unsigned int IndexCount;
+};
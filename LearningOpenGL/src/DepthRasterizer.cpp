@@ -0,0 +1,258 @@
+#include "DepthRasterizer.h"
+#include "ParallelFor.h"
+#include "Renderer.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define RASTER_SSE 1
+#include <emmintrin.h>
+#endif
+
+const unsigned int DepthRasterizer::TileSize;
+const unsigned int DepthRasterizer::BlockSize;
+
+static const float MinW = 1e-4f;
+
+DepthRasterizer::DepthRasterizer(unsigned int width, unsigned int height)
+    : m_Width(width), m_Height(height), m_ViewProjection(1.0f)
+{
+    ASSERT(width % BlockSize == 0 && height % BlockSize == 0);
+
+    m_TilesX = (width + TileSize - 1) / TileSize;
+    m_TilesY = (height + TileSize - 1) / TileSize;
+    m_Depth.assign(width * height, 1.0f);
+    m_BlockMax.assign((width / BlockSize) * (height / BlockSize), 1.0f);
+    m_Bins.resize(m_TilesX * m_TilesY);
+}
+
+void DepthRasterizer::Begin(const glm::mat4& viewProjection)
+{
+    m_ViewProjection = viewProjection;
+    m_Triangles.clear();
+    for (auto& bin : m_Bins)
+        bin.clear();
+}
+
+void DepthRasterizer::AddOccluder(const MeshData& mesh, const glm::mat4& model)
+{
+    glm::mat4 mvp = m_ViewProjection * model;
+    m_Clip.resize(mesh.GetVertexCount());
+    for (unsigned int v = 0; v < m_Clip.size(); ++v)
+        m_Clip[v] = mvp * glm::vec4(mesh.GetPosition(v), 1.0f);
+
+    for (unsigned int i = 0; i + 2 < mesh.Indices.size(); i += 3)
+        AddTriangle(m_Clip[mesh.Indices[i]], m_Clip[mesh.Indices[i + 1]], m_Clip[mesh.Indices[i + 2]]);
+}
+
+void DepthRasterizer::AddOccluder(const glm::vec3* positions, unsigned int vertexCount,
+    const unsigned int* indices, unsigned int indexCount, const glm::mat4& model)
+{
+    glm::mat4 mvp = m_ViewProjection * model;
+    m_Clip.resize(vertexCount);
+    for (unsigned int v = 0; v < vertexCount; ++v)
+        m_Clip[v] = mvp * glm::vec4(positions[v], 1.0f);
+
+    for (unsigned int i = 0; i + 2 < indexCount; i += 3)
+        AddTriangle(m_Clip[indices[i]], m_Clip[indices[i + 1]], m_Clip[indices[i + 2]]);
+}
+
+/* Sets up edge functions and the depth plane in pixel space, then bins by tile */
+void DepthRasterizer::AddTriangle(const glm::vec4& c0, const glm::vec4& c1, const glm::vec4& c2)
+{
+    /* Not clipped: anything in front of the near plane (z < -w) would project with a
+     * depth below 0 and hide everything behind it, so the whole triangle is skipped */
+    if (c0.w < MinW || c1.w < MinW || c2.w < MinW)
+        return;
+    if (c0.z < -c0.w || c1.z < -c1.w || c2.z < -c2.w)
+        return;
+
+    glm::vec3 v[3];
+    const glm::vec4* clip[3] = { &c0, &c1, &c2 };
+    for (int i = 0; i < 3; ++i)
+    {
+        glm::vec3 ndc = glm::vec3(*clip[i]) / clip[i]->w;
+        v[i] = glm::vec3((ndc.x * 0.5f + 0.5f) * m_Width, (ndc.y * 0.5f + 0.5f) * m_Height, ndc.z * 0.5f + 0.5f);
+    }
+
+    float area = (v[1].x - v[0].x) * (v[2].y - v[0].y) - (v[2].x - v[0].x) * (v[1].y - v[0].y);
+    if (std::abs(area) < 1e-6f)
+        return;
+    if (area < 0.0f)
+    {
+        std::swap(v[1], v[2]);
+        area = -area;
+    }
+
+    /* Pixel centers are sampled, so a triangle covers [ceil(min - 0.5), floor(max - 0.5)] */
+    float minX = std::min(v[0].x, std::min(v[1].x, v[2].x)), maxX = std::max(v[0].x, std::max(v[1].x, v[2].x));
+    float minY = std::min(v[0].y, std::min(v[1].y, v[2].y)), maxY = std::max(v[0].y, std::max(v[1].y, v[2].y));
+    Triangle triangle;
+    triangle.MinX = std::max((int)std::ceil(minX - 0.5f), 0);
+    triangle.MinY = std::max((int)std::ceil(minY - 0.5f), 0);
+    triangle.MaxX = std::min((int)std::floor(maxX - 0.5f), (int)m_Width - 1);
+    triangle.MaxY = std::min((int)std::floor(maxY - 0.5f), (int)m_Height - 1);
+    if (triangle.MinX > triangle.MaxX || triangle.MinY > triangle.MaxY)
+        return;
+    if (std::min(v[0].z, std::min(v[1].z, v[2].z)) > 1.0f)
+        return;
+
+    /* Edge i is opposite of vertex i, positive inside */
+    float weights[3][3];
+    for (int i = 0; i < 3; ++i)
+    {
+        const glm::vec3& a = v[(i + 1) % 3];
+        const glm::vec3& b = v[(i + 2) % 3];
+        triangle.EdgeA[i] = a.y - b.y;
+        triangle.EdgeB[i] = b.x - a.x;
+        triangle.EdgeC[i] = a.x * b.y - b.x * a.y;
+        weights[i][0] = triangle.EdgeA[i] / area;
+        weights[i][1] = triangle.EdgeB[i] / area;
+        weights[i][2] = triangle.EdgeC[i] / area;
+    }
+    triangle.DepthA = weights[0][0] * v[0].z + weights[1][0] * v[1].z + weights[2][0] * v[2].z;
+    triangle.DepthB = weights[0][1] * v[0].z + weights[1][1] * v[1].z + weights[2][1] * v[2].z;
+    triangle.DepthC = weights[0][2] * v[0].z + weights[1][2] * v[1].z + weights[2][2] * v[2].z;
+
+    unsigned int index = (unsigned int)m_Triangles.size();
+    m_Triangles.push_back(triangle);
+    for (int ty = triangle.MinY / (int)TileSize; ty <= triangle.MaxY / (int)TileSize; ++ty)
+    {
+        for (int tx = triangle.MinX / (int)TileSize; tx <= triangle.MaxX / (int)TileSize; ++tx)
+            m_Bins[ty * m_TilesX + tx].push_back(index);
+    }
+}
+
+void DepthRasterizer::Rasterize()
+{
+    ParallelFor(m_TilesX * m_TilesY, 1, [this](unsigned int begin, unsigned int end)
+    {
+        for (unsigned int tile = begin; tile < end; ++tile)
+            RasterizeTile(tile);
+    });
+}
+
+void DepthRasterizer::RasterizeTile(unsigned int tile)
+{
+    const int tileX = (int)((tile % m_TilesX) * TileSize), tileY = (int)((tile / m_TilesX) * TileSize);
+    const int tileMaxX = std::min(tileX + (int)TileSize, (int)m_Width) - 1;
+    const int tileMaxY = std::min(tileY + (int)TileSize, (int)m_Height) - 1;
+
+    for (int y = tileY; y <= tileMaxY; ++y)
+        std::fill(&m_Depth[y * m_Width + tileX], &m_Depth[y * m_Width + tileMaxX] + 1, 1.0f);
+
+    for (unsigned int index : m_Bins[tile])
+    {
+        const Triangle& t = m_Triangles[index];
+        const int minX = std::max(t.MinX, tileX) & ~3, maxX = std::min(t.MaxX, tileMaxX);
+        const int minY = std::max(t.MinY, tileY), maxY = std::min(t.MaxY, tileMaxY);
+
+        for (int y = minY; y <= maxY; ++y)
+        {
+            float py = y + 0.5f;
+            float* row = &m_Depth[y * m_Width];
+#ifdef RASTER_SSE
+            /* Four pixels at a time, rows are a multiple of four wide */
+            const __m128 offsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+            __m128 rowEdge[3], stepEdge[3];
+            for (int i = 0; i < 3; ++i)
+            {
+                rowEdge[i] = _mm_set1_ps(t.EdgeB[i] * py + t.EdgeC[i]);
+                stepEdge[i] = _mm_set1_ps(t.EdgeA[i]);
+            }
+            const __m128 rowDepth = _mm_set1_ps(t.DepthB * py + t.DepthC), stepDepth = _mm_set1_ps(t.DepthA);
+            for (int x = minX; x <= maxX; x += 4)
+            {
+                __m128 px = _mm_add_ps(_mm_set1_ps((float)x), offsets);
+                __m128 inside = _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(stepEdge[0], px), rowEdge[0]), _mm_setzero_ps());
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(stepEdge[1], px), rowEdge[1]), _mm_setzero_ps()));
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(stepEdge[2], px), rowEdge[2]), _mm_setzero_ps()));
+
+                __m128 depth = _mm_max_ps(_mm_add_ps(_mm_mul_ps(stepDepth, px), rowDepth), _mm_setzero_ps());
+                __m128 stored = _mm_loadu_ps(row + x);
+                __m128 nearer = _mm_min_ps(stored, depth);
+                _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearer), _mm_andnot_ps(inside, stored)));
+            }
+#else
+            for (int x = minX; x <= maxX; ++x)
+            {
+                float px = x + 0.5f;
+                bool inside = true;
+                for (int i = 0; i < 3; ++i)
+                    inside &= t.EdgeA[i] * px + t.EdgeB[i] * py + t.EdgeC[i] >= 0.0f;
+                if (inside)
+                    row[x] = std::min(row[x], std::max(t.DepthA * px + t.DepthB * py + t.DepthC, 0.0f));
+            }
+#endif
+        }
+    }
+
+    /* Coarse level: farthest depth of every block of this tile */
+    const unsigned int blocksX = m_Width / BlockSize;
+    for (int by = tileY; by <= tileMaxY; by += BlockSize)
+    {
+        for (int bx = tileX; bx <= tileMaxX; bx += BlockSize)
+        {
+            float farthest = 0.0f;
+            for (int y = by; y < by + (int)BlockSize; ++y)
+            {
+                for (int x = bx; x < bx + (int)BlockSize; ++x)
+                    farthest = std::max(farthest, m_Depth[y * m_Width + x]);
+            }
+            m_BlockMax[(by / BlockSize) * blocksX + bx / BlockSize] = farthest;
+        }
+    }
+}
+
+bool DepthRasterizer::IsVisible(const BoundingBox& worldBounds) const
+{
+    glm::vec3 minScreen(FLT_MAX), maxScreen(-FLT_MAX);
+    for (int i = 0; i < 8; ++i)
+    {
+        glm::vec3 corner((i & 1) ? worldBounds.Max.x : worldBounds.Min.x,
+            (i & 2) ? worldBounds.Max.y : worldBounds.Min.y,
+            (i & 4) ? worldBounds.Max.z : worldBounds.Min.z);
+        glm::vec4 clip = m_ViewProjection * glm::vec4(corner, 1.0f);
+        if (clip.w < MinW)
+            return true;
+
+        glm::vec3 ndc = glm::vec3(clip) / clip.w;
+        glm::vec3 screen((ndc.x * 0.5f + 0.5f) * m_Width, (ndc.y * 0.5f + 0.5f) * m_Height, ndc.z * 0.5f + 0.5f);
+        minScreen = glm::min(minScreen, screen);
+        maxScreen = glm::max(maxScreen, screen);
+    }
+
+    /* The box covers at least the pixels whose centers fall inside its rectangle, take
+     * every pixel it touches to stay conservative */
+    int minX = std::max((int)std::floor(minScreen.x), 0), maxX = std::min((int)std::ceil(maxScreen.x) - 1, (int)m_Width - 1);
+    int minY = std::max((int)std::floor(minScreen.y), 0), maxY = std::min((int)std::ceil(maxScreen.y) - 1, (int)m_Height - 1);
+    if (minX > maxX || minY > maxY)
+        return false;
+    const float nearest = minScreen.z;
+    if (nearest <= 0.0f)
+        return true;
+
+    const unsigned int blocksX = m_Width / BlockSize;
+    for (int by = minY / (int)BlockSize; by <= maxY / (int)BlockSize; ++by)
+    {
+        for (int bx = minX / (int)BlockSize; bx <= maxX / (int)BlockSize; ++bx)
+        {
+            if (m_BlockMax[by * blocksX + bx] < nearest)
+                continue;
+
+            int x0 = std::max(minX, bx * (int)BlockSize), x1 = std::min(maxX, bx * (int)BlockSize + (int)BlockSize - 1);
+            int y0 = std::max(minY, by * (int)BlockSize), y1 = std::min(maxY, by * (int)BlockSize + (int)BlockSize - 1);
+            for (int y = y0; y <= y1; ++y)
+            {
+                for (int x = x0; x <= x1; ++x)
+                {
+                    if (m_Depth[y * m_Width + x] >= nearest)
+                        return true;
+                }
+            }
+        }
+    }
+    return false;
+}
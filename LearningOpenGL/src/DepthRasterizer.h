@@ -0,0 +1,77 @@
+#pragma once
+#include <vector>
+
+#include "MeshData.h"
+
+/* Software occlusion culling. Occluder meshes are rasterized on the CPU into a
+ * small depth buffer, split into tiles that are filled in parallel with SSE, and
+ * the maximum depth of every 8x8 block is kept as a coarse level. Object boxes are
+ * then tested against it in the same frame, no GPU round trip involved:
+ *
+ *   rasterizer.Begin(viewProjection);
+ *   rasterizer.AddOccluder(mesh, model) for a few large, simple meshes
+ *   rasterizer.Rasterize();
+ *   if (rasterizer.IsVisible(worldBounds)) draw
+ *
+ * Depth is NDC depth mapped to [0, 1], cleared to 1. Occluder triangles with any
+ * vertex in front of the near plane (z < -w in clip space) are dropped instead of
+ * clipped, which only ever makes culling less aggressive.
+ */
+class DepthRasterizer
+{
+public:
+	static const unsigned int TileSize = 32;
+	static const unsigned int BlockSize = 8;
+
+private:
+	struct Triangle
+	{
+		float EdgeA[3], EdgeB[3], EdgeC[3];
+		float DepthA, DepthB, DepthC;
+		int MinX, MinY, MaxX, MaxY;
+	};
+
+	unsigned int m_Width;
+	unsigned int m_Height;
+	unsigned int m_TilesX;
+	unsigned int m_TilesY;
+
+	glm::mat4 m_ViewProjection;
+
+	std::vector<float> m_Depth;
+	std::vector<float> m_BlockMax;
+
+	std::vector<Triangle> m_Triangles;
+	std::vector<std::vector<unsigned int>> m_Bins;
+	std::vector<glm::vec4> m_Clip;
+
+	void AddTriangle(const glm::vec4& v0, const glm::vec4& v1, const glm::vec4& v2);
+
+	void RasterizeTile(unsigned int tile);
+
+public:
+	/* Width and height must be multiples of BlockSize */
+	DepthRasterizer(unsigned int width = 256, unsigned int height = 128);
+
+	/* Clears depth and occluders */
+	void Begin(const glm::mat4& viewProjection);
+
+	void AddOccluder(const MeshData& mesh, const glm::mat4& model);
+
+	void AddOccluder(const glm::vec3* positions, unsigned int vertexCount,
+		const unsigned int* indices, unsigned int indexCount, const glm::mat4& model);
+
+	/* Fills the depth buffer from the occluders added since Begin, tiles run on worker threads */
+	void Rasterize();
+
+	/* Conservative, boxes touching the near plane are always visible */
+	bool IsVisible(const BoundingBox& worldBounds) const;
+
+	inline unsigned int GetWidth() const { return m_Width; }
+
+	inline unsigned int GetHeight() const { return m_Height; }
+
+	inline const float* GetDepth() const { return m_Depth.data(); }
+
+	inline unsigned int GetOccluderTriangleCount() const { return (unsigned int)m_Triangles.size(); }
+};
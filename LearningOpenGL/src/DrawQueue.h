@@ -0,0 +1,54 @@
+#pragma once
+#include <algorithm>
+#include <vector>
+
+#include "MeshData.h"
+#include "MeshPool.h"
+
+class Shader;
+class Texture;
+
+// Draws that skip hardware occlusion queries
+static const unsigned int NoOcclusionObject = 0xffffffff;
+
+struct DrawItem
+{
+	unsigned long long SortKey;
+	const MeshPool* Pool;
+	MeshAllocation Mesh;
+	Shader* Program;
+	const Texture* DiffuseTexture;
+	glm::vec4 Color;
+	glm::mat4 Model;
+	// OcclusionCuller object and the world box it queries, see BeginOcclusionCommand
+	unsigned int OcclusionObject;
+	BoundingBox Bounds;
+};
+
+/* Draws collected for one frame, sorted so state changes are grouped:
+ * shader, then texture, then pool page */
+class DrawQueue
+{
+private:
+	std::vector<DrawItem> m_Items;
+
+public:
+	inline void Clear() { m_Items.clear(); }
+
+	inline void Push(const DrawItem& item) { m_Items.push_back(item); }
+
+	inline void Sort()
+	{
+		std::sort(m_Items.begin(), m_Items.end(),
+			[](const DrawItem& a, const DrawItem& b) { return a.SortKey < b.SortKey; });
+	}
+
+	inline const std::vector<DrawItem>& GetItems() const { return m_Items; }
+
+	inline unsigned int GetCount() const { return (unsigned int)m_Items.size(); }
+
+	static inline unsigned long long MakeSortKey(unsigned int shaderID, unsigned int textureID, unsigned int page)
+	{
+		return ((unsigned long long)(shaderID & 0xffff) << 48) | ((unsigned long long)(textureID & 0xffffff) << 24) | (page & 0xffffff);
+	}
+};
@@ -0,0 +1,204 @@
+#include "EntityWorld.h"
+#include "Renderer.h"
+
+#include <cstdlib>
+#include <cstring>
+
+const unsigned int Archetype::ChunkSize;
+const unsigned int Archetype::InvalidOffset;
+
+static std::vector<ComponentInfo>& GetComponentInfos()
+{
+    static std::vector<ComponentInfo> infos;
+    return infos;
+}
+
+unsigned int ComponentRegistry::Register(unsigned int size, unsigned int alignment)
+{
+    auto& infos = GetComponentInfos();
+    ASSERT(infos.size() < MaxComponentTypes);
+    infos.push_back({ size, alignment });
+    return (unsigned int)infos.size() - 1;
+}
+
+const ComponentInfo& ComponentRegistry::Get(unsigned int type)
+{
+    return GetComponentInfos()[type];
+}
+
+static unsigned int AlignUp(unsigned int offset, unsigned int alignment)
+{
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+Archetype::Archetype(ComponentMask mask)
+    : m_Mask(mask), m_Capacity(0), m_Count(0)
+{
+    unsigned int rowSize = sizeof(Entity);
+    for (unsigned int type = 0; type < MaxComponentTypes; ++type)
+    {
+        m_Offsets[type] = InvalidOffset;
+        if (mask & (1ull << type))
+        {
+            m_Types.push_back(type);
+            rowSize += ComponentRegistry::Get(type).Size;
+        }
+    }
+
+    /* As many rows as fit once every array is aligned */
+    for (m_Capacity = ChunkSize / rowSize; m_Capacity > 0; --m_Capacity)
+    {
+        unsigned int offset = sizeof(Entity) * m_Capacity;
+        for (unsigned int type : m_Types)
+        {
+            const ComponentInfo& info = ComponentRegistry::Get(type);
+            offset = AlignUp(offset, info.Alignment);
+            m_Offsets[type] = offset;
+            offset += info.Size * m_Capacity;
+        }
+        if (offset <= ChunkSize)
+            break;
+    }
+    ASSERT(m_Capacity > 0);
+}
+
+Archetype::~Archetype()
+{
+    for (auto& chunk : m_Chunks)
+        free(chunk.Data);
+}
+
+void Archetype::Push(const Entity& entity, unsigned int& chunk, unsigned int& row)
+{
+    if (m_Chunks.empty() || m_Chunks.back().Count == m_Capacity)
+        m_Chunks.push_back({ (unsigned char*)malloc(ChunkSize), 0 });
+
+    chunk = (unsigned int)m_Chunks.size() - 1;
+    row = m_Chunks.back().Count++;
+    ++m_Count;
+
+    GetEntities(chunk)[row] = entity;
+    for (unsigned int type : m_Types)
+    {
+        unsigned int size = ComponentRegistry::Get(type).Size;
+        memset((unsigned char*)GetArray(chunk, type) + row * size, 0, size);
+    }
+}
+
+bool Archetype::Remove(unsigned int chunk, unsigned int row, Entity& moved)
+{
+    unsigned int lastChunk = (unsigned int)m_Chunks.size() - 1;
+    unsigned int lastRow = m_Chunks[lastChunk].Count - 1;
+    bool filled = chunk != lastChunk || row != lastRow;
+
+    /* Keep chunks dense: the very last row fills the hole */
+    if (filled)
+    {
+        moved = GetEntities(lastChunk)[lastRow];
+        GetEntities(chunk)[row] = moved;
+        for (unsigned int type : m_Types)
+        {
+            unsigned int size = ComponentRegistry::Get(type).Size;
+            memcpy((unsigned char*)GetArray(chunk, type) + row * size,
+                (unsigned char*)GetArray(lastChunk, type) + lastRow * size, size);
+        }
+    }
+
+    --m_Count;
+    if (--m_Chunks[lastChunk].Count == 0)
+    {
+        free(m_Chunks[lastChunk].Data);
+        m_Chunks.pop_back();
+    }
+    return filled;
+}
+
+EntityWorld::EntityWorld()
+    : m_EntityCount(0)
+{
+}
+
+Archetype& EntityWorld::GetArchetype(ComponentMask mask)
+{
+    auto it = m_ArchetypeMap.find(mask);
+    if (it != m_ArchetypeMap.end())
+        return *it->second;
+
+    m_Archetypes.emplace_back(new Archetype(mask));
+    m_ArchetypeMap[mask] = m_Archetypes.back().get();
+    return *m_Archetypes.back();
+}
+
+Entity EntityWorld::CreateIn(Archetype& archetype)
+{
+    unsigned int index;
+    if (!m_FreeIndices.empty())
+    {
+        index = m_FreeIndices.back();
+        m_FreeIndices.pop_back();
+    }
+    else
+    {
+        index = (unsigned int)m_Records.size();
+        m_Records.push_back({ nullptr, 0, 0, 0 });
+    }
+
+    EntityRecord& record = m_Records[index];
+    Entity entity = { index, record.Generation };
+    record.Type = &archetype;
+    archetype.Push(entity, record.Chunk, record.Row);
+    ++m_EntityCount;
+    return entity;
+}
+
+void EntityWorld::RemoveRow(const EntityRecord& record)
+{
+    Entity moved;
+    if (record.Type->Remove(record.Chunk, record.Row, moved))
+    {
+        m_Records[moved.Index].Chunk = record.Chunk;
+        m_Records[moved.Index].Row = record.Row;
+    }
+}
+
+void EntityWorld::Destroy(const Entity& entity)
+{
+    if (!IsAlive(entity))
+        return;
+
+    EntityRecord record = m_Records[entity.Index];
+    RemoveRow(record);
+
+    m_Records[entity.Index].Type = nullptr;
+    ++m_Records[entity.Index].Generation;
+    m_FreeIndices.push_back(entity.Index);
+    --m_EntityCount;
+}
+
+bool EntityWorld::IsAlive(const Entity& entity) const
+{
+    return entity.Index < m_Records.size() && m_Records[entity.Index].Type &&
+        m_Records[entity.Index].Generation == entity.Generation;
+}
+
+void EntityWorld::Move(const Entity& entity, ComponentMask mask)
+{
+    EntityRecord old = m_Records[entity.Index];
+    Archetype& target = GetArchetype(mask);
+
+    EntityRecord& record = m_Records[entity.Index];
+    record.Type = &target;
+    target.Push(entity, record.Chunk, record.Row);
+
+    for (unsigned int type : old.Type->GetTypes())
+    {
+        void* destination = target.GetArray(record.Chunk, type);
+        if (!destination)
+            continue;
+        unsigned int size = ComponentRegistry::Get(type).Size;
+        memcpy((unsigned char*)destination + record.Row * size,
+            (unsigned char*)old.Type->GetArray(old.Chunk, type) + old.Row * size, size);
+    }
+
+    RemoveRow(old);
+}
@@ -0,0 +1,256 @@
+#pragma once
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "FrameArena.h"
+#include "ParallelFor.h"
+
+struct Entity
+{
+	unsigned int Index;
+	unsigned int Generation;
+
+	inline bool operator==(const Entity& other) const { return Index == other.Index && Generation == other.Generation; }
+
+	inline bool operator!=(const Entity& other) const { return !(*this == other); }
+};
+
+typedef unsigned long long ComponentMask;
+
+static const unsigned int MaxComponentTypes = 64;
+
+struct ComponentInfo
+{
+	unsigned int Size;
+	unsigned int Alignment;
+};
+
+/* Components are plain data, moved around with memcpy. Every type gets a small id on
+ * first use, ids index ComponentMask bits. */
+class ComponentRegistry
+{
+public:
+	static unsigned int Register(unsigned int size, unsigned int alignment);
+
+	static const ComponentInfo& Get(unsigned int type);
+};
+
+template<typename T>
+struct ComponentType
+{
+	static unsigned int GetID()
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "Components must be trivially copyable");
+		static const unsigned int id = ComponentRegistry::Register(sizeof(T), alignof(T));
+		return id;
+	}
+
+	static ComponentMask GetMask() { return 1ull << GetID(); }
+};
+
+template<typename... Components>
+ComponentMask GetComponentMask()
+{
+	ComponentMask mask = 0;
+	using expand = int[];
+	(void)expand{ 0, (mask |= ComponentType<Components>::GetMask(), 0)... };
+	return mask;
+}
+
+/* All entities with exactly the same set of components. They live in 16 KB chunks,
+ * inside a chunk every component is one contiguous array:
+ *
+ *   Entity[Capacity] | A[Capacity] | B[Capacity] ...
+ */
+class Archetype
+{
+public:
+	static const unsigned int ChunkSize = 16 * 1024;
+	static const unsigned int InvalidOffset = 0xffffffff;
+
+	struct Chunk
+	{
+		unsigned char* Data;
+		unsigned int Count;
+	};
+
+private:
+	ComponentMask m_Mask;
+	std::vector<unsigned int> m_Types;
+	unsigned int m_Offsets[MaxComponentTypes];
+	unsigned int m_Capacity;
+	std::vector<Chunk> m_Chunks;
+	unsigned int m_Count;
+
+public:
+	explicit Archetype(ComponentMask mask);
+
+	~Archetype();
+
+	Archetype(const Archetype&) = delete;
+	Archetype& operator=(const Archetype&) = delete;
+
+	/* Appends a zeroed row, returns where it went */
+	void Push(const Entity& entity, unsigned int& chunk, unsigned int& row);
+
+	/* Swap-removes a row, returns true and the entity that took its place if any */
+	bool Remove(unsigned int chunk, unsigned int row, Entity& moved);
+
+	inline ComponentMask GetMask() const { return m_Mask; }
+
+	inline const std::vector<unsigned int>& GetTypes() const { return m_Types; }
+
+	inline unsigned int GetCapacity() const { return m_Capacity; }
+
+	inline unsigned int GetCount() const { return m_Count; }
+
+	inline unsigned int GetChunkCount() const { return (unsigned int)m_Chunks.size(); }
+
+	inline unsigned int GetChunkSize(unsigned int chunk) const { return m_Chunks[chunk].Count; }
+
+	inline Entity* GetEntities(unsigned int chunk) const { return (Entity*)m_Chunks[chunk].Data; }
+
+	// nullptr when the component is not part of this archetype
+	inline void* GetArray(unsigned int chunk, unsigned int type) const
+	{
+		return m_Offsets[type] == InvalidOffset ? nullptr : m_Chunks[chunk].Data + m_Offsets[type];
+	}
+
+	template<typename T>
+	inline T* GetArray(unsigned int chunk) const { return (T*)GetArray(chunk, ComponentType<T>::GetID()); }
+};
+
+/* Archetype based entity-component store. Adding or removing a component moves the
+ * entity to another archetype, queries walk the chunks of every matching archetype
+ * linearly. */
+class EntityWorld
+{
+private:
+	struct EntityRecord
+	{
+		Archetype* Type;
+		unsigned int Chunk;
+		unsigned int Row;
+		unsigned int Generation;
+	};
+
+	std::vector<EntityRecord> m_Records;
+	std::vector<unsigned int> m_FreeIndices;
+
+	std::vector<std::unique_ptr<Archetype>> m_Archetypes;
+	std::unordered_map<ComponentMask, Archetype*> m_ArchetypeMap;
+
+	unsigned int m_EntityCount;
+
+	Archetype& GetArchetype(ComponentMask mask);
+
+	Entity CreateIn(Archetype& archetype);
+
+	void RemoveRow(const EntityRecord& record);
+
+	/* Moves an entity to the archetype of mask, keeping every shared component */
+	void Move(const Entity& entity, ComponentMask mask);
+
+public:
+	EntityWorld();
+
+	template<typename... Components>
+	Entity Create(const Components&... components)
+	{
+		Archetype& archetype = GetArchetype(GetComponentMask<Components...>());
+		Entity entity = CreateIn(archetype);
+		const EntityRecord& record = m_Records[entity.Index];
+		using expand = int[];
+		(void)expand{ 0, (archetype.GetArray<Components>(record.Chunk)[record.Row] = components, 0)... };
+		return entity;
+	}
+
+	void Destroy(const Entity& entity);
+
+	bool IsAlive(const Entity& entity) const;
+
+	template<typename T>
+	T* Get(const Entity& entity) const
+	{
+		if (!IsAlive(entity))
+			return nullptr;
+		const EntityRecord& record = m_Records[entity.Index];
+		T* array = record.Type->GetArray<T>(record.Chunk);
+		return array ? array + record.Row : nullptr;
+	}
+
+	template<typename T>
+	bool Has(const Entity& entity) const { return Get<T>(entity) != nullptr; }
+
+	template<typename T>
+	void Add(const Entity& entity, const T& component)
+	{
+		if (!Has<T>(entity))
+			Move(entity, m_Records[entity.Index].Type->GetMask() | ComponentType<T>::GetMask());
+		*Get<T>(entity) = component;
+	}
+
+	template<typename T>
+	void Remove(const Entity& entity)
+	{
+		if (Has<T>(entity))
+			Move(entity, m_Records[entity.Index].Type->GetMask() & ~ComponentType<T>::GetMask());
+	}
+
+	/* Calls function(count, Components*...) for every chunk holding all of Components */
+	template<typename... Components, typename Function>
+	void ForEachChunk(Function function) const
+	{
+		const ComponentMask mask = GetComponentMask<Components...>();
+		for (const auto& archetype : m_Archetypes)
+		{
+			if ((archetype->GetMask() & mask) != mask)
+				continue;
+			for (unsigned int chunk = 0; chunk < archetype->GetChunkCount(); ++chunk)
+				function(archetype->GetChunkSize(chunk), archetype->template GetArray<Components>(chunk)...);
+		}
+	}
+
+	/* Same as ForEachChunk with chunks spread over the job system, function must be
+	 * safe to call from several threads at once. It gets the index of the chunk in
+	 * ForEachChunk order first, so results can be put back in a deterministic order */
+	template<typename... Components, typename Function>
+	void ParallelForEachChunk(Function function) const
+	{
+		const ComponentMask mask = GetComponentMask<Components...>();
+		FrameVector<std::pair<Archetype*, unsigned int>> chunks;
+		for (const auto& archetype : m_Archetypes)
+		{
+			if ((archetype->GetMask() & mask) != mask)
+				continue;
+			for (unsigned int chunk = 0; chunk < archetype->GetChunkCount(); ++chunk)
+				chunks.emplace_back(archetype.get(), chunk);
+		}
+
+		ParallelFor((unsigned int)chunks.size(), 1, [&](unsigned int begin, unsigned int end)
+		{
+			for (unsigned int i = begin; i < end; ++i)
+			{
+				Archetype* archetype = chunks[i].first;
+				function(i, archetype->GetChunkSize(chunks[i].second), archetype->template GetArray<Components>(chunks[i].second)...);
+			}
+		});
+	}
+
+	/* Calls function(Components&...) for every entity holding all of Components */
+	template<typename... Components, typename Function>
+	void ForEach(Function function) const
+	{
+		ForEachChunk<Components...>([&function](unsigned int count, Components*... arrays)
+		{
+			for (unsigned int i = 0; i < count; ++i)
+				function(arrays[i]...);
+		});
+	}
+
+	inline unsigned int GetEntityCount() const { return m_EntityCount; }
+
+	inline unsigned int GetArchetypeCount() const { return (unsigned int)m_Archetypes.size(); }
+};
@@ -0,0 +1,122 @@
+#pragma once
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <utility>
+
+#include "Renderer.h"
+
+/* Recycles fixed-size objects through a free list per thread, so New and Delete
+ * usually neither lock nor touch the heap. Objects may be deleted on another thread
+ * than the one that made them; threads that only free hand batches back to a shared
+ * list that threads that only allocate take from. Memory goes back to the OS at exit.
+ */
+template<typename T>
+class FixedPool
+{
+public:
+	static const unsigned int BatchSize = 64;
+
+private:
+	union Node
+	{
+		Node* Next;
+		alignas(T) unsigned char Storage[sizeof(T)];
+	};
+
+	struct ThreadCache
+	{
+		Node* Free = nullptr;
+		unsigned int Count = 0;
+	};
+
+	struct Shared
+	{
+		std::mutex Mutex;
+		Node* Free = nullptr;
+		unsigned int Count = 0;
+	};
+
+	static inline ThreadCache& GetCache()
+	{
+		static thread_local ThreadCache cache;
+		return cache;
+	}
+
+	static inline Shared& GetShared()
+	{
+		static Shared shared;
+		return shared;
+	}
+
+	static void Refill(ThreadCache& cache)
+	{
+		{
+			Shared& shared = GetShared();
+			std::lock_guard<std::mutex> lock(shared.Mutex);
+			for (unsigned int i = 0; i < BatchSize && shared.Free; ++i)
+			{
+				Node* node = shared.Free;
+				shared.Free = node->Next;
+				--shared.Count;
+				node->Next = cache.Free;
+				cache.Free = node;
+				++cache.Count;
+			}
+		}
+		if (cache.Free)
+			return;
+
+		Node* nodes = (Node*)malloc(sizeof(Node) * BatchSize);
+		ASSERT(nodes);
+		for (unsigned int i = 0; i < BatchSize; ++i)
+		{
+			nodes[i].Next = cache.Free;
+			cache.Free = &nodes[i];
+		}
+		cache.Count += BatchSize;
+	}
+
+	static void Drain(ThreadCache& cache)
+	{
+		Shared& shared = GetShared();
+		std::lock_guard<std::mutex> lock(shared.Mutex);
+		for (unsigned int i = 0; i < BatchSize; ++i)
+		{
+			Node* node = cache.Free;
+			cache.Free = node->Next;
+			--cache.Count;
+			node->Next = shared.Free;
+			shared.Free = node;
+			++shared.Count;
+		}
+	}
+
+public:
+	template<typename... Args>
+	static T* New(Args&&... args)
+	{
+		ThreadCache& cache = GetCache();
+		if (!cache.Free)
+			Refill(cache);
+
+		Node* node = cache.Free;
+		cache.Free = node->Next;
+		--cache.Count;
+		return new (node->Storage) T(std::forward<Args>(args)...);
+	}
+
+	static void Delete(T* object)
+	{
+		if (!object)
+			return;
+		object->~T();
+
+		ThreadCache& cache = GetCache();
+		Node* node = (Node*)object;
+		node->Next = cache.Free;
+		cache.Free = node;
+		if (++cache.Count > 2 * BatchSize)
+			Drain(cache);
+	}
+};
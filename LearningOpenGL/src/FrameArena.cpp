@@ -0,0 +1,49 @@
+#include "FrameArena.h"
+#include "JobSystem.h"
+#include "Renderer.h"
+
+const unsigned int FrameArena::FrameCount;
+
+FrameArena* FrameArena::s_Instance = nullptr;
+
+FrameArena::FrameArena()
+    : m_External(new ThreadArena()), m_Frame(0)
+{
+    ASSERT(s_Instance == nullptr);
+    s_Instance = this;
+
+    const unsigned int workers = JobSystem::Get() ? JobSystem::Get()->GetWorkerCount() : 0;
+    for (unsigned int i = 0; i < workers; ++i)
+        m_Threads.emplace_back(new ThreadArena());
+}
+
+FrameArena::~FrameArena()
+{
+    s_Instance = nullptr;
+}
+
+void FrameArena::BeginFrame()
+{
+    m_Frame = (m_Frame + 1) % FrameCount;
+    for (auto& thread : m_Threads)
+        thread->Allocators[m_Frame].Reset();
+    m_External->Allocators[m_Frame].Reset();
+}
+
+void* FrameArena::Allocate(size_t size, size_t alignment)
+{
+    unsigned int index = JobSystem::GetWorkerIndex();
+    if (index < m_Threads.size())
+        return m_Threads[index]->Allocators[m_Frame].Allocate(size, alignment);
+
+    std::lock_guard<std::mutex> lock(m_ExternalMutex);
+    return m_External->Allocators[m_Frame].Allocate(size, alignment);
+}
+
+size_t FrameArena::GetUsed() const
+{
+    size_t used = m_External->Allocators[m_Frame].GetUsed();
+    for (const auto& thread : m_Threads)
+        used += thread->Allocators[m_Frame].GetUsed();
+    return used;
+}
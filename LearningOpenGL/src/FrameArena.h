@@ -0,0 +1,96 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "LinearAllocator.h"
+
+/* Scratch memory for one frame. Every job system worker bumps its own allocator, so
+ * allocating is a few instructions and never locks; threads outside the job system
+ * share one allocator behind a mutex. Memory stays valid until the end of the next
+ * frame, long enough for the render thread to replay what the frame recorded.
+ *
+ * BeginFrame must be called while nothing else allocates from the arena.
+ */
+class FrameArena
+{
+public:
+	static const unsigned int FrameCount = 2;
+
+private:
+	struct ThreadArena
+	{
+		LinearAllocator Allocators[FrameCount];
+
+		// Keeps the allocators off the cache line of the next thread's
+		unsigned char Padding[64];
+	};
+
+	std::vector<std::unique_ptr<ThreadArena>> m_Threads;
+	std::unique_ptr<ThreadArena> m_External;
+	std::mutex m_ExternalMutex;
+	unsigned int m_Frame;
+
+	static FrameArena* s_Instance;
+
+public:
+	FrameArena();
+
+	~FrameArena();
+
+	FrameArena(const FrameArena&) = delete;
+	FrameArena& operator=(const FrameArena&) = delete;
+
+	/* Frees what was allocated two frames ago */
+	void BeginFrame();
+
+	void* Allocate(size_t size, size_t alignment = 16);
+
+	// Bytes handed out this frame by every thread
+	size_t GetUsed() const;
+
+	static inline FrameArena* Get() { return s_Instance; }
+};
+
+/* std allocator over the FrameArena, deallocate does nothing. Falls back to the heap
+ * when there is no arena so the containers still work in tools and tests. */
+template<typename T>
+class FrameAllocator
+{
+private:
+	template<typename U>
+	friend class FrameAllocator;
+
+	FrameArena* m_Arena;
+
+public:
+	typedef T value_type;
+
+	FrameAllocator() noexcept : m_Arena(FrameArena::Get()) {}
+
+	template<typename U>
+	FrameAllocator(const FrameAllocator<U>& other) noexcept : m_Arena(other.m_Arena) {}
+
+	T* allocate(size_t count)
+	{
+		if (m_Arena)
+			return (T*)m_Arena->Allocate(count * sizeof(T), alignof(T) > 16 ? alignof(T) : 16);
+		return (T*)::operator new(count * sizeof(T));
+	}
+
+	void deallocate(T* pointer, size_t)
+	{
+		if (!m_Arena)
+			::operator delete(pointer);
+	}
+
+	template<typename U>
+	inline bool operator==(const FrameAllocator<U>& other) const { return m_Arena == other.m_Arena; }
+
+	template<typename U>
+	inline bool operator!=(const FrameAllocator<U>& other) const { return m_Arena != other.m_Arena; }
+};
+
+template<typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
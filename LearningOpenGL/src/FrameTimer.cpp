@@ -0,0 +1,253 @@
+#include "FrameTimer.h"
+#include "Profiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+
+const unsigned int FrameHistogram::SubBucketBits;
+const unsigned int FrameHistogram::SubBucketHalf;
+const unsigned int FrameHistogram::MaxShift;
+const unsigned int FrameHistogram::BucketCount;
+const unsigned int FrameTimer::StutterWindow;
+const unsigned int FrameTimer::MaxStutters;
+const double FrameTimer::StutterFactor = 2.0;
+
+FrameHistogram::FrameHistogram()
+{
+    Reset();
+}
+
+void FrameHistogram::Reset()
+{
+    std::fill(m_Counts, m_Counts + BucketCount, 0u);
+    m_Count = 0;
+    m_Sum = 0;
+    m_Max = 0;
+}
+
+unsigned int FrameHistogram::GetIndex(unsigned long long value)
+{
+    value = std::min(value, GetHighest(BucketCount - 1));
+
+    unsigned int shift = 0;
+    while ((value >> shift) >= (1u << SubBucketBits))
+        ++shift;
+    return shift * SubBucketHalf + (unsigned int)(value >> shift);
+}
+
+unsigned long long FrameHistogram::GetLowest(unsigned int index)
+{
+    unsigned int shift = index < SubBucketHalf * 2 ? 0 : index / SubBucketHalf - 1;
+    return (unsigned long long)(index - shift * SubBucketHalf) << shift;
+}
+
+unsigned long long FrameHistogram::GetHighest(unsigned int index)
+{
+    unsigned int shift = index < SubBucketHalf * 2 ? 0 : index / SubBucketHalf - 1;
+    return ((unsigned long long)(index - shift * SubBucketHalf + 1) << shift) - 1;
+}
+
+void FrameHistogram::Record(unsigned long long value)
+{
+    ++m_Counts[GetIndex(value)];
+    ++m_Count;
+    m_Sum += value;
+    m_Max = std::max(m_Max, value);
+}
+
+unsigned long long FrameHistogram::GetPercentile(double percentile) const
+{
+    if (m_Count == 0)
+        return 0;
+
+    unsigned long long target = (unsigned long long)std::ceil(percentile / 100.0 * m_Count);
+    target = std::max(target, 1ull);
+
+    unsigned long long seen = 0;
+    for (unsigned int i = 0; i < BucketCount; ++i)
+    {
+        seen += m_Counts[i];
+        if (seen >= target)
+            return std::min(GetHighest(i), m_Max);
+    }
+    return m_Max;
+}
+
+namespace {
+
+    struct Stutter
+    {
+        unsigned long long Frame;
+        unsigned long long Median;
+        unsigned long long Phases[(size_t)FramePhase::Count];
+    };
+
+    const char* const s_Names[(size_t)FramePhase::Count] = { "Frame", "Update", "Submit", "Present", "Gpu" };
+
+    std::mutex s_Mutex;
+    FrameHistogram s_Histograms[(size_t)FramePhase::Count];
+    // Latest value of every phase, what a stutter is reported with
+    unsigned long long s_Latest[(size_t)FramePhase::Count] = {};
+
+    unsigned long long s_FrameStart = 0;
+    unsigned long long s_FrameCount = 0;
+    unsigned long long s_Window[FrameTimer::StutterWindow] = {};
+
+    // The slowest stutters, so the report shows the worst hitches rather than the first ones
+    Stutter s_Stutters[FrameTimer::MaxStutters];
+    unsigned int s_StutterCount = 0;
+    unsigned long long s_TotalStutters = 0;
+
+    unsigned long long GetMedian()
+    {
+        unsigned long long window[FrameTimer::StutterWindow];
+        std::copy(s_Window, s_Window + FrameTimer::StutterWindow, window);
+        std::nth_element(window, window + FrameTimer::StutterWindow / 2, window + FrameTimer::StutterWindow);
+        return window[FrameTimer::StutterWindow / 2];
+    }
+
+    void AddStutter(unsigned long long frame, unsigned long long median)
+    {
+        ++s_TotalStutters;
+
+        unsigned int slot = s_StutterCount;
+        if (s_StutterCount < FrameTimer::MaxStutters)
+        {
+            ++s_StutterCount;
+        }
+        else
+        {
+            Stutter* fastest = std::min_element(s_Stutters, s_Stutters + FrameTimer::MaxStutters,
+                [](const Stutter& a, const Stutter& b) { return a.Phases[0] < b.Phases[0]; });
+            if (fastest->Phases[0] >= s_Latest[0])
+                return;
+            slot = (unsigned int)(fastest - s_Stutters);
+        }
+
+        Stutter& stutter = s_Stutters[slot];
+        stutter.Frame = frame;
+        stutter.Median = median;
+        std::copy(s_Latest, s_Latest + (size_t)FramePhase::Count, stutter.Phases);
+    }
+
+    double ToMilliseconds(unsigned long long nanoseconds)
+    {
+        return nanoseconds / 1000000.0;
+    }
+
+}
+
+void FrameTimer::BeginFrame()
+{
+    unsigned long long now = Profiler::GetTime();
+
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    if (s_FrameStart)
+    {
+        unsigned long long duration = now - s_FrameStart;
+        s_Histograms[(size_t)FramePhase::Frame].Record(duration);
+        s_Latest[(size_t)FramePhase::Frame] = duration;
+
+        if (s_FrameCount >= StutterWindow)
+        {
+            unsigned long long median = GetMedian();
+            if (duration > median * StutterFactor)
+                AddStutter(s_FrameCount, median);
+        }
+        s_Window[s_FrameCount % StutterWindow] = duration;
+        ++s_FrameCount;
+    }
+    s_FrameStart = now;
+}
+
+void FrameTimer::Record(FramePhase phase, unsigned long long duration)
+{
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    s_Histograms[(size_t)phase].Record(duration);
+    s_Latest[(size_t)phase] = duration;
+}
+
+unsigned long long FrameTimer::GetPercentile(FramePhase phase, double percentile)
+{
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    return s_Histograms[(size_t)phase].GetPercentile(percentile);
+}
+
+unsigned long long FrameTimer::GetStutterCount()
+{
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    return s_TotalStutters;
+}
+
+const char* FrameTimer::GetName(FramePhase phase)
+{
+    return s_Names[(size_t)phase];
+}
+
+bool FrameTimer::Export(const std::string& filePath)
+{
+    std::lock_guard<std::mutex> lock(s_Mutex);
+
+    std::ofstream stream(filePath);
+    if (!stream)
+    {
+        std::cout << "Error: Failed to write frame times " << filePath << std::endl;
+        return false;
+    }
+
+    char line[256];
+    std::snprintf(line, sizeof(line), "%-8s %10s %10s %10s %10s %10s %10s\n", "Phase", "Count", "Mean ms", "p50 ms", "p95 ms", "p99 ms", "Max ms");
+    stream << line;
+    std::cout << line;
+    for (size_t i = 0; i < (size_t)FramePhase::Count; ++i)
+    {
+        const FrameHistogram& histogram = s_Histograms[i];
+        std::snprintf(line, sizeof(line), "%-8s %10llu %10.3f %10.3f %10.3f %10.3f %10.3f\n", s_Names[i], histogram.GetCount(),
+            ToMilliseconds(histogram.GetMean()), ToMilliseconds(histogram.GetPercentile(50.0)),
+            ToMilliseconds(histogram.GetPercentile(95.0)), ToMilliseconds(histogram.GetPercentile(99.0)),
+            ToMilliseconds(histogram.GetMax()));
+        stream << line;
+        std::cout << line;
+    }
+
+    std::snprintf(line, sizeof(line), "Stutters: %llu frames over %.1fx the median of the last %u\n",
+        s_TotalStutters, StutterFactor, StutterWindow);
+    stream << '\n' << line;
+    std::cout << line;
+
+    std::sort(s_Stutters, s_Stutters + s_StutterCount, [](const Stutter& a, const Stutter& b) { return a.Frame < b.Frame; });
+    for (unsigned int i = 0; i < s_StutterCount; ++i)
+    {
+        const Stutter& stutter = s_Stutters[i];
+        stream << "  frame " << stutter.Frame << ": median " << ToMilliseconds(stutter.Median) << " ms";
+        for (size_t phase = 0; phase < (size_t)FramePhase::Count; ++phase)
+            stream << ", " << s_Names[phase] << " " << ToMilliseconds(stutter.Phases[phase]) << " ms";
+        stream << '\n';
+    }
+
+    /* Raw buckets, enough to merge runs or plot the distribution */
+    for (size_t i = 0; i < (size_t)FramePhase::Count; ++i)
+    {
+        stream << "\n[" << s_Names[i] << "]\nlowest_ns,highest_ns,count\n";
+        s_Histograms[i].ForEachBucket([&](unsigned long long lowest, unsigned long long highest, unsigned int count)
+        {
+            stream << lowest << ',' << highest << ',' << count << '\n';
+        });
+    }
+
+    return (bool)stream;
+}
+
+FrameTimerScope::FrameTimerScope(FramePhase phase)
+    : m_Phase(phase), m_Start(Profiler::GetTime())
+{
+}
+
+FrameTimerScope::~FrameTimerScope()
+{
+    FrameTimer::Record(m_Phase, Profiler::GetTime() - m_Start);
+}
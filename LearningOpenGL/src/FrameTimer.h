@@ -0,0 +1,102 @@
+#pragma once
+#include <string>
+
+/* Log-linear histogram in the style of HdrHistogram: 64 linear sub-buckets per power
+ * of two, so every recorded value keeps about 1.6% precision from nanoseconds up to
+ * minutes in a fixed 9 KB array. Percentiles come out as the upper bound of their
+ * bucket, the maximum is exact.
+ */
+class FrameHistogram
+{
+public:
+	static const unsigned int SubBucketBits = 7;
+	static const unsigned int SubBucketHalf = 1 << (SubBucketBits - 1);
+	static const unsigned int MaxShift = 34;     // values up to 2^41 ns
+	static const unsigned int BucketCount = (MaxShift + 2) * SubBucketHalf;
+
+private:
+	unsigned int m_Counts[BucketCount];
+	unsigned long long m_Count;
+	unsigned long long m_Sum;
+	unsigned long long m_Max;
+
+public:
+	FrameHistogram();
+
+	void Record(unsigned long long value);
+
+	void Reset();
+
+	unsigned long long GetPercentile(double percentile) const;
+
+	inline unsigned long long GetCount() const { return m_Count; }
+	inline unsigned long long GetMax() const { return m_Max; }
+	inline unsigned long long GetMean() const { return m_Count ? m_Sum / m_Count : 0; }
+
+	/* fn(lowest, highest, count) for every non-empty bucket, in order */
+	template<typename Fn>
+	void ForEachBucket(Fn fn) const
+	{
+		for (unsigned int i = 0; i < BucketCount; ++i)
+		{
+			if (m_Counts[i])
+				fn(GetLowest(i), GetHighest(i), m_Counts[i]);
+		}
+	}
+
+	static unsigned int GetIndex(unsigned long long value);
+	static unsigned long long GetLowest(unsigned int index);
+	static unsigned long long GetHighest(unsigned int index);
+};
+
+enum class FramePhase
+{
+	Frame,      // loop start to loop start
+	Update,     // simulation and draw extraction on the main thread
+	Submit,     // waiting for a command list, filling and handing it over
+	Present,    // glfwSwapBuffers on the render thread
+	Gpu,        // GPU time of the replayed commands, arrives a few frames late
+	Count
+};
+
+/* Frame time broken down by phase, all in nanoseconds. Phases are recorded from the
+ * main and the render thread. A frame is a stutter when it takes more than
+ * StutterFactor times the median of the last StutterWindow frames, the slowest ones
+ * are kept with the phase times around them.
+ */
+class FrameTimer
+{
+public:
+	static const unsigned int StutterWindow = 64;
+	static const unsigned int MaxStutters = 64;
+	static const double StutterFactor;
+
+	/* Once per frame at the top of the main loop, closes the previous frame */
+	static void BeginFrame();
+
+	static void Record(FramePhase phase, unsigned long long duration);
+
+	static unsigned long long GetPercentile(FramePhase phase, double percentile);
+
+	static unsigned long long GetStutterCount();
+
+	/* Percentiles, stutters and the raw buckets, also prints the summary */
+	static bool Export(const std::string& filePath);
+
+	static const char* GetName(FramePhase phase);
+};
+
+class FrameTimerScope
+{
+private:
+	FramePhase m_Phase;
+	unsigned long long m_Start;
+
+public:
+	explicit FrameTimerScope(FramePhase phase);
+
+	~FrameTimerScope();
+
+	FrameTimerScope(const FrameTimerScope&) = delete;
+	FrameTimerScope& operator=(const FrameTimerScope&) = delete;
+};
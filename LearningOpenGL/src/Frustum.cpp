@@ -0,0 +1,44 @@
+#include "Frustum.h"
+
+/* Gribb/Hartmann: every plane is a sum or difference of the 4th row and another row.
+ * glm is column-major, so row i is (m[0][i], m[1][i], m[2][i], m[3][i]). */
+Frustum::Frustum(const glm::mat4& viewProjection)
+{
+    glm::vec4 rows[4];
+    for (int i = 0; i < 4; ++i)
+        rows[i] = glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+
+    Planes[Left]   = rows[3] + rows[0];
+    Planes[Right]  = rows[3] - rows[0];
+    Planes[Bottom] = rows[3] + rows[1];
+    Planes[Top]    = rows[3] - rows[1];
+    Planes[Near]   = rows[3] + rows[2];
+    Planes[Far]    = rows[3] - rows[2];
+
+    for (auto& plane : Planes)
+        plane /= glm::length(glm::vec3(plane));
+}
+
+bool Frustum::IntersectsSphere(const glm::vec3& center, float radius) const
+{
+    for (const auto& plane : Planes)
+    {
+        if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+            return false;
+    }
+    return true;
+}
+
+bool Frustum::IntersectsBox(const BoundingBox& box) const
+{
+    glm::vec3 center = box.GetCenter();
+    glm::vec3 extents = box.GetExtents();
+    for (const auto& plane : Planes)
+    {
+        /* Projected radius of the box onto the plane normal */
+        float radius = glm::dot(extents, glm::abs(glm::vec3(plane)));
+        if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+            return false;
+    }
+    return true;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "MeshData.h"
+
+/* The six clip planes of a view-projection matrix, normals pointing inwards.
+ * Planes are normalized so plane distances are real distances. */
+struct Frustum
+{
+	enum Side { Left = 0, Right, Bottom, Top, Near, Far };
+
+	glm::vec4 Planes[6];
+
+	Frustum() {}
+
+	explicit Frustum(const glm::mat4& viewProjection);
+
+	bool IntersectsSphere(const glm::vec3& center, float radius) const;
+
+	bool IntersectsBox(const BoundingBox& box) const;
+};
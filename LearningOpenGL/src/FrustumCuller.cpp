@@ -0,0 +1,246 @@
+#include "FrustumCuller.h"
+#include "ParallelFor.h"
+
+#include <cmath>
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define CULL_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define CULL_TARGET_AVX2
+#else
+#define CULL_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#endif
+#endif
+
+const unsigned int FrustumCuller::BatchSize;
+
+unsigned int FrustumCuller::Add(const BoundingBox& box)
+{
+    glm::vec3 extents = box.GetExtents();
+    return Add(box.GetCenter(), extents, glm::length(extents));
+}
+
+unsigned int FrustumCuller::Add(const glm::vec3& center, const glm::vec3& extents, float radius)
+{
+    m_CenterX.push_back(center.x);
+    m_CenterY.push_back(center.y);
+    m_CenterZ.push_back(center.z);
+    m_ExtentX.push_back(extents.x);
+    m_ExtentY.push_back(extents.y);
+    m_ExtentZ.push_back(extents.z);
+    m_Radius.push_back(radius);
+    return GetCount() - 1;
+}
+
+void FrustumCuller::Set(unsigned int index, const BoundingBox& box)
+{
+    glm::vec3 extents = box.GetExtents();
+    Set(index, box.GetCenter(), extents, glm::length(extents));
+}
+
+void FrustumCuller::Set(unsigned int index, const glm::vec3& center, const glm::vec3& extents, float radius)
+{
+    m_CenterX[index] = center.x;
+    m_CenterY[index] = center.y;
+    m_CenterZ[index] = center.z;
+    m_ExtentX[index] = extents.x;
+    m_ExtentY[index] = extents.y;
+    m_ExtentZ[index] = extents.z;
+    m_Radius[index] = radius;
+}
+
+void FrustumCuller::Clear()
+{
+    m_CenterX.clear();
+    m_CenterY.clear();
+    m_CenterZ.clear();
+    m_ExtentX.clear();
+    m_ExtentY.clear();
+    m_ExtentZ.clear();
+    m_Radius.clear();
+}
+
+struct CullArrays
+{
+    const float* CenterX;
+    const float* CenterY;
+    const float* CenterZ;
+    const float* ExtentX;
+    const float* ExtentY;
+    const float* ExtentZ;
+    const float* Radius;
+};
+
+static unsigned int CullScalar(const Frustum& frustum, const CullArrays& a, unsigned int begin, unsigned int end, unsigned int* visible)
+{
+    unsigned int count = 0;
+    for (unsigned int i = begin; i < end; ++i)
+    {
+        bool inside = true;
+        for (const auto& plane : frustum.Planes)
+        {
+            float distance = plane.x * a.CenterX[i] + plane.y * a.CenterY[i] + plane.z * a.CenterZ[i] + plane.w;
+            float boxRadius = std::abs(plane.x) * a.ExtentX[i] + std::abs(plane.y) * a.ExtentY[i] + std::abs(plane.z) * a.ExtentZ[i];
+            inside &= distance >= -boxRadius && distance >= -a.Radius[i];
+        }
+        visible[count] = i;
+        count += inside;
+    }
+    return count;
+}
+
+#ifdef CULL_X86
+
+static unsigned int CullSSE(const Frustum& frustum, const CullArrays& a, unsigned int begin, unsigned int end, unsigned int* visible)
+{
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    __m128 planes[6][4], absPlanes[6][3];
+    for (int p = 0; p < 6; ++p)
+    {
+        for (int c = 0; c < 4; ++c)
+            planes[p][c] = _mm_set1_ps(frustum.Planes[p][c]);
+        for (int c = 0; c < 3; ++c)
+            absPlanes[p][c] = _mm_andnot_ps(signMask, planes[p][c]);
+    }
+
+    unsigned int count = 0, i = begin;
+    for (; i + 4 <= end; i += 4)
+    {
+        __m128 cx = _mm_loadu_ps(a.CenterX + i), cy = _mm_loadu_ps(a.CenterY + i), cz = _mm_loadu_ps(a.CenterZ + i);
+        __m128 ex = _mm_loadu_ps(a.ExtentX + i), ey = _mm_loadu_ps(a.ExtentY + i), ez = _mm_loadu_ps(a.ExtentZ + i);
+        __m128 negRadius = _mm_xor_ps(_mm_loadu_ps(a.Radius + i), signMask);
+
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (int p = 0; p < 6; ++p)
+        {
+            __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(planes[p][0], cx), _mm_mul_ps(planes[p][1], cy)),
+                _mm_add_ps(_mm_mul_ps(planes[p][2], cz), planes[p][3]));
+            __m128 boxRadius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(absPlanes[p][0], ex), _mm_mul_ps(absPlanes[p][1], ey)),
+                _mm_mul_ps(absPlanes[p][2], ez));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, boxRadius), _mm_setzero_ps()));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negRadius));
+        }
+
+        /* Branchless compaction: always write, only advance for visible lanes */
+        int mask = _mm_movemask_ps(inside);
+        for (unsigned int lane = 0; lane < 4; ++lane)
+        {
+            visible[count] = i + lane;
+            count += (mask >> lane) & 1;
+        }
+    }
+    return count + CullScalar(frustum, a, i, end, visible + count);
+}
+
+CULL_TARGET_AVX2
+static unsigned int CullAVX2(const Frustum& frustum, const CullArrays& a, unsigned int begin, unsigned int end, unsigned int* visible)
+{
+    const __m256 signMask = _mm256_set1_ps(-0.0f);
+    __m256 planes[6][4], absPlanes[6][3];
+    for (int p = 0; p < 6; ++p)
+    {
+        for (int c = 0; c < 4; ++c)
+            planes[p][c] = _mm256_set1_ps(frustum.Planes[p][c]);
+        for (int c = 0; c < 3; ++c)
+            absPlanes[p][c] = _mm256_andnot_ps(signMask, planes[p][c]);
+    }
+
+    unsigned int count = 0, i = begin;
+    for (; i + 8 <= end; i += 8)
+    {
+        __m256 cx = _mm256_loadu_ps(a.CenterX + i), cy = _mm256_loadu_ps(a.CenterY + i), cz = _mm256_loadu_ps(a.CenterZ + i);
+        __m256 ex = _mm256_loadu_ps(a.ExtentX + i), ey = _mm256_loadu_ps(a.ExtentY + i), ez = _mm256_loadu_ps(a.ExtentZ + i);
+        __m256 negRadius = _mm256_xor_ps(_mm256_loadu_ps(a.Radius + i), signMask);
+
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (int p = 0; p < 6; ++p)
+        {
+            __m256 distance = _mm256_fmadd_ps(planes[p][0], cx, _mm256_fmadd_ps(planes[p][1], cy, _mm256_fmadd_ps(planes[p][2], cz, planes[p][3])));
+            __m256 boxRadius = _mm256_fmadd_ps(absPlanes[p][0], ex, _mm256_fmadd_ps(absPlanes[p][1], ey, _mm256_mul_ps(absPlanes[p][2], ez)));
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(distance, boxRadius), _mm256_setzero_ps(), _CMP_GE_OQ));
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, negRadius, _CMP_GE_OQ));
+        }
+
+        int mask = _mm256_movemask_ps(inside);
+        for (unsigned int lane = 0; lane < 8; ++lane)
+        {
+            visible[count] = i + lane;
+            count += (mask >> lane) & 1;
+        }
+    }
+    return count + CullSSE(frustum, a, i, end, visible + count);
+}
+
+#endif
+
+bool FrustumCuller::IsAVX2Supported()
+{
+#if defined(CULL_X86) && defined(_MSC_VER)
+    static const bool supported = []()
+    {
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7)
+            return false;
+
+        /* AVX, FMA and OSXSAVE, then the OS must save the YMM registers */
+        __cpuid(info, 1);
+        const int required = (1 << 12) | (1 << 27) | (1 << 28);
+        if ((info[2] & required) != required || (_xgetbv(0) & 6) != 6)
+            return false;
+
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+    }();
+    return supported;
+#elif defined(CULL_X86)
+    static const bool supported = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+unsigned int FrustumCuller::Cull(const Frustum& frustum, unsigned int begin, unsigned int end, unsigned int* visible) const
+{
+    CullArrays arrays = { m_CenterX.data(), m_CenterY.data(), m_CenterZ.data(),
+        m_ExtentX.data(), m_ExtentY.data(), m_ExtentZ.data(), m_Radius.data() };
+
+#ifdef CULL_X86
+    if (IsAVX2Supported())
+        return CullAVX2(frustum, arrays, begin, end, visible);
+    return CullSSE(frustum, arrays, begin, end, visible);
+#else
+    return CullScalar(frustum, arrays, begin, end, visible);
+#endif
+}
+
+unsigned int FrustumCuller::Cull(const Frustum& frustum, std::vector<unsigned int>& visible)
+{
+    const unsigned int count = GetCount();
+    visible.resize(count);
+    if (count <= BatchSize)
+    {
+        visible.resize(Cull(frustum, 0, count, visible.data()));
+        return (unsigned int)visible.size();
+    }
+
+    /* Every batch compacts into its own slice, then the slices are joined */
+    m_BatchCounts.resize((count + BatchSize - 1) / BatchSize);
+    ParallelFor(count, BatchSize, [&](unsigned int begin, unsigned int end)
+    {
+        m_BatchCounts[begin / BatchSize] = Cull(frustum, begin, end, visible.data() + begin);
+    });
+
+    unsigned int total = m_BatchCounts[0];
+    for (unsigned int batch = 1; batch < m_BatchCounts.size(); ++batch)
+    {
+        memmove(visible.data() + total, visible.data() + batch * BatchSize, m_BatchCounts[batch] * sizeof(unsigned int));
+        total += m_BatchCounts[batch];
+    }
+    visible.resize(total);
+    return total;
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <vector>
+
+#include "Frustum.h"
+
+/* Visibility culling for many objects. Bounds are kept as structure of arrays
+ * (box center/extents plus a bounding sphere) and tested 8 at a time with AVX2,
+ * 4 at a time with SSE or one at a time elsewhere. An object is visible when both
+ * its box and its sphere touch the frustum.
+ */
+class FrustumCuller
+{
+private:
+	std::vector<float> m_CenterX, m_CenterY, m_CenterZ;
+	std::vector<float> m_ExtentX, m_ExtentY, m_ExtentZ;
+	std::vector<float> m_Radius;
+
+	std::vector<unsigned int> m_BatchCounts;
+
+public:
+	// Objects per thread when culling in parallel
+	static const unsigned int BatchSize = 16384;
+
+	/* Returns the index of the object, bounds are in the space of the frustum */
+	unsigned int Add(const BoundingBox& box);
+	unsigned int Add(const glm::vec3& center, const glm::vec3& extents, float radius);
+
+	void Set(unsigned int index, const BoundingBox& box);
+	void Set(unsigned int index, const glm::vec3& center, const glm::vec3& extents, float radius);
+
+	void Clear();
+
+	inline unsigned int GetCount() const { return (unsigned int)m_Radius.size(); }
+
+	/* Writes the indices of visible objects in [begin, end) to visible, which needs
+	 * room for end - begin entries. Returns the number written. Safe to call
+	 * concurrently on disjoint ranges. */
+	unsigned int Cull(const Frustum& frustum, unsigned int begin, unsigned int end, unsigned int* visible) const;
+
+	/* Culls every object, split across threads for large counts */
+	unsigned int Cull(const Frustum& frustum, std::vector<unsigned int>& visible);
+
+	static bool IsAVX2Supported();
+};
@@ -0,0 +1,916 @@
+#include "GltfLoader.h"
+#include "JsonReader.h"
+#include "MappedFile.h"
+#include "ParallelFor.h"
+
+#include <iostream>
+#include <cfloat>
+#include <climits>
+#include <cstring>
+
+#include "glm/gtc/matrix_transform.hpp"
+#include "glm/gtc/quaternion.hpp"
+#include "glm/gtc/type_ptr.hpp"
+
+static const unsigned int GlbMagic = 0x46546C67;     // "glTF"
+static const unsigned int GlbChunkJson = 0x4E4F534A; // "JSON"
+static const unsigned int GlbChunkBin = 0x004E4942;  // "BIN\0"
+
+/* Accessors larger than this are split into several decode jobs */
+static const unsigned int DecodeBatch = 1 << 16;
+
+enum GltfComponentType
+{
+    GltfByte = 5120,
+    GltfUnsignedByte = 5121,
+    GltfShort = 5122,
+    GltfUnsignedShort = 5123,
+    GltfUnsignedInt = 5125,
+    GltfFloat = 5126
+};
+
+struct GltfBufferView
+{
+    const unsigned char* Data;
+    size_t Length;
+    unsigned int Stride;
+};
+
+struct GltfAccessor
+{
+    int BufferView;
+    size_t Offset;
+    unsigned int ComponentType;
+    unsigned int Components;
+    unsigned int Count;
+    bool Normalized;
+
+    unsigned int SparseCount;
+    int SparseIndicesView;
+    size_t SparseIndicesOffset;
+    unsigned int SparseIndexType;
+    int SparseValuesView;
+    size_t SparseValuesOffset;
+
+    bool HasBounds;
+    glm::vec3 Min, Max;
+};
+
+/* One slice of an accessor written into a strided destination.
+ * Accessor == nullptr fills the slice with Default instead. */
+struct GltfDecodeJob
+{
+    const GltfAccessor* Accessor;
+    unsigned char* Destination;
+    unsigned int Stride;
+    unsigned int Components;
+    unsigned int Begin, End;
+    bool Indices;
+    bool FlipV;
+    unsigned int IndexBase;
+    glm::vec4 Default;
+};
+
+/* Vertices of one primitive, its indices have to stay inside */
+struct GltfVertexRange
+{
+    unsigned int First;
+    unsigned int Count;
+};
+
+struct GltfContext
+{
+    std::string BaseDirectory;
+    JsonDocument Json;
+
+    std::vector<std::unique_ptr<MappedFile>> Files;
+    std::vector<std::vector<unsigned char>> OwnedBuffers;
+
+    std::vector<const unsigned char*> Buffers;
+    std::vector<size_t> BufferSizes;
+    std::vector<GltfBufferView> BufferViews;
+    std::vector<GltfAccessor> Accessors;
+};
+
+static unsigned int ComponentSize(unsigned int componentType)
+{
+    switch (componentType)
+    {
+        case GltfByte:
+        case GltfUnsignedByte:  return 1;
+        case GltfShort:
+        case GltfUnsignedShort: return 2;
+        case GltfUnsignedInt:
+        case GltfFloat:         return 4;
+    }
+    return 0;
+}
+
+static unsigned int ComponentCount(const std::string& type)
+{
+    if (type == "SCALAR") return 1;
+    if (type == "VEC2")   return 2;
+    if (type == "VEC3")   return 3;
+    if (type == "VEC4")   return 4;
+    if (type == "MAT2")   return 4;
+    if (type == "MAT3")   return 9;
+    if (type == "MAT4")   return 16;
+    return 0;
+}
+
+static float ReadComponent(const unsigned char* src, unsigned int componentType, bool normalized)
+{
+    switch (componentType)
+    {
+        case GltfFloat:         { float v; memcpy(&v, src, 4); return v; }
+        case GltfUnsignedByte:  { unsigned char v = *src; return normalized ? v / 255.0f : (float)v; }
+        case GltfByte:          { signed char v = (signed char)*src; return normalized ? glm::max(v / 127.0f, -1.0f) : (float)v; }
+        case GltfUnsignedShort: { unsigned short v; memcpy(&v, src, 2); return normalized ? v / 65535.0f : (float)v; }
+        case GltfShort:         { short v; memcpy(&v, src, 2); return normalized ? glm::max(v / 32767.0f, -1.0f) : (float)v; }
+        case GltfUnsignedInt:   { unsigned int v; memcpy(&v, src, 4); return (float)v; }
+    }
+    return 0.0f;
+}
+
+static unsigned int ReadIndex(const unsigned char* src, unsigned int componentType)
+{
+    switch (componentType)
+    {
+        case GltfUnsignedByte:  return *src;
+        case GltfUnsignedShort: { unsigned short v; memcpy(&v, src, 2); return v; }
+        case GltfUnsignedInt:   { unsigned int v; memcpy(&v, src, 4); return v; }
+    }
+    return 0;
+}
+
+static bool DecodeBase64(const std::string& text, size_t start, std::vector<unsigned char>& out)
+{
+    static const std::string alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    unsigned char lookup[256];
+    memset(lookup, 0xFF, sizeof(lookup));
+    for (unsigned int i = 0; i < alphabet.size(); ++i)
+        lookup[(unsigned char)alphabet[i]] = (unsigned char)i;
+
+    out.clear();
+    out.reserve((text.size() - start) * 3 / 4);
+    unsigned int accumulator = 0;
+    int bits = 0;
+    for (size_t i = start; i < text.size() && text[i] != '='; ++i)
+    {
+        unsigned char value = lookup[(unsigned char)text[i]];
+        if (value == 0xFF)
+            return false;
+        accumulator = (accumulator << 6) | value;
+        bits += 6;
+        if (bits >= 8)
+        {
+            bits -= 8;
+            out.push_back((unsigned char)(accumulator >> bits));
+        }
+    }
+    return true;
+}
+
+/* Relative URIs may be percent-encoded, e.g. "my%20model.bin" */
+static int HexDigit(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+/* Fails on a '%' that is not followed by two hex digits */
+static bool DecodeUri(const std::string& uri, std::string& result)
+{
+    result.clear();
+    for (size_t i = 0; i < uri.size(); ++i)
+    {
+        if (uri[i] != '%')
+        {
+            result += uri[i];
+            continue;
+        }
+        int high = i + 2 < uri.size() ? HexDigit(uri[i + 1]) : -1;
+        int low = i + 2 < uri.size() ? HexDigit(uri[i + 2]) : -1;
+        if (high < 0 || low < 0)
+            return false;
+        result += (char)(high * 16 + low);
+        i += 2;
+    }
+    return true;
+}
+
+/* Index member: -1 when missing, INT_MAX when it is not an index at all, so an
+ * "index < count" check rejects it */
+static int GetIndex(const JsonDocument& json, unsigned int object, const char* key)
+{
+    int index = -1;
+    return json.GetInteger(object, key, index) ? index : INT_MAX;
+}
+
+static bool IsDataUri(const std::string& uri)
+{
+    return uri.compare(0, 5, "data:") == 0;
+}
+
+static bool LoadBuffers(GltfContext& context, const unsigned char* glbBinary, size_t glbBinarySize)
+{
+    const JsonDocument& json = context.Json;
+    for (unsigned int buffer : json.GetChildren(json.Find(json.GetRoot(), "buffers")))
+    {
+        /* Required, every size check below goes against it */
+        size_t byteLength = 0;
+        if (!json.GetInteger(json.Find(buffer, "byteLength"), byteLength))
+        {
+            std::cout << "Error: glTF buffer without a valid byteLength" << std::endl;
+            return false;
+        }
+        std::string uri = json.GetString(buffer, "uri");
+
+        if (uri.empty())
+        {
+            /* The buffer without uri is the binary chunk of a .glb */
+            if (!glbBinary || glbBinarySize < byteLength)
+            {
+                std::cout << "Error: glTF buffer without uri and no GLB binary chunk" << std::endl;
+                return false;
+            }
+            context.Buffers.push_back(glbBinary);
+            context.BufferSizes.push_back(glbBinarySize);
+        }
+        else if (IsDataUri(uri))
+        {
+            size_t comma = uri.find(";base64,");
+            context.OwnedBuffers.emplace_back();
+            if (comma == std::string::npos || !DecodeBase64(uri, comma + 8, context.OwnedBuffers.back()))
+            {
+                std::cout << "Error: unsupported glTF data uri" << std::endl;
+                return false;
+            }
+            if (context.OwnedBuffers.back().size() < byteLength)
+            {
+                std::cout << "Error: glTF data uri shorter than its byteLength" << std::endl;
+                return false;
+            }
+            context.Buffers.push_back(context.OwnedBuffers.back().data());
+            context.BufferSizes.push_back(context.OwnedBuffers.back().size());
+        }
+        else
+        {
+            std::unique_ptr<MappedFile> file(new MappedFile());
+            std::string path;
+            if (!DecodeUri(uri, path))
+            {
+                std::cout << "Error: invalid glTF buffer uri '" << uri << "'" << std::endl;
+                return false;
+            }
+            path = context.BaseDirectory + path;
+            if (!file->Open(path) || file->GetSize() < byteLength)
+            {
+                std::cout << "Error: failed to map glTF buffer '" << path << "'" << std::endl;
+                return false;
+            }
+            context.Buffers.push_back(file->GetData());
+            context.BufferSizes.push_back((size_t)file->GetSize());
+            context.Files.push_back(std::move(file));
+        }
+    }
+
+    for (unsigned int view : json.GetChildren(json.Find(json.GetRoot(), "bufferViews")))
+    {
+        unsigned int buffer = 0, stride = 0;
+        size_t offset = 0, length = 0;
+        if (!json.GetInteger(view, "buffer", buffer) || !json.GetInteger(view, "byteOffset", offset) ||
+            !json.GetInteger(view, "byteLength", length) || !json.GetInteger(view, "byteStride", stride))
+        {
+            std::cout << "Error: invalid glTF bufferView" << std::endl;
+            return false;
+        }
+        /* Written so that huge offsets can not wrap around */
+        if (buffer >= context.Buffers.size() || offset > context.BufferSizes[buffer] || length > context.BufferSizes[buffer] - offset)
+        {
+            std::cout << "Error: glTF bufferView out of range" << std::endl;
+            return false;
+        }
+        context.BufferViews.push_back({ context.Buffers[buffer] + offset, length, stride });
+    }
+    return true;
+}
+
+static bool ValidateRange(const GltfContext& context, int view, size_t offset, unsigned int count, unsigned int elementSize, unsigned int stride)
+{
+    if (view < 0 || view >= (int)context.BufferViews.size() || elementSize == 0 || stride == 0)
+        return false;
+    if (count == 0)
+        return true;
+
+    /* offset + (count - 1) * stride + elementSize <= length, without wrapping around */
+    const size_t length = context.BufferViews[view].Length;
+    if (offset > length || elementSize > length - offset)
+        return false;
+    return count - 1 <= (length - offset - elementSize) / stride;
+}
+
+static bool LoadAccessors(GltfContext& context)
+{
+    const JsonDocument& json = context.Json;
+    for (unsigned int node : json.GetChildren(json.Find(json.GetRoot(), "accessors")))
+    {
+        GltfAccessor accessor = {};
+        accessor.BufferView = -1;
+        accessor.Components = ComponentCount(json.GetString(node, "type"));
+        accessor.Normalized = json.GetBool(node, "normalized", false);
+        accessor.SparseIndicesView = -1;
+        accessor.SparseValuesView = -1;
+        if (!json.GetInteger(node, "bufferView", accessor.BufferView) || !json.GetInteger(node, "byteOffset", accessor.Offset) ||
+            !json.GetInteger(node, "componentType", accessor.ComponentType) || !json.GetInteger(node, "count", accessor.Count))
+        {
+            std::cout << "Error: invalid glTF accessor" << std::endl;
+            return false;
+        }
+
+        unsigned int elementSize = ComponentSize(accessor.ComponentType) * accessor.Components;
+        if (elementSize == 0)
+        {
+            std::cout << "Error: unsupported glTF accessor type" << std::endl;
+            return false;
+        }
+
+        /* Accessors without a bufferView are all zeros (plus sparse values) */
+        if (accessor.BufferView >= (int)context.BufferViews.size())
+        {
+            std::cout << "Error: glTF accessor references a missing bufferView" << std::endl;
+            return false;
+        }
+        if (accessor.BufferView >= 0)
+        {
+            unsigned int stride = context.BufferViews[accessor.BufferView].Stride;
+            if (!ValidateRange(context, accessor.BufferView, accessor.Offset, accessor.Count, elementSize, stride ? stride : elementSize))
+            {
+                std::cout << "Error: glTF accessor out of range" << std::endl;
+                return false;
+            }
+        }
+
+        unsigned int sparse = json.Find(node, "sparse");
+        if (sparse != JsonDocument::InvalidIndex)
+        {
+            unsigned int indices = json.Find(sparse, "indices");
+            unsigned int values = json.Find(sparse, "values");
+            accessor.SparseIndexType = GltfUnsignedInt;
+            if (!json.GetInteger(sparse, "count", accessor.SparseCount) ||
+                !json.GetInteger(indices, "bufferView", accessor.SparseIndicesView) ||
+                !json.GetInteger(indices, "byteOffset", accessor.SparseIndicesOffset) ||
+                !json.GetInteger(indices, "componentType", accessor.SparseIndexType) ||
+                !json.GetInteger(values, "bufferView", accessor.SparseValuesView) ||
+                !json.GetInteger(values, "byteOffset", accessor.SparseValuesOffset))
+            {
+                std::cout << "Error: invalid glTF sparse accessor" << std::endl;
+                return false;
+            }
+
+            unsigned int indexSize = ComponentSize(accessor.SparseIndexType);
+            if (!ValidateRange(context, accessor.SparseIndicesView, accessor.SparseIndicesOffset, accessor.SparseCount, indexSize, indexSize) ||
+                !ValidateRange(context, accessor.SparseValuesView, accessor.SparseValuesOffset, accessor.SparseCount, elementSize, elementSize))
+            {
+                std::cout << "Error: glTF sparse accessor out of range" << std::endl;
+                return false;
+            }
+        }
+
+        std::vector<unsigned int> min = json.GetChildren(json.Find(node, "min"));
+        std::vector<unsigned int> max = json.GetChildren(json.Find(node, "max"));
+        if (min.size() >= 3 && max.size() >= 3)
+        {
+            accessor.HasBounds = true;
+            for (int i = 0; i < 3; ++i)
+            {
+                accessor.Min[i] = (float)json.Get(min[i]).Number;
+                accessor.Max[i] = (float)json.Get(max[i]).Number;
+            }
+        }
+
+        context.Accessors.push_back(accessor);
+    }
+    return true;
+}
+
+static void WriteElement(const GltfDecodeJob& job, unsigned int element, const unsigned char* src)
+{
+    const GltfAccessor& accessor = *job.Accessor;
+    unsigned char* dst = job.Destination + (size_t)(element - job.Begin) * job.Stride;
+
+    if (job.Indices)
+    {
+        unsigned int index = src ? ReadIndex(src, accessor.ComponentType) : 0;
+        *(unsigned int*)dst = index + job.IndexBase;
+        return;
+    }
+
+    float* out = (float*)dst;
+    unsigned int componentSize = ComponentSize(accessor.ComponentType);
+    for (unsigned int c = 0; c < job.Components; ++c)
+    {
+        if (c < accessor.Components)
+            out[c] = src ? ReadComponent(src + c * componentSize, accessor.ComponentType, accessor.Normalized) : 0.0f;
+        else
+            out[c] = job.Default[c];
+    }
+    if (job.FlipV)
+        out[1] = 1.0f - out[1];
+}
+
+static void RunDecodeJob(const GltfContext& context, const GltfDecodeJob& job)
+{
+    if (!job.Accessor)
+    {
+        for (unsigned int i = job.Begin; i < job.End; ++i)
+            memcpy(job.Destination + (size_t)(i - job.Begin) * job.Stride, &job.Default[0], job.Components * sizeof(float));
+        return;
+    }
+
+    const GltfAccessor& accessor = *job.Accessor;
+    unsigned int elementSize = ComponentSize(accessor.ComponentType) * accessor.Components;
+
+    const unsigned char* base = nullptr;
+    unsigned int stride = elementSize;
+    if (accessor.BufferView >= 0)
+    {
+        const GltfBufferView& view = context.BufferViews[accessor.BufferView];
+        base = view.Data + accessor.Offset;
+        stride = view.Stride ? view.Stride : elementSize;
+    }
+
+    for (unsigned int i = job.Begin; i < job.End; ++i)
+        WriteElement(job, i, base ? base + (size_t)i * stride : nullptr);
+
+    /* Sparse substitution, only the values that fall into this slice */
+    if (accessor.SparseCount)
+    {
+        const unsigned char* indices = context.BufferViews[accessor.SparseIndicesView].Data + accessor.SparseIndicesOffset;
+        const unsigned char* values = context.BufferViews[accessor.SparseValuesView].Data + accessor.SparseValuesOffset;
+        unsigned int indexSize = ComponentSize(accessor.SparseIndexType);
+
+        for (unsigned int s = 0; s < accessor.SparseCount; ++s)
+        {
+            unsigned int target = ReadIndex(indices + s * indexSize, accessor.SparseIndexType);
+            if (target >= job.Begin && target < job.End)
+                WriteElement(job, target, values + (size_t)s * elementSize);
+        }
+    }
+}
+
+static void AddDecodeJobs(std::vector<GltfDecodeJob>& jobs, const GltfDecodeJob& job)
+{
+    for (unsigned int begin = job.Begin; begin < job.End; begin += DecodeBatch)
+    {
+        GltfDecodeJob slice = job;
+        slice.Begin = begin;
+        slice.End = glm::min(begin + DecodeBatch, job.End);
+        slice.Destination = job.Destination + (size_t)(begin - job.Begin) * job.Stride;
+        jobs.push_back(slice);
+    }
+}
+
+static int GetAttribute(const JsonDocument& json, unsigned int attributes, const char* name)
+{
+    return GetIndex(json, attributes, name);
+}
+
+static bool LoadMeshes(GltfContext& context, GltfScene& scene)
+{
+    const JsonDocument& json = context.Json;
+    std::vector<GltfDecodeJob> jobs;
+
+    std::vector<unsigned int> meshes = json.GetChildren(json.Find(json.GetRoot(), "meshes"));
+    scene.Meshes.resize(meshes.size());
+    std::vector<std::vector<GltfVertexRange>> vertexRanges(meshes.size());    // per SubMesh
+
+    /* First pass: lay out every mesh and allocate its buffers, so the
+     * decode jobs can write into their final location independently */
+    for (unsigned int m = 0; m < meshes.size(); ++m)
+    {
+        GltfMesh& gltfMesh = scene.Meshes[m];
+        MeshData& mesh = gltfMesh.Mesh;
+        gltfMesh.Name = json.GetString(meshes[m], "name");
+        gltfMesh.HasTangents = false;
+        gltfMesh.HasColors = false;
+
+        std::vector<unsigned int> primitives;
+        for (unsigned int primitive : json.GetChildren(json.Find(meshes[m], "primitives")))
+        {
+            unsigned int attributes = json.Find(primitive, "attributes");
+            int position = GetAttribute(json, attributes, "POSITION");
+            unsigned int mode = 4;
+            if (!json.GetInteger(primitive, "mode", mode) || mode != 4 || position < 0 || position >= (int)context.Accessors.size() ||
+                context.Accessors[position].Count == 0 || GetIndex(json, primitive, "indices") >= (int)context.Accessors.size())
+            {
+                std::cout << "Warning: skipping glTF primitive of mesh '" << gltfMesh.Name << "', only indexed or plain triangles with positions are supported" << std::endl;
+                continue;
+            }
+            gltfMesh.HasTangents |= GetAttribute(json, attributes, "TANGENT") >= 0;
+            gltfMesh.HasColors |= GetAttribute(json, attributes, "COLOR_0") >= 0;
+            primitives.push_back(primitive);
+        }
+
+        /* Same attribute order as the OBJ importer so the shaders can be shared */
+        mesh.Layout.Push<float>(3);
+        mesh.Layout.Push<float>(2);
+        mesh.Layout.Push<float>(3);
+        if (gltfMesh.HasTangents)
+            mesh.Layout.Push<float>(4);
+        if (gltfMesh.HasColors)
+            mesh.Layout.Push<float>(4);
+
+        unsigned int vertexCount = 0, indexCount = 0;
+        for (unsigned int primitive : primitives)
+        {
+            const GltfAccessor& position = context.Accessors[GetAttribute(json, json.Find(primitive, "attributes"), "POSITION")];
+            int indices = GetIndex(json, primitive, "indices");
+            vertexCount += position.Count;
+            indexCount += indices >= 0 && indices < (int)context.Accessors.size() ? context.Accessors[indices].Count : position.Count;
+        }
+        mesh.Vertices.resize((size_t)vertexCount * mesh.Layout.GetStride());
+        mesh.Indices.resize(indexCount);
+        mesh.Bounds = { glm::vec3(FLT_MAX), glm::vec3(-FLT_MAX) };
+
+        unsigned int baseVertex = 0, firstIndex = 0;
+        for (unsigned int primitive : primitives)
+        {
+            unsigned int attributes = json.Find(primitive, "attributes");
+            const GltfAccessor& position = context.Accessors[GetAttribute(json, attributes, "POSITION")];
+
+            const struct
+            {
+                const char* Name;
+                unsigned int Components;
+                bool Enabled;
+                glm::vec4 Default;
+            } channels[] = {
+                { "POSITION",   3, true,                  glm::vec4(0.0f) },
+                { "TEXCOORD_0", 2, true,                  glm::vec4(0.0f) },
+                { "NORMAL",     3, true,                  glm::vec4(0.0f, 0.0f, 1.0f, 0.0f) },
+                { "TANGENT",    4, gltfMesh.HasTangents,  glm::vec4(1.0f, 0.0f, 0.0f, 1.0f) },
+                { "COLOR_0",    4, gltfMesh.HasColors,    glm::vec4(1.0f) },
+            };
+
+            unsigned int offset = 0;
+            for (const auto& channel : channels)
+            {
+                if (!channel.Enabled)
+                    continue;
+
+                int accessor = GetAttribute(json, attributes, channel.Name);
+                if (accessor >= (int)context.Accessors.size() ||
+                    (accessor >= 0 && context.Accessors[accessor].Count < position.Count))
+                {
+                    std::cout << "Warning: glTF attribute " << channel.Name << " of mesh '" << gltfMesh.Name << "' is invalid" << std::endl;
+                    accessor = -1;
+                }
+
+                GltfDecodeJob job;
+                job.Accessor = accessor >= 0 ? &context.Accessors[accessor] : nullptr;
+                job.Destination = mesh.Vertices.data() + (size_t)baseVertex * mesh.Layout.GetStride() + offset;
+                job.Stride = mesh.Layout.GetStride();
+                job.Components = channel.Components;
+                job.Begin = 0;
+                job.End = position.Count;
+                job.Indices = false;
+                /* Texture is flipped on load, glTF has its uv origin at the top left */
+                job.FlipV = strcmp(channel.Name, "TEXCOORD_0") == 0;
+                job.IndexBase = 0;
+                job.Default = channel.Default;
+                AddDecodeJobs(jobs, job);
+
+                offset += channel.Components * sizeof(float);
+            }
+
+            int indices = GetIndex(json, primitive, "indices");
+            unsigned int count = position.Count;
+            if (indices >= 0 && indices < (int)context.Accessors.size())
+            {
+                count = context.Accessors[indices].Count;
+
+                GltfDecodeJob job;
+                job.Accessor = &context.Accessors[indices];
+                job.Destination = (unsigned char*)(mesh.Indices.data() + firstIndex);
+                job.Stride = sizeof(unsigned int);
+                job.Components = 1;
+                job.Begin = 0;
+                job.End = count;
+                job.Indices = true;
+                job.FlipV = false;
+                job.IndexBase = baseVertex;
+                AddDecodeJobs(jobs, job);
+            }
+            else
+            {
+                for (unsigned int i = 0; i < count; ++i)
+                    mesh.Indices[firstIndex + i] = baseVertex + i;
+            }
+
+            int material = GetIndex(json, primitive, "material");
+            SubMesh subMesh = { firstIndex, count, (unsigned int)material, { glm::vec3(FLT_MAX), glm::vec3(-FLT_MAX) } };
+            /* POSITION min/max are mandatory in glTF, so bounds come for free */
+            if (position.HasBounds)
+            {
+                subMesh.Bounds = { position.Min, position.Max };
+                mesh.Bounds.Min = glm::min(mesh.Bounds.Min, position.Min);
+                mesh.Bounds.Max = glm::max(mesh.Bounds.Max, position.Max);
+            }
+            mesh.SubMeshes.push_back(subMesh);
+            vertexRanges[m].push_back({ baseVertex, position.Count });
+
+            baseVertex += position.Count;
+            firstIndex += count;
+        }
+    }
+
+    /* Second pass: decode every accessor slice in parallel */
+    ParallelFor((unsigned int)jobs.size(), 1, [&](unsigned int begin, unsigned int end)
+    {
+        for (unsigned int i = begin; i < end; ++i)
+            RunDecodeJob(context, jobs[i]);
+    });
+
+    /* Index validation and bounds for primitives without min/max */
+    for (unsigned int m = 0; m < scene.Meshes.size(); ++m)
+    {
+        GltfMesh& gltfMesh = scene.Meshes[m];
+        MeshData& mesh = gltfMesh.Mesh;
+        for (unsigned int s = 0; s < mesh.SubMeshes.size(); ++s)
+        {
+            SubMesh& subMesh = mesh.SubMeshes[s];
+            const GltfVertexRange& range = vertexRanges[m][s];
+            bool computeBounds = subMesh.Bounds.Min.x > subMesh.Bounds.Max.x;
+            for (unsigned int i = subMesh.FirstIndex; i < subMesh.FirstIndex + subMesh.IndexCount; ++i)
+            {
+                /* Indices were rebased by First, unsigned wrap-around also catches overflow there */
+                if (mesh.Indices[i] - range.First >= range.Count)
+                {
+                    std::cout << "Warning: glTF mesh '" << gltfMesh.Name << "' has an out of range index" << std::endl;
+                    mesh.Indices[i] = range.First;
+                }
+                if (computeBounds)
+                {
+                    subMesh.Bounds.Min = glm::min(subMesh.Bounds.Min, mesh.GetPosition(mesh.Indices[i]));
+                    subMesh.Bounds.Max = glm::max(subMesh.Bounds.Max, mesh.GetPosition(mesh.Indices[i]));
+                }
+            }
+            mesh.Bounds.Min = glm::min(mesh.Bounds.Min, subMesh.Bounds.Min);
+            mesh.Bounds.Max = glm::max(mesh.Bounds.Max, subMesh.Bounds.Max);
+        }
+    }
+    return true;
+}
+
+static int GetTextureIndex(const JsonDocument& json, unsigned int object, const char* key)
+{
+    unsigned int textureInfo = json.Find(object, key);
+    return textureInfo == JsonDocument::InvalidIndex ? -1 : GetIndex(json, textureInfo, "index");
+}
+
+static void LoadMaterials(GltfContext& context, GltfScene& scene)
+{
+    const JsonDocument& json = context.Json;
+
+    std::vector<unsigned int> images = json.GetChildren(json.Find(json.GetRoot(), "images"));
+    for (unsigned int texture : json.GetChildren(json.Find(json.GetRoot(), "textures")))
+    {
+        GltfTexture gltfTexture;
+        int source = GetIndex(json, texture, "source");
+        if (source >= 0 && source < (int)images.size())
+        {
+            unsigned int image = images[source];
+            std::string uri = json.GetString(image, "uri");
+            gltfTexture.MimeType = json.GetString(image, "mimeType");
+
+            if (IsDataUri(uri))
+            {
+                size_t comma = uri.find(";base64,");
+                if (comma != std::string::npos)
+                    DecodeBase64(uri, comma + 8, gltfTexture.Encoded);
+            }
+            else if (!uri.empty())
+            {
+                std::string path;
+                if (DecodeUri(uri, path))
+                    gltfTexture.FilePath = context.BaseDirectory + path;
+                else
+                    std::cout << "Warning: invalid glTF image uri '" << uri << "'" << std::endl;
+            }
+            else
+            {
+                int view = GetIndex(json, image, "bufferView");
+                if (view >= 0 && view < (int)context.BufferViews.size())
+                {
+                    const GltfBufferView& bufferView = context.BufferViews[view];
+                    gltfTexture.Encoded.assign(bufferView.Data, bufferView.Data + bufferView.Length);
+                }
+            }
+        }
+        scene.Textures.push_back(std::move(gltfTexture));
+    }
+
+    for (unsigned int material : json.GetChildren(json.Find(json.GetRoot(), "materials")))
+    {
+        GltfMaterial gltfMaterial;
+        gltfMaterial.Name = json.GetString(material, "name");
+
+        unsigned int pbr = json.Find(material, "pbrMetallicRoughness");
+        std::vector<unsigned int> baseColor = json.GetChildren(json.Find(pbr, "baseColorFactor"));
+        gltfMaterial.BaseColorFactor = glm::vec4(1.0f);
+        for (unsigned int i = 0; i < baseColor.size() && i < 4; ++i)
+            gltfMaterial.BaseColorFactor[i] = (float)json.Get(baseColor[i]).Number;
+
+        std::vector<unsigned int> emissive = json.GetChildren(json.Find(material, "emissiveFactor"));
+        gltfMaterial.EmissiveFactor = glm::vec3(0.0f);
+        for (unsigned int i = 0; i < emissive.size() && i < 3; ++i)
+            gltfMaterial.EmissiveFactor[i] = (float)json.Get(emissive[i]).Number;
+
+        gltfMaterial.MetallicFactor = (float)json.GetNumber(pbr, "metallicFactor", 1.0);
+        gltfMaterial.RoughnessFactor = (float)json.GetNumber(pbr, "roughnessFactor", 1.0);
+        gltfMaterial.AlphaCutoff = (float)json.GetNumber(material, "alphaCutoff", 0.5);
+        gltfMaterial.AlphaBlend = json.GetString(material, "alphaMode", "OPAQUE") == "BLEND";
+        gltfMaterial.DoubleSided = json.GetBool(material, "doubleSided", false);
+
+        gltfMaterial.BaseColorTexture = GetTextureIndex(json, pbr, "baseColorTexture");
+        gltfMaterial.MetallicRoughnessTexture = GetTextureIndex(json, pbr, "metallicRoughnessTexture");
+        gltfMaterial.NormalTexture = GetTextureIndex(json, material, "normalTexture");
+        gltfMaterial.OcclusionTexture = GetTextureIndex(json, material, "occlusionTexture");
+        gltfMaterial.EmissiveTexture = GetTextureIndex(json, material, "emissiveTexture");
+
+        scene.Materials.push_back(gltfMaterial);
+    }
+}
+
+static glm::mat4 GetNodeTransform(const JsonDocument& json, unsigned int node)
+{
+    std::vector<unsigned int> matrix = json.GetChildren(json.Find(node, "matrix"));
+    if (matrix.size() == 16)
+    {
+        float values[16];
+        for (int i = 0; i < 16; ++i)
+            values[i] = (float)json.Get(matrix[i]).Number;
+        return glm::make_mat4(values);  // glTF matrices are column-major like glm
+    }
+
+    glm::vec3 translation(0.0f), scale(1.0f);
+    glm::quat rotation(1.0f, 0.0f, 0.0f, 0.0f);
+
+    std::vector<unsigned int> t = json.GetChildren(json.Find(node, "translation"));
+    std::vector<unsigned int> r = json.GetChildren(json.Find(node, "rotation"));
+    std::vector<unsigned int> s = json.GetChildren(json.Find(node, "scale"));
+    if (t.size() == 3)
+        translation = glm::vec3(json.Get(t[0]).Number, json.Get(t[1]).Number, json.Get(t[2]).Number);
+    if (r.size() == 4)   // stored as x, y, z, w
+        rotation = glm::quat((float)json.Get(r[3]).Number, (float)json.Get(r[0]).Number, (float)json.Get(r[1]).Number, (float)json.Get(r[2]).Number);
+    if (s.size() == 3)
+        scale = glm::vec3(json.Get(s[0]).Number, json.Get(s[1]).Number, json.Get(s[2]).Number);
+
+    return glm::translate(glm::mat4(1.0f), translation) * glm::mat4_cast(rotation) * glm::scale(glm::mat4(1.0f), scale);
+}
+
+static void LoadNodes(GltfContext& context, GltfScene& scene)
+{
+    const JsonDocument& json = context.Json;
+    std::vector<unsigned int> nodes = json.GetChildren(json.Find(json.GetRoot(), "nodes"));
+
+    /* Roots come from the default scene, or every node without a parent */
+    std::vector<unsigned int> roots;
+    std::vector<unsigned int> scenes = json.GetChildren(json.Find(json.GetRoot(), "scenes"));
+    unsigned int defaultScene = 0;
+    if (json.GetInteger(json.GetRoot(), "scene", defaultScene) && defaultScene < scenes.size())
+    {
+        unsigned int index;
+        for (unsigned int root : json.GetChildren(json.Find(scenes[defaultScene], "nodes")))
+            if (json.GetInteger(root, index))
+                roots.push_back(index);
+    }
+    else
+    {
+        std::vector<bool> hasParent(nodes.size(), false);
+        unsigned int index;
+        for (unsigned int node : nodes)
+            for (unsigned int child : json.GetChildren(json.Find(node, "children")))
+                if (json.GetInteger(child, index) && index < nodes.size())
+                    hasParent[index] = true;
+        for (unsigned int i = 0; i < nodes.size(); ++i)
+            if (!hasParent[i])
+                roots.push_back(i);
+    }
+
+    /* Depth-first with an explicit stack, the visited flags guard against cycles */
+    struct Pending { unsigned int Node; glm::mat4 Parent; };
+    std::vector<Pending> stack;
+    std::vector<bool> visited(nodes.size(), false);
+    for (unsigned int root : roots)
+        stack.push_back({ root, glm::mat4(1.0f) });
+
+    while (!stack.empty())
+    {
+        Pending pending = stack.back();
+        stack.pop_back();
+        if (pending.Node >= nodes.size() || visited[pending.Node])
+            continue;
+        visited[pending.Node] = true;
+
+        unsigned int node = nodes[pending.Node];
+        glm::mat4 world = pending.Parent * GetNodeTransform(json, node);
+
+        int mesh = GetIndex(json, node, "mesh");
+        if (mesh >= 0 && mesh < (int)scene.Meshes.size())
+            scene.Instances.push_back({ (unsigned int)mesh, world });
+
+        unsigned int index;
+        for (unsigned int child : json.GetChildren(json.Find(node, "children")))
+            if (json.GetInteger(child, index))
+                stack.push_back({ index, world });
+    }
+}
+
+bool GltfLoader::Load(const std::string& filePath, GltfScene& scene)
+{
+    scene = GltfScene();
+
+    GltfContext context;
+    size_t slash = filePath.find_last_of("/\\");
+    context.BaseDirectory = slash == std::string::npos ? "" : filePath.substr(0, slash + 1);
+
+    MappedFile file;
+    if (!file.Open(filePath))
+    {
+        std::cout << "Error: failed to open '" << filePath << "'" << std::endl;
+        return false;
+    }
+
+    const char* json = (const char*)file.GetData();
+    size_t jsonSize = (size_t)file.GetSize();
+    const unsigned char* binary = nullptr;
+    size_t binarySize = 0;
+
+    /* GLB container: 12 byte header, JSON chunk, optional BIN chunk */
+    unsigned int magic = 0;
+    if (file.GetSize() >= 4)
+        memcpy(&magic, file.GetData(), 4);
+    if (magic == GlbMagic)
+    {
+        unsigned int header[5] = {};
+        if (file.GetSize() < sizeof(header))
+        {
+            std::cout << "Error: '" << filePath << "' is a truncated GLB" << std::endl;
+            return false;
+        }
+        memcpy(header, file.GetData(), sizeof(header));
+        if (header[1] != 2 || header[4] != GlbChunkJson || 20ull + header[3] > file.GetSize())
+        {
+            std::cout << "Error: '" << filePath << "' is not a glTF 2.0 binary" << std::endl;
+            return false;
+        }
+        json = (const char*)file.GetData() + 20;
+        jsonSize = header[3];
+
+        unsigned long long binaryChunk = 20ull + header[3];
+        if (binaryChunk + 8 <= file.GetSize())
+        {
+            unsigned int chunk[2];
+            memcpy(chunk, file.GetData() + binaryChunk, 8);
+            if (chunk[1] == GlbChunkBin && binaryChunk + 8 + chunk[0] <= file.GetSize())
+            {
+                binary = file.GetData() + binaryChunk + 8;
+                binarySize = chunk[0];
+            }
+        }
+    }
+
+    std::string error;
+    if (!context.Json.Parse(json, jsonSize, &error))
+    {
+        std::cout << "Error: failed to parse '" << filePath << "': " << error << std::endl;
+        return false;
+    }
+
+    std::string version = context.Json.GetString(context.Json.Find(context.Json.GetRoot(), "asset"), "version");
+    if (version.compare(0, 1, "2") != 0)
+    {
+        std::cout << "Error: '" << filePath << "' is glTF " << version << ", only 2.x is supported" << std::endl;
+        return false;
+    }
+
+    if (!LoadBuffers(context, binary, binarySize) || !LoadAccessors(context) || !LoadMeshes(context, scene))
+        return false;
+
+    LoadMaterials(context, scene);
+    LoadNodes(context, scene);
+    return true;
+}
+
+std::unique_ptr<Texture> GltfTexture::CreateTexture() const
+{
+    if (!FilePath.empty())
+        return std::make_unique<Texture>(FilePath);
+    if (!Encoded.empty())
+        return std::make_unique<Texture>(Encoded.data(), (unsigned int)Encoded.size());
+    return nullptr;
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "MeshData.h"
+#include "Texture.h"
+
+struct GltfMaterial
+{
+	std::string Name;
+	glm::vec4 BaseColorFactor;
+	glm::vec3 EmissiveFactor;
+	float MetallicFactor;
+	float RoughnessFactor;
+	float AlphaCutoff;
+	bool AlphaBlend;
+	bool DoubleSided;
+
+	// Indices into GltfScene::Textures, -1 when unused
+	int BaseColorTexture;
+	int MetallicRoughnessTexture;
+	int NormalTexture;
+	int OcclusionTexture;
+	int EmissiveTexture;
+};
+
+/* Either a file next to the asset or an encoded image embedded in a buffer */
+struct GltfTexture
+{
+	std::string FilePath;
+	std::string MimeType;
+	std::vector<unsigned char> Encoded;
+
+	// Must be called on the thread that owns the GL context
+	std::unique_ptr<Texture> CreateTexture() const;
+};
+
+/* Every glTF primitive becomes a SubMesh whose MaterialIndex points into
+ * GltfScene::Materials (or is -1 cast to unsigned int for the default material).
+ * Vertices are float3 position, float2 texcoord, float3 normal, then float4 tangent
+ * and float4 color when any primitive of the mesh has them.
+ */
+struct GltfMesh
+{
+	std::string Name;
+	MeshData Mesh;
+	bool HasTangents;
+	bool HasColors;
+};
+
+struct GltfInstance
+{
+	unsigned int Mesh;
+	glm::mat4 Transform;
+};
+
+struct GltfScene
+{
+	std::vector<GltfMesh> Meshes;
+	std::vector<GltfMaterial> Materials;
+	std::vector<GltfTexture> Textures;
+	// Flattened node hierarchy of the default scene
+	std::vector<GltfInstance> Instances;
+};
+
+/* glTF 2.0 importer for .gltf (+ .bin or data URIs) and .glb files.
+ * JSON goes through the SAX JsonReader, accessors are decoded on worker threads
+ * straight into the interleaved vertex buffers.
+ */
+class GltfLoader
+{
+public:
+	static bool Load(const std::string& filePath, GltfScene& scene);
+};
@@ -10,15 +10,44 @@ IndexBuffer::IndexBuffer(const unsigned int* data, unsigned int count)
     GLCall(glGenBuffers(1, &m_RenderedID));
     GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RenderedID));
     GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(unsigned int), data, GL_STATIC_DRAW));
+    if (data)
+        RenderStats::Add(RenderCounter::BufferBytesUploaded, count * sizeof(unsigned int));
+}
+
+IndexBuffer::IndexBuffer(IndexBuffer&& other) noexcept
+    : m_RenderedID(other.m_RenderedID), m_Count(other.m_Count)
+{
+    other.m_RenderedID = 0;
+    other.m_Count = 0;
+}
+
+IndexBuffer& IndexBuffer::operator=(IndexBuffer&& other) noexcept
+{
+    if (this != &other)
+    {
+        if (m_RenderedID)
+        {
+            GLCall(glDeleteBuffers(1, &m_RenderedID));
+        }
+        m_RenderedID = other.m_RenderedID;
+        m_Count = other.m_Count;
+        other.m_RenderedID = 0;
+        other.m_Count = 0;
+    }
+    return *this;
 }
 
 IndexBuffer::~IndexBuffer()
 {
-    GLCall(glDeleteBuffers(1, &m_RenderedID));
+    if (m_RenderedID)
+    {
+        GLCall(glDeleteBuffers(1, &m_RenderedID));
+    }
 }
 
 void IndexBuffer::Bind() const
 {
+    RenderStats::Add(RenderCounter::BufferBinds);
     GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RenderedID));
 }
 
@@ -26,3 +55,12 @@ void IndexBuffer::Unbind() const
 {
     GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
 }
+
+void IndexBuffer::SetData(const unsigned int* data, unsigned int count, unsigned int offset)
+{
+    ASSERT(offset + count <= m_Count);
+
+    Bind();
+    GLCall(glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, offset * sizeof(unsigned int), count * sizeof(unsigned int), data));
+    RenderStats::Add(RenderCounter::BufferBytesUploaded, count * sizeof(unsigned int));
+}
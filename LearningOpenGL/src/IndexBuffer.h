@@ -11,9 +11,23 @@ public:
 
 	~IndexBuffer();
 
+	// Move only, a moved-from object owns GL name 0
+	IndexBuffer(IndexBuffer&& other) noexcept;
+
+	IndexBuffer& operator=(IndexBuffer&& other) noexcept;
+
+	IndexBuffer(const IndexBuffer&) = delete;
+
+	IndexBuffer& operator=(const IndexBuffer&) = delete;
+
 	void Bind() const;
 
 	void Unbind() const;
 
+	// Overwrite part of the buffer, offset and count in indices
+	void SetData(const unsigned int* data, unsigned int count, unsigned int offset = 0);
+
 	inline unsigned int GetCount() const { return m_Count; }
+
+	inline unsigned int GetRendererID() const { return m_RenderedID; }
 };
\ No newline at end of file
@@ -0,0 +1,139 @@
+#include "IndirectDrawList.h"
+
+#include "Renderer.h"
+
+const unsigned int IndirectDrawList::DrawIDLocation;
+
+IndirectDrawList::IndirectDrawList(unsigned int capacity)
+    : m_IndirectBufferID(0), m_DrawIDBufferID(0), m_DrawIDCapacity(0), m_Dirty(true)
+{
+    m_MultiDrawIndirect = GLEW_VERSION_4_3 ||
+        (GLEW_ARB_multi_draw_indirect && GLEW_ARB_draw_indirect && GLEW_ARB_base_instance);
+
+    m_Commands.reserve(capacity);
+    m_Pages.reserve(capacity);
+
+    if (m_MultiDrawIndirect)
+    {
+        GLCall(glGenBuffers(1, &m_IndirectBufferID));
+    }
+    GLCall(glGenBuffers(1, &m_DrawIDBufferID));
+}
+
+IndirectDrawList::~IndirectDrawList()
+{
+    if (m_IndirectBufferID)
+    {
+        GLCall(glDeleteBuffers(1, &m_IndirectBufferID));
+    }
+    GLCall(glDeleteBuffers(1, &m_DrawIDBufferID));
+}
+
+unsigned int IndirectDrawList::Add(const MeshAllocation& mesh, unsigned int instanceCount)
+{
+    ASSERT(mesh.IsValid());
+
+    unsigned int drawID = (unsigned int)m_Commands.size();
+    m_Commands.push_back({ mesh.IndexCount, instanceCount, mesh.FirstIndex, (int)mesh.BaseVertex, 0 });
+    m_Pages.push_back(mesh.Page);
+    m_Dirty = true;
+    return drawID;
+}
+
+void IndirectDrawList::Clear()
+{
+    m_Commands.clear();
+    m_Pages.clear();
+    m_Dirty = true;
+}
+
+void IndirectDrawList::Upload()
+{
+    if (!m_Dirty)
+        return;
+    m_Dirty = false;
+
+    /* Counting sort by page, one multi-draw is issued per page */
+    unsigned int pageCount = 0;
+    for (unsigned int page : m_Pages)
+        pageCount = page + 1 > pageCount ? page + 1 : pageCount;
+
+    std::vector<unsigned int> offsets(pageCount + 1, 0);
+    for (unsigned int page : m_Pages)
+        ++offsets[page + 1];
+    for (unsigned int i = 0; i < pageCount; ++i)
+        offsets[i + 1] += offsets[i];
+
+    m_Ranges.clear();
+    for (unsigned int page = 0; page < pageCount; ++page)
+    {
+        if (offsets[page + 1] > offsets[page])
+            m_Ranges.push_back({ page, offsets[page], offsets[page + 1] - offsets[page] });
+    }
+
+    m_Sorted.resize(m_Commands.size());
+    m_SortedDrawIDs.resize(m_Commands.size());
+    for (unsigned int i = 0; i < m_Commands.size(); ++i)
+    {
+        unsigned int slot = offsets[m_Pages[i]]++;
+        m_Sorted[slot] = m_Commands[i];
+        m_SortedDrawIDs[slot] = i;
+    }
+
+    /* With divisor 1, instance k of a command fetches element BaseInstance + k, so every
+     * command gets a run of its own holding its draw id once per instance */
+    m_InstanceDrawIDs.clear();
+    for (unsigned int i = 0; i < m_Sorted.size(); ++i)
+    {
+        m_Sorted[i].BaseInstance = (unsigned int)m_InstanceDrawIDs.size();
+        m_InstanceDrawIDs.insert(m_InstanceDrawIDs.end(), m_Sorted[i].InstanceCount, m_SortedDrawIDs[i]);
+    }
+
+    if (m_MultiDrawIndirect && !m_InstanceDrawIDs.empty())
+    {
+        GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_DrawIDBufferID));
+        if (m_DrawIDCapacity < m_InstanceDrawIDs.size())
+        {
+            m_DrawIDCapacity = BuddyAllocator::NextPowerOfTwo((unsigned int)m_InstanceDrawIDs.size());
+            GLCall(glBufferData(GL_ARRAY_BUFFER, m_DrawIDCapacity * sizeof(unsigned int), nullptr, GL_DYNAMIC_DRAW));
+        }
+        GLCall(glBufferSubData(GL_ARRAY_BUFFER, 0, m_InstanceDrawIDs.size() * sizeof(unsigned int), m_InstanceDrawIDs.data()));
+        RenderStats::Add(RenderCounter::BufferBytesUploaded, m_InstanceDrawIDs.size() * sizeof(unsigned int));
+    }
+
+    if (m_MultiDrawIndirect && !m_Sorted.empty())
+    {
+        /* Orphan the old storage so we don't wait for the previous frame's draws */
+        GLCall(glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_IndirectBufferID));
+        GLCall(glBufferData(GL_DRAW_INDIRECT_BUFFER, m_Sorted.size() * sizeof(DrawElementsIndirectCommand), nullptr, GL_STREAM_DRAW));
+        GLCall(glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, m_Sorted.size() * sizeof(DrawElementsIndirectCommand), m_Sorted.data()));
+        RenderStats::Add(RenderCounter::BufferBytesUploaded, m_Sorted.size() * sizeof(DrawElementsIndirectCommand));
+    }
+}
+
+void IndirectDrawList::BindDrawIDs() const
+{
+    if (m_MultiDrawIndirect)
+    {
+        /* Instanced attribute: with divisor 1 the fetched element is offset by
+         * baseInstance, so every command reads its own draw id */
+        GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_DrawIDBufferID));
+        GLCall(glEnableVertexAttribArray(DrawIDLocation));
+        GLCall(glVertexAttribIPointer(DrawIDLocation, 1, GL_UNSIGNED_INT, 0, 0));
+        GLCall(glVertexAttribDivisor(DrawIDLocation, 1));
+    }
+    else
+    {
+        /* Without base instance the id is set per draw as a constant attribute */
+        GLCall(glDisableVertexAttribArray(DrawIDLocation));
+    }
+}
+
+void IndirectDrawList::UnbindDrawIDs() const
+{
+    if (m_MultiDrawIndirect)
+    {
+        GLCall(glVertexAttribDivisor(DrawIDLocation, 0));
+        GLCall(glDisableVertexAttribArray(DrawIDLocation));
+    }
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include <vector>
+
+#include "MeshPool.h"
+
+/* Layout mandated by glMultiDrawElementsIndirect, do not reorder */
+struct DrawElementsIndirectCommand
+{
+	unsigned int Count;
+	unsigned int InstanceCount;
+	unsigned int FirstIndex;
+	int BaseVertex;
+	unsigned int BaseInstance;
+};
+
+/* A list of MeshPool draws submitted together by Renderer::DrawIndirect.
+ * Every draw gets an id that shaders read from the a_DrawID attribute at DrawIDLocation,
+ * so per-draw data can be fetched without a uniform change per draw. All instances of
+ * a draw read the same id, gl_InstanceID numbers them within the draw.
+ */
+class IndirectDrawList
+{
+public:
+	static const unsigned int DrawIDLocation = 7;
+
+	// Consecutive commands that use the same MeshPool page
+	struct PageRange
+	{
+		unsigned int Page;
+		unsigned int First;
+		unsigned int Count;
+	};
+
+private:
+	std::vector<DrawElementsIndirectCommand> m_Commands;
+	std::vector<unsigned int> m_Pages;
+
+	// Commands grouped by page, in the order they are stored in the indirect buffer
+	std::vector<DrawElementsIndirectCommand> m_Sorted;
+	std::vector<unsigned int> m_SortedDrawIDs;
+	std::vector<PageRange> m_Ranges;
+
+	// Draw id of every instance, each command's BaseInstance points at its own run
+	std::vector<unsigned int> m_InstanceDrawIDs;
+
+	unsigned int m_IndirectBufferID;
+	unsigned int m_DrawIDBufferID;
+	unsigned int m_DrawIDCapacity;
+
+	bool m_MultiDrawIndirect;
+	bool m_Dirty;
+
+public:
+	IndirectDrawList(unsigned int capacity = 1024);
+
+	~IndirectDrawList();
+
+	// Returns the draw id, which is also the index of the draw in the list
+	unsigned int Add(const MeshAllocation& mesh, unsigned int instanceCount = 1);
+
+	void Clear();
+
+	// Groups the commands by page and uploads them, called by Renderer before submission
+	void Upload();
+
+	/* Enables a_DrawID on the bound vertex array, UnbindDrawIDs restores it
+	 * because the vertex array is shared with other draws */
+	void BindDrawIDs() const;
+
+	void UnbindDrawIDs() const;
+
+	inline unsigned int GetCount() const { return (unsigned int)m_Commands.size(); }
+
+	inline const std::vector<DrawElementsIndirectCommand>& GetCommands() const { return m_Sorted; }
+
+	// Draw id of every command in GetCommands
+	inline const std::vector<unsigned int>& GetDrawIDs() const { return m_SortedDrawIDs; }
+
+	inline const std::vector<PageRange>& GetRanges() const { return m_Ranges; }
+
+	inline unsigned int GetIndirectBufferID() const { return m_IndirectBufferID; }
+
+	/* GL 4.3 or ARB_multi_draw_indirect + ARB_base_instance, otherwise Renderer
+	 * loops over glDrawElementsBaseVertex */
+	inline bool IsMultiDrawIndirectSupported() const { return m_MultiDrawIndirect; }
+};
@@ -0,0 +1,360 @@
+#include "JobSystem.h"
+#include "Renderer.h"
+#include "FixedPool.h"
+#include "Profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+const unsigned int Job::StorageSize;
+const long long JobDeque::Capacity;
+const unsigned int JobSystem::InvalidWorker;
+const unsigned int JobSystem::JobPoolSize;
+
+static_assert(sizeof(Job) == 64, "Job should fill exactly one cache line");
+
+JobSystem* JobSystem::s_Instance = nullptr;
+
+static thread_local unsigned int t_WorkerIndex = JobSystem::InvalidWorker;
+static thread_local unsigned int t_Random = 0;
+
+/* Failed attempts to find work before a worker goes to sleep */
+static const unsigned int SpinCount = 64;
+
+JobDeque::JobDeque()
+    : m_Top(0), m_Bottom(0)
+{
+    for (auto& slot : m_Buffer)
+        slot.store(nullptr, std::memory_order_relaxed);
+}
+
+bool JobDeque::Push(Job* job)
+{
+    long long bottom = m_Bottom.load(std::memory_order_relaxed);
+    long long top = m_Top.load(std::memory_order_acquire);
+    if (bottom - top >= Capacity)
+        return false;
+
+    m_Buffer[bottom & (Capacity - 1)].store(job, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+    return true;
+}
+
+Job* JobDeque::Pop()
+{
+    long long bottom = m_Bottom.load(std::memory_order_relaxed) - 1;
+    m_Bottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    long long top = m_Top.load(std::memory_order_relaxed);
+
+    if (top > bottom)
+    {
+        m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    Job* job = m_Buffer[bottom & (Capacity - 1)].load(std::memory_order_relaxed);
+    if (top == bottom)
+    {
+        /* Last job, race the thieves for it */
+        if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            job = nullptr;
+        m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return job;
+}
+
+Job* JobDeque::Steal()
+{
+    long long top = m_Top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    long long bottom = m_Bottom.load(std::memory_order_acquire);
+    if (top >= bottom)
+        return nullptr;
+
+    Job* job = m_Buffer[top & (Capacity - 1)].load(std::memory_order_relaxed);
+    if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        return nullptr;
+    return job;
+}
+
+static void PinThread(
+#ifdef _WIN32
+    HANDLE thread,
+#else
+    pthread_t thread,
+#endif
+    unsigned int core)
+{
+#ifdef _WIN32
+    SetThreadAffinityMask(thread, (DWORD_PTR)1 << core);
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    pthread_setaffinity_np(thread, sizeof(set), &set);
+#else
+    (void)thread;
+    (void)core;
+#endif
+}
+
+JobSystem::JobSystem(unsigned int workerCount, bool pinThreads)
+    : m_Running(true), m_InjectedCount(0), m_Sleepers(0)
+{
+    ASSERT(s_Instance == nullptr);
+    s_Instance = this;
+
+    if (workerCount == 0)
+        workerCount = std::max(std::thread::hardware_concurrency(), 1u);
+
+    for (unsigned int i = 0; i < workerCount; ++i)
+    {
+        m_Workers.emplace_back(new Worker());
+        m_Workers.back()->Jobs.reset(new Job[JobPoolSize]());
+        m_Workers.back()->NextJob = 0;
+    }
+
+    t_WorkerIndex = 0;
+    if (pinThreads)
+    {
+#ifdef _WIN32
+        PinThread(GetCurrentThread(), 0);
+#else
+        PinThread(pthread_self(), 0);
+#endif
+    }
+
+    for (unsigned int i = 1; i < workerCount; ++i)
+    {
+        m_Threads.emplace_back(&JobSystem::WorkerLoop, this, i);
+        if (pinThreads)
+            PinThread(m_Threads.back().native_handle(), i);
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    m_Running = false;
+    {
+        std::lock_guard<std::mutex> lock(m_SleepMutex);
+        m_WakeUp.notify_all();
+    }
+    for (auto& thread : m_Threads)
+        thread.join();
+
+    /* Main thread work that never got a chance to run */
+    RunMainThreadJobs();
+
+    t_WorkerIndex = InvalidWorker;
+    s_Instance = nullptr;
+}
+
+unsigned int JobSystem::GetWorkerIndex()
+{
+    return t_WorkerIndex;
+}
+
+/* Every worker recycles its own ring of jobs, other threads take them from a pool */
+Job* JobSystem::AllocateJob()
+{
+    unsigned int index = t_WorkerIndex;
+    if (index == InvalidWorker || index >= m_Workers.size())
+    {
+        Job* job = FixedPool<Job>::New();
+        job->HeapAllocated = true;
+        return job;
+    }
+
+    Worker& worker = *m_Workers[index];
+    Job* job = &worker.Jobs[worker.NextJob++ & (JobPoolSize - 1)];
+    if (job->InUse.load(std::memory_order_acquire))
+    {
+        /* More than JobPoolSize jobs in flight, this slot is still queued or running */
+        job = FixedPool<Job>::New();
+        job->HeapAllocated = true;
+        return job;
+    }
+    job->InUse.store(true, std::memory_order_relaxed);
+    job->HeapAllocated = false;
+    return job;
+}
+
+void JobSystem::Push(Job* job)
+{
+    unsigned int index = t_WorkerIndex;
+    if (index < m_Workers.size())
+    {
+        if (!m_Workers[index]->Deque.Push(job))
+        {
+            /* Deque full, doing the work right away is still correct */
+            Execute(job);
+            return;
+        }
+    }
+    else
+    {
+        std::lock_guard<std::mutex> lock(m_InjectedMutex);
+        m_Injected.push_back(job);
+        m_InjectedCount.fetch_add(1, std::memory_order_release);
+    }
+
+    if (m_Sleepers.load(std::memory_order_acquire) > 0)
+        m_WakeUp.notify_one();
+}
+
+Job* JobSystem::GetJob(unsigned int index)
+{
+    const unsigned int count = (unsigned int)m_Workers.size();
+    if (index < count)
+    {
+        if (Job* job = m_Workers[index]->Deque.Pop())
+            return job;
+    }
+
+    if (m_InjectedCount.load(std::memory_order_acquire) > 0)
+    {
+        std::lock_guard<std::mutex> lock(m_InjectedMutex);
+        if (!m_Injected.empty())
+        {
+            Job* job = m_Injected.front();
+            m_Injected.pop_front();
+            m_InjectedCount.fetch_sub(1, std::memory_order_relaxed);
+            return job;
+        }
+    }
+
+    /* Start stealing at a random victim so thieves spread out */
+    if (t_Random == 0)
+        t_Random = 0x9E3779B9u * (index + 2);
+    t_Random ^= t_Random << 13;
+    t_Random ^= t_Random >> 17;
+    t_Random ^= t_Random << 5;
+    unsigned int start = t_Random % count;
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        unsigned int victim = (start + i) % count;
+        if (victim == index)
+            continue;
+        if (Job* job = m_Workers[victim]->Deque.Steal())
+            return job;
+    }
+    return nullptr;
+}
+
+Job* JobSystem::PopMainThreadJob()
+{
+    std::lock_guard<std::mutex> lock(m_MainThreadMutex);
+    if (m_MainThreadJobs.empty())
+        return nullptr;
+    Job* job = m_MainThreadJobs.front();
+    m_MainThreadJobs.pop_front();
+    return job;
+}
+
+void JobSystem::Execute(Job* job)
+{
+    job->Invoke(*job);
+    JobCounter* counter = job->Counter;
+    if (job->HeapAllocated)
+        FixedPool<Job>::Delete(job);
+    else
+        job->InUse.store(false, std::memory_order_release);
+    if (counter)
+        Finish(*counter);
+}
+
+void JobSystem::Finish(JobCounter& counter)
+{
+    /* Decrements that can't be the last one need no lock */
+    unsigned int value = counter.m_Value.load(std::memory_order_relaxed);
+    while (value > 1)
+    {
+        if (counter.m_Value.compare_exchange_weak(value, value - 1, std::memory_order_acq_rel, std::memory_order_relaxed))
+            return;
+    }
+
+    /* Possibly the last one: zero only becomes visible under the lock, so a Wait that
+     * sees it also waits for us to let go of the counter before its owner destroys it */
+    std::vector<Job*> continuations;
+    {
+        std::lock_guard<std::mutex> lock(counter.m_Mutex);
+        if (counter.m_Value.fetch_sub(1, std::memory_order_acq_rel) != 1)
+            return;
+
+        /* Last job of the counter, release everything that waited for it */
+        continuations.swap(counter.m_Continuations);
+    }
+    for (Job* job : continuations)
+        Push(job);
+}
+
+void JobSystem::RunMainThreadJobs()
+{
+    ASSERT(t_WorkerIndex == 0);
+    while (Job* job = PopMainThreadJob())
+        Execute(job);
+}
+
+void JobSystem::Wait(JobCounter& counter)
+{
+    const unsigned int index = t_WorkerIndex;
+    while (!counter.IsDone())
+    {
+        Job* job = index == 0 ? PopMainThreadJob() : nullptr;
+        if (!job)
+            job = GetJob(index);
+
+        if (job)
+            Execute(job);
+        else
+            std::this_thread::yield();
+    }
+
+    /* The job that reached zero may still hold the lock */
+    std::lock_guard<std::mutex> lock(counter.m_Mutex);
+}
+
+void JobSystem::WorkerLoop(unsigned int index)
+{
+    t_WorkerIndex = index;
+
+    char name[32];
+    std::snprintf(name, sizeof(name), "Worker %u", index);
+    Profiler::SetThreadName(name);
+
+    unsigned int idle = 0;
+    while (m_Running.load(std::memory_order_relaxed))
+    {
+        if (Job* job = GetJob(index))
+        {
+            Execute(job);
+            idle = 0;
+            continue;
+        }
+
+        if (++idle < SpinCount)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        /* The timeout covers a wake-up that raced with going to sleep */
+        std::unique_lock<std::mutex> lock(m_SleepMutex);
+        m_Sleepers.fetch_add(1, std::memory_order_acq_rel);
+        m_WakeUp.wait_for(lock, std::chrono::milliseconds(1));
+        m_Sleepers.fetch_sub(1, std::memory_order_acq_rel);
+        idle = 0;
+    }
+}
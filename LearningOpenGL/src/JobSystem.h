@@ -0,0 +1,230 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+class JobSystem;
+
+/* A job with its callable stored inline, exactly one cache line */
+struct Job
+{
+	static const unsigned int StorageSize = 40;
+
+	void (*Invoke)(Job& job);
+	class JobCounter* Counter;
+	bool HeapAllocated;
+	std::atomic<bool> InUse;  // ring jobs only, cleared once the job has run
+	alignas(8) unsigned char Storage[StorageSize];
+};
+
+/* Counts unfinished jobs. Jobs submitted with a counter increment it and decrement it
+ * when done; jobs can also be made to wait for a counter to reach zero. */
+class JobCounter
+{
+private:
+	friend class JobSystem;
+
+	std::atomic<unsigned int> m_Value;
+	std::mutex m_Mutex;
+	std::vector<Job*> m_Continuations;
+
+public:
+	JobCounter() : m_Value(0) {}
+
+	JobCounter(const JobCounter&) = delete;
+	JobCounter& operator=(const JobCounter&) = delete;
+
+	/* A counter that is done may still be in use by the job that finished it, only
+	 * destroy it after JobSystem::Wait has returned */
+	inline bool IsDone() const { return m_Value.load(std::memory_order_acquire) == 0; }
+};
+
+/* Chase-Lev work-stealing deque (Le et al. 2013 memory orderings). The owner pushes and
+ * pops at the bottom, every other thread steals from the top. */
+class JobDeque
+{
+public:
+	static const long long Capacity = 4096;
+
+private:
+	std::atomic<long long> m_Top;
+	std::atomic<long long> m_Bottom;
+	std::atomic<Job*> m_Buffer[Capacity];
+
+public:
+	JobDeque();
+
+	// Owner only, false when full
+	bool Push(Job* job);
+
+	// Owner only
+	Job* Pop();
+
+	Job* Steal();
+};
+
+/* Work-stealing scheduler. The thread that creates it becomes worker 0 and joins in
+ * whenever it waits; work tied to that thread (window events, anything
+ * touching the GLFW window) goes to a separate queue only it runs.
+ *
+ *   JobCounter counter;
+ *   jobs.Submit([&]() { ... }, &counter);
+ *   jobs.SubmitAfter(counter, [&]() { ... });   // continuation
+ *   jobs.Wait(counter);                         // runs other jobs meanwhile
+ */
+class JobSystem
+{
+public:
+	static const unsigned int InvalidWorker = 0xffffffff;
+	static const unsigned int JobPoolSize = 4096;
+
+private:
+	struct Worker
+	{
+		JobDeque Deque;
+		std::unique_ptr<Job[]> Jobs;
+		unsigned int NextJob;
+	};
+
+	/* Jobs come from a per-worker ring, a slot still in flight when the ring wraps
+	 * around is skipped in favour of a pooled job */
+	std::vector<std::unique_ptr<Worker>> m_Workers;
+	std::vector<std::thread> m_Threads;
+	std::atomic<bool> m_Running;
+
+	// Jobs submitted from threads that are not workers
+	std::mutex m_InjectedMutex;
+	std::deque<Job*> m_Injected;
+	std::atomic<unsigned int> m_InjectedCount;
+
+	std::mutex m_MainThreadMutex;
+	std::deque<Job*> m_MainThreadJobs;
+
+	std::mutex m_SleepMutex;
+	std::condition_variable m_WakeUp;
+	std::atomic<unsigned int> m_Sleepers;
+
+	static JobSystem* s_Instance;
+
+	Job* AllocateJob();
+	void Push(Job* job);
+	// Any thread, worker is InvalidWorker for threads outside the pool
+	Job* GetJob(unsigned int worker);
+	Job* PopMainThreadJob();
+	void Execute(Job* job);
+	void Finish(JobCounter& counter);
+	void WorkerLoop(unsigned int worker);
+
+	template<typename Function>
+	Job* CreateJob(Function&& function, JobCounter* counter)
+	{
+		typedef typename std::decay<Function>::type Callable;
+		static_assert(sizeof(Callable) <= Job::StorageSize, "Job callable is too large, capture by reference");
+
+		Job* job = AllocateJob();
+		new (job->Storage) Callable(std::forward<Function>(function));
+		job->Invoke = [](Job& self)
+		{
+			Callable& callable = *(Callable*)self.Storage;
+			callable();
+			callable.~Callable();
+		};
+		job->Counter = counter;
+		if (counter)
+			counter->m_Value.fetch_add(1, std::memory_order_relaxed);
+		return job;
+	}
+
+public:
+	/* workerCount 0 means one worker per hardware thread, the calling thread included.
+	 * With pinThreads worker i only runs on core i. */
+	JobSystem(unsigned int workerCount = 0, bool pinThreads = false);
+
+	~JobSystem();
+
+	JobSystem(const JobSystem&) = delete;
+	JobSystem& operator=(const JobSystem&) = delete;
+
+	template<typename Function>
+	void Submit(Function&& function, JobCounter* counter = nullptr)
+	{
+		Push(CreateJob(std::forward<Function>(function), counter));
+	}
+
+	/* Runs once dependency reaches zero, without blocking any thread in between */
+	template<typename Function>
+	void SubmitAfter(JobCounter& dependency, Function&& function, JobCounter* counter = nullptr)
+	{
+		Job* job = CreateJob(std::forward<Function>(function), counter);
+		{
+			std::lock_guard<std::mutex> lock(dependency.m_Mutex);
+			if (!dependency.IsDone())
+			{
+				dependency.m_Continuations.push_back(job);
+				return;
+			}
+		}
+		Push(job);
+	}
+
+	/* Runs on the thread that created the JobSystem, inside Wait or RunMainThreadJobs */
+	template<typename Function>
+	void SubmitMainThread(Function&& function, JobCounter* counter = nullptr)
+	{
+		Job* job = CreateJob(std::forward<Function>(function), counter);
+		std::lock_guard<std::mutex> lock(m_MainThreadMutex);
+		m_MainThreadJobs.push_back(job);
+	}
+
+	void RunMainThreadJobs();
+
+	/* Helps with other jobs until counter reaches zero */
+	void Wait(JobCounter& counter);
+
+	/* function(begin, end) over [0, count) in batches, returns when all are done */
+	template<typename Function>
+	void ParallelFor(unsigned int count, unsigned int batchSize, const Function& function)
+	{
+		if (count == 0)
+			return;
+		batchSize = batchSize ? batchSize : 1;
+		const unsigned int batches = (count + batchSize - 1) / batchSize;
+		if (batches == 1)
+		{
+			function(0u, count);
+			return;
+		}
+
+		/* One job per worker at most, each keeps taking batches until none are left */
+		std::atomic<unsigned int> next(0);
+		auto worker = [&next, &function, batches, batchSize, count]()
+		{
+			for (unsigned int batch = next++; batch < batches; batch = next++)
+			{
+				unsigned int begin = batch * batchSize;
+				function(begin, begin + batchSize < count ? begin + batchSize : count);
+			}
+		};
+
+		JobCounter counter;
+		unsigned int jobs = GetWorkerCount() < batches ? GetWorkerCount() : batches;
+		for (unsigned int i = 1; i < jobs; ++i)
+			Submit([&worker]() { worker(); }, &counter);
+		worker();
+		Wait(counter);
+	}
+
+	inline unsigned int GetWorkerCount() const { return (unsigned int)m_Workers.size(); }
+
+	/* Index of the calling worker thread, InvalidWorker for other threads */
+	static unsigned int GetWorkerIndex();
+
+	static inline JobSystem* Get() { return s_Instance; }
+};
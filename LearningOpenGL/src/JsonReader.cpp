@@ -0,0 +1,468 @@
+#include "JsonReader.h"
+
+#include <cstdlib>
+#include <cstring>
+
+const unsigned int JsonDocument::InvalidIndex;
+
+namespace {
+
+struct JsonParser
+{
+    const char* Cursor;
+    const char* End;
+    JsonHandler& Handler;
+    std::string Scratch;
+    const char* Error;
+
+    JsonParser(const char* data, size_t size, JsonHandler& handler)
+        : Cursor(data), End(data + size), Handler(handler), Error(nullptr)
+    {}
+
+    bool Fail(const char* message)
+    {
+        if (!Error)
+            Error = message;
+        return false;
+    }
+
+    void SkipWhitespace()
+    {
+        while (Cursor < End && (*Cursor == ' ' || *Cursor == '\n' || *Cursor == '\r' || *Cursor == '\t'))
+            ++Cursor;
+    }
+
+    bool Match(const char* literal)
+    {
+        size_t length = strlen(literal);
+        if ((size_t)(End - Cursor) < length || memcmp(Cursor, literal, length) != 0)
+            return false;
+        Cursor += length;
+        return true;
+    }
+
+    static void AppendUtf8(std::string& out, unsigned int codepoint)
+    {
+        if (codepoint < 0x80)
+        {
+            out += (char)codepoint;
+        }
+        else if (codepoint < 0x800)
+        {
+            out += (char)(0xC0 | (codepoint >> 6));
+            out += (char)(0x80 | (codepoint & 0x3F));
+        }
+        else if (codepoint < 0x10000)
+        {
+            out += (char)(0xE0 | (codepoint >> 12));
+            out += (char)(0x80 | ((codepoint >> 6) & 0x3F));
+            out += (char)(0x80 | (codepoint & 0x3F));
+        }
+        else
+        {
+            out += (char)(0xF0 | (codepoint >> 18));
+            out += (char)(0x80 | ((codepoint >> 12) & 0x3F));
+            out += (char)(0x80 | ((codepoint >> 6) & 0x3F));
+            out += (char)(0x80 | (codepoint & 0x3F));
+        }
+    }
+
+    bool ParseHex4(unsigned int& value)
+    {
+        if (End - Cursor < 4)
+            return false;
+        value = 0;
+        for (int i = 0; i < 4; ++i)
+        {
+            char c = *Cursor++;
+            value <<= 4;
+            if (c >= '0' && c <= '9') value |= c - '0';
+            else if (c >= 'a' && c <= 'f') value |= c - 'a' + 10;
+            else if (c >= 'A' && c <= 'F') value |= c - 'A' + 10;
+            else return false;
+        }
+        return true;
+    }
+
+    /* Strings without escapes (nearly all of them in glTF) are reported
+     * straight from the input, the rest are unescaped into Scratch. */
+    bool ParseString(bool isKey)
+    {
+        ++Cursor;   // opening quote
+        const char* start = Cursor;
+        while (Cursor < End && *Cursor != '"' && *Cursor != '\\')
+            ++Cursor;
+        if (Cursor >= End)
+            return Fail("unterminated string");
+
+        if (*Cursor == '"')
+        {
+            unsigned int length = (unsigned int)(Cursor - start);
+            ++Cursor;
+            return isKey ? Handler.Key(start, length) : Handler.String(start, length);
+        }
+
+        Scratch.assign(start, Cursor);
+        while (Cursor < End && *Cursor != '"')
+        {
+            char c = *Cursor++;
+            if (c != '\\')
+            {
+                Scratch += c;
+                continue;
+            }
+            if (Cursor >= End)
+                return Fail("unterminated string");
+
+            char escape = *Cursor++;
+            switch (escape)
+            {
+            case '"':  Scratch += '"'; break;
+            case '\\': Scratch += '\\'; break;
+            case '/':  Scratch += '/'; break;
+            case 'b':  Scratch += '\b'; break;
+            case 'f':  Scratch += '\f'; break;
+            case 'n':  Scratch += '\n'; break;
+            case 'r':  Scratch += '\r'; break;
+            case 't':  Scratch += '\t'; break;
+            case 'u':
+            {
+                unsigned int codepoint;
+                if (!ParseHex4(codepoint))
+                    return Fail("invalid unicode escape");
+                /* Surrogates only come in pairs, high then low */
+                if (codepoint >= 0xDC00 && codepoint <= 0xDFFF)
+                    return Fail("unpaired surrogate");
+                if (codepoint >= 0xD800 && codepoint <= 0xDBFF)
+                {
+                    unsigned int low;
+                    if (!Match("\\u") || !ParseHex4(low) || low < 0xDC00 || low > 0xDFFF)
+                        return Fail("unpaired surrogate");
+                    codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+                }
+                AppendUtf8(Scratch, codepoint);
+                break;
+            }
+            default:
+                return Fail("invalid escape sequence");
+            }
+        }
+        if (Cursor >= End)
+            return Fail("unterminated string");
+        ++Cursor;
+
+        return isKey ? Handler.Key(Scratch.data(), (unsigned int)Scratch.size())
+                     : Handler.String(Scratch.data(), (unsigned int)Scratch.size());
+    }
+
+    bool ParseNumber()
+    {
+        /* Fast path for plain integers, which are most numbers in a glTF file */
+        const char* start = Cursor;
+        bool negative = false;
+        if (*Cursor == '-')
+        {
+            negative = true;
+            ++Cursor;
+        }
+
+        unsigned long long integer = 0;
+        int digits = 0;
+        while (Cursor < End && *Cursor >= '0' && *Cursor <= '9' && digits < 18)
+        {
+            integer = integer * 10 + (*Cursor++ - '0');
+            ++digits;
+        }
+        if (digits == 0)
+            return Fail("invalid number");
+
+        if (Cursor >= End || (*Cursor != '.' && *Cursor != 'e' && *Cursor != 'E' && (*Cursor < '0' || *Cursor > '9')))
+            return Handler.Number(negative ? -(double)integer : (double)integer);
+
+        /* The input is not null terminated (it may be a file mapping), so copy
+         * the number out before handing it to strtod */
+        const char* last = Cursor;
+        while (last < End && ((*last >= '0' && *last <= '9') || *last == '.' || *last == 'e' || *last == 'E' || *last == '+' || *last == '-'))
+            ++last;
+        char buffer[64];
+        size_t length = (size_t)(last - start);
+        if (length >= sizeof(buffer))
+            return Fail("invalid number");
+        memcpy(buffer, start, length);
+        buffer[length] = '\0';
+
+        char* end = nullptr;
+        double value = strtod(buffer, &end);
+        if (end != buffer + length)
+            return Fail("invalid number");
+        Cursor = last;
+        return Handler.Number(value);
+    }
+
+    bool ParseValue(int depth)
+    {
+        if (depth > 512)
+            return Fail("nesting too deep");
+
+        SkipWhitespace();
+        if (Cursor >= End)
+            return Fail("unexpected end of input");
+
+        switch (*Cursor)
+        {
+        case '{':
+        {
+            ++Cursor;
+            if (!Handler.StartObject())
+                return false;
+            SkipWhitespace();
+            if (Cursor < End && *Cursor == '}')
+            {
+                ++Cursor;
+                return Handler.EndObject();
+            }
+            while (true)
+            {
+                SkipWhitespace();
+                if (Cursor >= End || *Cursor != '"')
+                    return Fail("expected object key");
+                if (!ParseString(true))
+                    return false;
+                SkipWhitespace();
+                if (Cursor >= End || *Cursor != ':')
+                    return Fail("expected ':'");
+                ++Cursor;
+                if (!ParseValue(depth + 1))
+                    return false;
+                SkipWhitespace();
+                if (Cursor < End && *Cursor == ',')
+                {
+                    ++Cursor;
+                    continue;
+                }
+                if (Cursor < End && *Cursor == '}')
+                {
+                    ++Cursor;
+                    return Handler.EndObject();
+                }
+                return Fail("expected ',' or '}'");
+            }
+        }
+        case '[':
+        {
+            ++Cursor;
+            if (!Handler.StartArray())
+                return false;
+            SkipWhitespace();
+            if (Cursor < End && *Cursor == ']')
+            {
+                ++Cursor;
+                return Handler.EndArray();
+            }
+            while (true)
+            {
+                if (!ParseValue(depth + 1))
+                    return false;
+                SkipWhitespace();
+                if (Cursor < End && *Cursor == ',')
+                {
+                    ++Cursor;
+                    continue;
+                }
+                if (Cursor < End && *Cursor == ']')
+                {
+                    ++Cursor;
+                    return Handler.EndArray();
+                }
+                return Fail("expected ',' or ']'");
+            }
+        }
+        case '"':
+            return ParseString(false);
+        case 't':
+            return Match("true") ? Handler.Bool(true) : Fail("invalid literal");
+        case 'f':
+            return Match("false") ? Handler.Bool(false) : Fail("invalid literal");
+        case 'n':
+            return Match("null") ? Handler.Null() : Fail("invalid literal");
+        default:
+            return ParseNumber();
+        }
+    }
+};
+
+}
+
+bool JsonReader::Parse(const char* data, size_t size, JsonHandler& handler, std::string* error)
+{
+    JsonParser parser(data, size, handler);
+    bool result = parser.ParseValue(0);
+    if (result)
+    {
+        parser.SkipWhitespace();
+        if (parser.Cursor != parser.End)
+            result = parser.Fail("trailing characters");
+    }
+
+    if (!result && error)
+    {
+        *error = parser.Error ? parser.Error : "aborted by handler";
+        *error += " at offset " + std::to_string(parser.Cursor - data);
+    }
+    return result;
+}
+
+/* JsonDocument */
+
+bool JsonDocument::Parse(const char* data, size_t size, std::string* error)
+{
+    m_Values.clear();
+    m_Strings.clear();
+    m_Stack.clear();
+    m_LastChild.clear();
+    m_PendingKeyOffset = m_PendingKeyLength = 0;
+
+    /* Rough guess to avoid most reallocations */
+    m_Values.reserve(size / 16 + 16);
+
+    return JsonReader::Parse(data, size, *this, error);
+}
+
+unsigned int JsonDocument::AddValue(JsonType type)
+{
+    unsigned int index = (unsigned int)m_Values.size();
+
+    JsonValue value = {};
+    value.Type = type;
+    value.FirstChild = InvalidIndex;
+    value.NextSibling = InvalidIndex;
+    value.KeyOffset = m_PendingKeyOffset;
+    value.KeyLength = m_PendingKeyLength;
+    m_Values.push_back(value);
+    m_PendingKeyOffset = m_PendingKeyLength = 0;
+
+    if (!m_Stack.empty())
+    {
+        JsonValue& parent = m_Values[m_Stack.back()];
+        if (m_LastChild.back() == InvalidIndex)
+            parent.FirstChild = index;
+        else
+            m_Values[m_LastChild.back()].NextSibling = index;
+        m_LastChild.back() = index;
+        ++parent.ChildCount;
+    }
+    return index;
+}
+
+bool JsonDocument::Null()
+{
+    AddValue(JsonType::Null);
+    return true;
+}
+
+bool JsonDocument::Bool(bool value)
+{
+    m_Values[AddValue(JsonType::Bool)].Boolean = value;
+    return true;
+}
+
+bool JsonDocument::Number(double value)
+{
+    m_Values[AddValue(JsonType::Number)].Number = value;
+    return true;
+}
+
+bool JsonDocument::String(const char* str, unsigned int length)
+{
+    JsonValue& value = m_Values[AddValue(JsonType::String)];
+    value.StringOffset = (unsigned int)m_Strings.size();
+    value.StringLength = length;
+    m_Strings.append(str, length);
+    return true;
+}
+
+bool JsonDocument::Key(const char* str, unsigned int length)
+{
+    m_PendingKeyOffset = (unsigned int)m_Strings.size();
+    m_PendingKeyLength = length;
+    m_Strings.append(str, length);
+    return true;
+}
+
+bool JsonDocument::StartObject()
+{
+    m_Stack.push_back(AddValue(JsonType::Object));
+    m_LastChild.push_back(InvalidIndex);
+    return true;
+}
+
+bool JsonDocument::EndObject()
+{
+    m_Stack.pop_back();
+    m_LastChild.pop_back();
+    return true;
+}
+
+bool JsonDocument::StartArray()
+{
+    m_Stack.push_back(AddValue(JsonType::Array));
+    m_LastChild.push_back(InvalidIndex);
+    return true;
+}
+
+bool JsonDocument::EndArray()
+{
+    return EndObject();
+}
+
+unsigned int JsonDocument::Find(unsigned int object, const char* key) const
+{
+    if (object == InvalidIndex || m_Values[object].Type != JsonType::Object)
+        return InvalidIndex;
+
+    size_t length = strlen(key);
+    for (unsigned int child = m_Values[object].FirstChild; child != InvalidIndex; child = m_Values[child].NextSibling)
+    {
+        const JsonValue& value = m_Values[child];
+        if (value.KeyLength == length && m_Strings.compare(value.KeyOffset, length, key) == 0)
+            return child;
+    }
+    return InvalidIndex;
+}
+
+std::vector<unsigned int> JsonDocument::GetChildren(unsigned int container) const
+{
+    std::vector<unsigned int> children;
+    if (container == InvalidIndex)
+        return children;
+
+    children.reserve(m_Values[container].ChildCount);
+    for (unsigned int child = m_Values[container].FirstChild; child != InvalidIndex; child = m_Values[child].NextSibling)
+        children.push_back(child);
+    return children;
+}
+
+std::string JsonDocument::GetString(unsigned int index) const
+{
+    if (index == InvalidIndex || m_Values[index].Type != JsonType::String)
+        return std::string();
+    return m_Strings.substr(m_Values[index].StringOffset, m_Values[index].StringLength);
+}
+
+double JsonDocument::GetNumber(unsigned int object, const char* key, double fallback) const
+{
+    unsigned int index = Find(object, key);
+    return index != InvalidIndex && m_Values[index].Type == JsonType::Number ? m_Values[index].Number : fallback;
+}
+
+std::string JsonDocument::GetString(unsigned int object, const char* key, const std::string& fallback) const
+{
+    unsigned int index = Find(object, key);
+    return index != InvalidIndex && m_Values[index].Type == JsonType::String ? GetString(index) : fallback;
+}
+
+bool JsonDocument::GetBool(unsigned int object, const char* key, bool fallback) const
+{
+    unsigned int index = Find(object, key);
+    return index != InvalidIndex && m_Values[index].Type == JsonType::Bool ? m_Values[index].Boolean : fallback;
+}
@@ -0,0 +1,130 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
+/* SAX-style JSON parser: walks the text once and reports events to a handler,
+ * without building any tree itself. Returning false from a callback stops parsing.
+ */
+class JsonHandler
+{
+public:
+	virtual ~JsonHandler() {}
+
+	virtual bool Null() = 0;
+	virtual bool Bool(bool value) = 0;
+	virtual bool Number(double value) = 0;
+	virtual bool String(const char* str, unsigned int length) = 0;
+	virtual bool Key(const char* str, unsigned int length) = 0;
+	virtual bool StartObject() = 0;
+	virtual bool EndObject() = 0;
+	virtual bool StartArray() = 0;
+	virtual bool EndArray() = 0;
+};
+
+class JsonReader
+{
+public:
+	static bool Parse(const char* data, size_t size, JsonHandler& handler, std::string* error = nullptr);
+};
+
+enum class JsonType : unsigned char
+{
+	Null, Bool, Number, String, Array, Object
+};
+
+struct JsonValue
+{
+	JsonType Type;
+	bool Boolean;
+	double Number;
+
+	// String value, or the key when this value is an object member
+	unsigned int StringOffset, StringLength;
+	unsigned int KeyOffset, KeyLength;
+
+	unsigned int FirstChild;
+	unsigned int NextSibling;
+	unsigned int ChildCount;
+};
+
+/* Compact read-only tree built from the SAX events. Values live in one flat array
+ * and refer to each other by index, strings live in one shared pool.
+ */
+class JsonDocument : public JsonHandler
+{
+public:
+	static const unsigned int InvalidIndex = 0xffffffff;
+
+private:
+	std::vector<JsonValue> m_Values;
+	std::string m_Strings;
+
+	// Open containers and the last child added to each of them
+	std::vector<unsigned int> m_Stack;
+	std::vector<unsigned int> m_LastChild;
+
+	unsigned int m_PendingKeyOffset, m_PendingKeyLength;
+
+	unsigned int AddValue(JsonType type);
+
+public:
+	bool Parse(const char* data, size_t size, std::string* error = nullptr);
+
+	inline unsigned int GetRoot() const { return m_Values.empty() ? InvalidIndex : 0; }
+
+	inline const JsonValue& Get(unsigned int index) const { return m_Values[index]; }
+
+	// Member of an object, or InvalidIndex
+	unsigned int Find(unsigned int object, const char* key) const;
+
+	// Indices of every element of an array (or member of an object)
+	std::vector<unsigned int> GetChildren(unsigned int container) const;
+
+	std::string GetString(unsigned int index) const;
+
+	double GetNumber(unsigned int object, const char* key, double fallback) const;
+
+	/* Non-negative integer such as an index or a byte count. Fails for negative,
+	 * fractional or non-number values and for numbers T can not hold, casting those
+	 * straight from the double would be undefined */
+	template<typename T>
+	bool GetInteger(unsigned int index, T& value) const
+	{
+		if (index == InvalidIndex || m_Values[index].Type != JsonType::Number)
+			return false;
+
+		/* Doubles skip integers above 2^53 */
+		const double max = std::min((double)std::numeric_limits<T>::max(), 9007199254740992.0);
+		const double number = m_Values[index].Number;
+		if (!(number >= 0.0 && number <= max) || number != std::floor(number))
+			return false;
+		value = (T)number;
+		return true;
+	}
+
+	/* Same for a member, value is left alone when the member is missing */
+	template<typename T>
+	bool GetInteger(unsigned int object, const char* key, T& value) const
+	{
+		unsigned int index = Find(object, key);
+		return index == InvalidIndex || GetInteger(index, value);
+	}
+
+	std::string GetString(unsigned int object, const char* key, const std::string& fallback = "") const;
+
+	bool GetBool(unsigned int object, const char* key, bool fallback) const;
+
+	/* JsonHandler */
+	bool Null() override;
+	bool Bool(bool value) override;
+	bool Number(double value) override;
+	bool String(const char* str, unsigned int length) override;
+	bool Key(const char* str, unsigned int length) override;
+	bool StartObject() override;
+	bool EndObject() override;
+	bool StartArray() override;
+	bool EndArray() override;
+};
@@ -0,0 +1,65 @@
+#include "LinearAllocator.h"
+#include "Renderer.h"
+
+#include <cstdlib>
+
+const size_t LinearAllocator::DefaultBlockSize;
+
+LinearAllocator::LinearAllocator(size_t blockSize)
+    : m_Block(0), m_Offset(0), m_BlockSize(blockSize), m_Used(0)
+{
+}
+
+LinearAllocator::~LinearAllocator()
+{
+    for (auto& block : m_Blocks)
+        free(block.Data);
+}
+
+void* LinearAllocator::Allocate(size_t size, size_t alignment)
+{
+    ASSERT(alignment && (alignment & (alignment - 1)) == 0);
+
+    while (m_Block < m_Blocks.size())
+    {
+        Block& block = m_Blocks[m_Block];
+        size_t address = (size_t)(block.Data + m_Offset);
+        size_t aligned = (address + alignment - 1) & ~(alignment - 1);
+        size_t end = aligned - (size_t)block.Data + size;
+        if (end <= block.Size)
+        {
+            m_Used += end - m_Offset;
+            m_Offset = end;
+            return (void*)aligned;
+        }
+
+        /* Move on to the next block, the tail of this one stays unused until Reset */
+        ++m_Block;
+        m_Offset = 0;
+    }
+
+    /* Oversized requests get a block of their own */
+    Block block;
+    block.Size = size + alignment > m_BlockSize ? size + alignment : m_BlockSize;
+    block.Data = (unsigned char*)malloc(block.Size);
+    ASSERT(block.Data);
+    m_Blocks.push_back(block);
+    m_Block = (unsigned int)m_Blocks.size() - 1;
+    m_Offset = 0;
+    return Allocate(size, alignment);
+}
+
+void LinearAllocator::Reset()
+{
+    m_Block = 0;
+    m_Offset = 0;
+    m_Used = 0;
+}
+
+size_t LinearAllocator::GetCapacity() const
+{
+    size_t capacity = 0;
+    for (const auto& block : m_Blocks)
+        capacity += block.Size;
+    return capacity;
+}
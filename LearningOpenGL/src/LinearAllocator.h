@@ -0,0 +1,52 @@
+#pragma once
+#include <cstddef>
+#include <new>
+#include <vector>
+
+/* Bump allocator over a chain of blocks. Allocate only moves an offset and Reset
+ * rewinds it, blocks are kept so after the first few frames nothing hits the heap.
+ * Destructors are never run, use it for trivially destructible data.
+ * Not thread safe, give every thread its own.
+ */
+class LinearAllocator
+{
+public:
+	static const size_t DefaultBlockSize = 1 << 20;
+
+private:
+	struct Block
+	{
+		unsigned char* Data;
+		size_t Size;
+	};
+
+	std::vector<Block> m_Blocks;
+	unsigned int m_Block;
+	size_t m_Offset;
+	size_t m_BlockSize;
+	size_t m_Used;
+
+public:
+	explicit LinearAllocator(size_t blockSize = DefaultBlockSize);
+
+	~LinearAllocator();
+
+	LinearAllocator(const LinearAllocator&) = delete;
+	LinearAllocator& operator=(const LinearAllocator&) = delete;
+
+	void* Allocate(size_t size, size_t alignment = 16);
+
+	template<typename T>
+	T* New(const T& value)
+	{
+		return new (Allocate(sizeof(T), alignof(T))) T(value);
+	}
+
+	// Everything allocated so far becomes invalid
+	void Reset();
+
+	// Bytes handed out since the last Reset
+	inline size_t GetUsed() const { return m_Used; }
+
+	size_t GetCapacity() const;
+};
@@ -0,0 +1,27 @@
+#include "LodSelector.h"
+
+float LodSelector::GetScreenError(float error, const glm::mat4& mvp, const glm::vec3& center, float viewportHeight)
+{
+    /* The y row of the MVP scales object space lengths to clip space, w divides them */
+    glm::vec3 rowY(mvp[0][1], mvp[1][1], mvp[2][1]);
+    float w = mvp[0][3] * center.x + mvp[1][3] * center.y + mvp[2][3] * center.z + mvp[3][3];
+    if (w <= 0.0f)
+        return 0.0f;   // behind the camera, should have been culled
+
+    return error * glm::length(rowY) / w * viewportHeight * 0.5f;
+}
+
+unsigned int LodSelector::Select(const MeshData& mesh, const glm::mat4& mvp, float viewportHeight,
+    unsigned int currentLod, float maxPixelError, float hysteresis)
+{
+    const unsigned int levelCount = (unsigned int)mesh.Lods.size() + 1;
+    const glm::vec3 center = mesh.Bounds.GetCenter();
+    const float scale = GetScreenError(1.0f, mvp, center, viewportHeight);
+
+    unsigned int lod = currentLod < levelCount ? currentLod : levelCount - 1;
+    while (lod > 0 && mesh.Lods[lod - 1].Error * scale > maxPixelError)
+        --lod;
+    while (lod + 1 < levelCount && mesh.Lods[lod].Error * scale <= maxPixelError * (1.0f - hysteresis))
+        ++lod;
+    return lod;
+}
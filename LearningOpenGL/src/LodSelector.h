@@ -0,0 +1,18 @@
+#pragma once
+#include <vector>
+
+#include "MeshData.h"
+
+/* Runtime LOD choice by projected screen space error. Keep the returned level per
+ * object and pass it back in next frame, switching to a coarser level needs a margin
+ * of hysteresis so objects near a threshold do not pop back and forth. */
+class LodSelector
+{
+public:
+	/* Size in pixels of an object space error at center, for a viewport of the given height */
+	static float GetScreenError(float error, const glm::mat4& mvp, const glm::vec3& center, float viewportHeight);
+
+	/* Returns the coarsest level (0 = full detail) whose error stays below maxPixelError */
+	static unsigned int Select(const MeshData& mesh, const glm::mat4& mvp, float viewportHeight,
+		unsigned int currentLod, float maxPixelError = 1.0f, float hysteresis = 0.25f);
+};
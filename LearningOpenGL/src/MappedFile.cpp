@@ -0,0 +1,121 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile()
+    : m_Data(nullptr), m_Size(0),
+#ifdef _WIN32
+      m_FileHandle(INVALID_HANDLE_VALUE), m_MappingHandle(nullptr)
+#else
+      m_FileDescriptor(-1)
+#endif
+{
+}
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const std::string& filePath)
+{
+    Close();
+
+    /* Sequential scan hint lets the cache manager read ahead aggressively */
+    m_FileHandle = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (m_FileHandle == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(m_FileHandle, &size) || size.QuadPart == 0)
+    {
+        Close();
+        return false;
+    }
+    m_Size = (unsigned long long)size.QuadPart;
+
+    m_MappingHandle = CreateFileMappingA(m_FileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!m_MappingHandle)
+    {
+        Close();
+        return false;
+    }
+
+    m_Data = (const unsigned char*)MapViewOfFile(m_MappingHandle, FILE_MAP_READ, 0, 0, 0);
+    if (!m_Data)
+    {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (m_Data)
+        UnmapViewOfFile(m_Data);
+    if (m_MappingHandle)
+        CloseHandle(m_MappingHandle);
+    if (m_FileHandle != INVALID_HANDLE_VALUE)
+        CloseHandle(m_FileHandle);
+
+    m_Data = nullptr;
+    m_Size = 0;
+    m_MappingHandle = nullptr;
+    m_FileHandle = INVALID_HANDLE_VALUE;
+}
+
+#else
+
+bool MappedFile::Open(const std::string& filePath)
+{
+    Close();
+
+    m_FileDescriptor = open(filePath.c_str(), O_RDONLY);
+    if (m_FileDescriptor < 0)
+        return false;
+
+    struct stat info;
+    if (fstat(m_FileDescriptor, &info) != 0 || info.st_size == 0)
+    {
+        Close();
+        return false;
+    }
+    m_Size = (unsigned long long)info.st_size;
+
+    void* data = mmap(nullptr, m_Size, PROT_READ, MAP_PRIVATE, m_FileDescriptor, 0);
+    if (data == MAP_FAILED)
+    {
+        Close();
+        return false;
+    }
+    madvise(data, m_Size, MADV_SEQUENTIAL);
+    m_Data = (const unsigned char*)data;
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (m_Data)
+        munmap((void*)m_Data, m_Size);
+    if (m_FileDescriptor >= 0)
+        close(m_FileDescriptor);
+
+    m_Data = nullptr;
+    m_Size = 0;
+    m_FileDescriptor = -1;
+}
+
+#endif
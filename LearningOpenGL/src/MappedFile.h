@@ -0,0 +1,38 @@
+#pragma once
+#include <string>
+
+/* Read-only memory-mapped file. The OS pages the contents in on demand,
+ * so data can be handed to GL without being copied into our own buffers first.
+ */
+class MappedFile
+{
+private:
+	const unsigned char* m_Data;
+	unsigned long long m_Size;
+
+#ifdef _WIN32
+	void* m_FileHandle;
+	void* m_MappingHandle;
+#else
+	int m_FileDescriptor;
+#endif
+
+public:
+	MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	~MappedFile();
+
+	bool Open(const std::string& filePath);
+
+	void Close();
+
+	inline bool IsOpen() const { return m_Data != nullptr; }
+
+	inline const unsigned char* GetData() const { return m_Data; }
+
+	inline unsigned long long GetSize() const { return m_Size; }
+};
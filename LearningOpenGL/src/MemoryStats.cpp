@@ -0,0 +1,98 @@
+#include "MemoryStats.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<unsigned long long> s_AllocationCount(0);
+static std::atomic<unsigned long long> s_FreeCount(0);
+static std::atomic<unsigned long long> s_AllocatedBytes(0);
+static thread_local unsigned long long t_AllocationCount = 0;
+
+static void* CountedAllocate(size_t size)
+{
+    s_AllocationCount.fetch_add(1, std::memory_order_relaxed);
+    s_AllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    ++t_AllocationCount;
+    return malloc(size ? size : 1);
+}
+
+static void CountedFree(void* pointer)
+{
+    if (!pointer)
+        return;
+    s_FreeCount.fetch_add(1, std::memory_order_relaxed);
+    free(pointer);
+}
+
+unsigned long long MemoryStats::GetAllocationCount()
+{
+    return s_AllocationCount.load(std::memory_order_relaxed);
+}
+
+unsigned long long MemoryStats::GetFreeCount()
+{
+    return s_FreeCount.load(std::memory_order_relaxed);
+}
+
+unsigned long long MemoryStats::GetAllocatedBytes()
+{
+    return s_AllocatedBytes.load(std::memory_order_relaxed);
+}
+
+unsigned long long MemoryStats::GetThreadAllocationCount()
+{
+    return t_AllocationCount;
+}
+
+void* operator new(size_t size)
+{
+    if (void* pointer = CountedAllocate(size))
+        return pointer;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    return CountedAllocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    return CountedAllocate(size);
+}
+
+void operator delete(void* pointer) noexcept
+{
+    CountedFree(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    CountedFree(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+    CountedFree(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept
+{
+    CountedFree(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept
+{
+    CountedFree(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept
+{
+    CountedFree(pointer);
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+/* Counters fed by the global operator new/delete, so a frame that touches the heap
+ * shows up no matter which container or library made the call. malloc and GL driver
+ * allocations are not seen. */
+class MemoryStats
+{
+public:
+	// Process wide, since startup
+	static unsigned long long GetAllocationCount();
+
+	static unsigned long long GetFreeCount();
+
+	static unsigned long long GetAllocatedBytes();
+
+	// Allocations made by the calling thread
+	static unsigned long long GetThreadAllocationCount();
+};
+
+/* Allocations made anywhere between construction and GetCount, e.g.
+ *
+ *   AllocationScope frame;
+ *   ...
+ *   ASSERT(frame.GetCount() == 0);
+ */
+class AllocationScope
+{
+private:
+	unsigned long long m_Start;
+
+public:
+	AllocationScope() : m_Start(MemoryStats::GetAllocationCount()) {}
+
+	inline unsigned long long GetCount() const { return MemoryStats::GetAllocationCount() - m_Start; }
+
+	inline void Restart() { m_Start = MemoryStats::GetAllocationCount(); }
+};
@@ -0,0 +1,83 @@
+#pragma once
+#include <vector>
+
+#include "VertexBufferLayout.h"
+#include "glm/glm.hpp"
+
+struct BoundingBox
+{
+	glm::vec3 Min;
+	glm::vec3 Max;
+
+	inline glm::vec3 GetCenter() const { return (Min + Max) * 0.5f; }
+
+	inline glm::vec3 GetExtents() const { return (Max - Min) * 0.5f; }
+};
+
+/* A range of the index buffer drawn with one material */
+struct SubMesh
+{
+	unsigned int FirstIndex;
+	unsigned int IndexCount;
+	unsigned int MaterialIndex;
+	BoundingBox Bounds;
+};
+
+/* Cluster of at most MaxVertices vertices / MaxTriangles triangles, stored as a
+ * contiguous range of MeshData::Indices so it can be drawn with a plain index range.
+ * Bounds are in object space, see MeshletBuilder. */
+struct Meshlet
+{
+	static const unsigned int MaxVertices = 64;
+	static const unsigned int MaxTriangles = 124;
+
+	unsigned int FirstIndex;
+	unsigned int IndexCount;
+	unsigned int SubMesh;
+
+	glm::vec3 Center;
+	float Radius;
+
+	// Normal cone for backface culling, ConeCutoff >= 1 means the cluster is never culled
+	glm::vec3 ConeAxis;
+	float ConeCutoff;
+};
+
+/* A simplified version of the whole mesh. Its index ranges live in MeshData::Indices
+ * after the full detail ones and reference the same vertices; there is one SubMesh
+ * per SubMesh of the mesh, in the same order. Error is the object space deviation
+ * from the full detail mesh. */
+struct MeshLod
+{
+	float Error;
+	std::vector<SubMesh> SubMeshes;
+};
+
+/* CPU-side indexed mesh as produced by the importers, ready for
+ * VertexBuffer / IndexBuffer or a MeshPool. The first attribute is always
+ * a float3 position.
+ */
+struct MeshData
+{
+	VertexBufferLayout Layout;
+	std::vector<unsigned char> Vertices;
+	std::vector<unsigned int> Indices;
+	std::vector<SubMesh> SubMeshes;
+	BoundingBox Bounds;
+
+	// Optional, filled by MeshletBuilder which also reorders Indices
+	std::vector<Meshlet> Meshlets;
+
+	// Optional, filled by MeshSimplifier. Level 0 is the full detail mesh, level i is Lods[i - 1]
+	std::vector<MeshLod> Lods;
+
+	inline unsigned int GetVertexCount() const
+	{
+		return Layout.GetStride() ? (unsigned int)(Vertices.size() / Layout.GetStride()) : 0;
+	}
+
+	inline const glm::vec3& GetPosition(unsigned int vertex) const
+	{
+		return *(const glm::vec3*)&Vertices[vertex * Layout.GetStride()];
+	}
+};
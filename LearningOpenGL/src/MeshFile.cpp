@@ -0,0 +1,260 @@
+#include "MeshFile.h"
+#include "Renderer.h"
+
+#include <iostream>
+#include <fstream>
+
+static unsigned long long AlignOffset(unsigned long long offset)
+{
+    return (offset + MeshFileAlignment - 1) & ~(unsigned long long)(MeshFileAlignment - 1);
+}
+
+/* Written so that a corrupt header can not overflow the check */
+static bool FitsInFile(unsigned long long offset, unsigned long long count, unsigned long long elementSize, unsigned long long fileSize)
+{
+    return offset <= fileSize && count <= (fileSize - offset) / elementSize;
+}
+
+MeshFile::MeshFile()
+    : m_Header(nullptr)
+{
+}
+
+bool MeshFile::Open(const std::string& filePath)
+{
+    Close();
+
+    if (!m_File.Open(filePath))
+    {
+        std::cout << "Error: failed to map mesh '" << filePath << "'" << std::endl;
+        return false;
+    }
+
+    const unsigned long long size = m_File.GetSize();
+    const MeshFileHeader* header = (const MeshFileHeader*)m_File.GetData();
+    if (size < sizeof(MeshFileHeader) || header->Magic != MeshFileMagic || header->Version != MeshFileVersion)
+    {
+        std::cout << "Error: '" << filePath << "' is not a mesh file of version " << MeshFileVersion << std::endl;
+        m_File.Close();
+        return false;
+    }
+
+    /* Reject truncated files up front so the accessors never read past the mapping */
+    if (!FitsInFile(header->ElementsOffset, header->ElementCount, sizeof(MeshFileElement), size) ||
+        !FitsInFile(header->SubMeshesOffset, (header->LodCount + 1ull) * header->SubMeshCount, sizeof(MeshFileSubMesh), size) ||
+        !FitsInFile(header->LodsOffset, header->LodCount, sizeof(float), size) ||
+        !FitsInFile(header->MeshletsOffset, header->MeshletCount, sizeof(MeshFileMeshlet), size) ||
+        !FitsInFile(header->IndicesOffset, header->IndexCount, sizeof(unsigned int), size))
+    {
+        std::cout << "Error: mesh file '" << filePath << "' is truncated" << std::endl;
+        m_File.Close();
+        return false;
+    }
+
+    m_Layout = VertexBufferLayout();
+    const MeshFileElement* elements = (const MeshFileElement*)(m_File.GetData() + header->ElementsOffset);
+    for (unsigned int i = 0; i < header->ElementCount; ++i)
+    {
+        const MeshFileElement& element = elements[i];
+        if ((element.Type != GL_FLOAT && element.Type != GL_UNSIGNED_INT && element.Type != GL_UNSIGNED_BYTE) ||
+            element.Count == 0 || element.Count > 4)
+        {
+            std::cout << "Error: mesh file '" << filePath << "' has an invalid vertex element" << std::endl;
+            m_File.Close();
+            return false;
+        }
+        m_Layout.PushElement({ element.Type, element.Count, (unsigned char)element.Normalized });
+    }
+    /* GetVertexDataSize relies on this, VertexCount * Stride stays inside the mapping */
+    if (m_Layout.GetStride() == 0 || m_Layout.GetStride() != header->Stride ||
+        !FitsInFile(header->VerticesOffset, header->VertexCount, header->Stride, size))
+    {
+        std::cout << "Error: mesh file '" << filePath << "' has invalid vertex data" << std::endl;
+        m_File.Close();
+        return false;
+    }
+
+    /* Every range has to stay inside the index blob, they are drawn without further checks */
+    const MeshFileSubMesh* subMeshes = (const MeshFileSubMesh*)(m_File.GetData() + header->SubMeshesOffset);
+    for (unsigned long long i = 0; i < (header->LodCount + 1ull) * header->SubMeshCount; ++i)
+    {
+        if ((unsigned long long)subMeshes[i].FirstIndex + subMeshes[i].IndexCount > header->IndexCount)
+        {
+            std::cout << "Error: mesh file '" << filePath << "' has a SubMesh outside of the index data" << std::endl;
+            m_File.Close();
+            return false;
+        }
+    }
+    const MeshFileMeshlet* meshlets = (const MeshFileMeshlet*)(m_File.GetData() + header->MeshletsOffset);
+    for (unsigned int i = 0; i < header->MeshletCount; ++i)
+    {
+        if ((unsigned long long)meshlets[i].FirstIndex + meshlets[i].IndexCount > header->IndexCount ||
+            meshlets[i].SubMesh >= header->SubMeshCount)
+        {
+            std::cout << "Error: mesh file '" << filePath << "' has an invalid meshlet" << std::endl;
+            m_File.Close();
+            return false;
+        }
+    }
+
+    m_Header = header;
+    return true;
+}
+
+void MeshFile::Close()
+{
+    m_Header = nullptr;
+    m_File.Close();
+}
+
+SubMesh MeshFile::GetSubMesh(unsigned int index, unsigned int lod) const
+{
+    const MeshFileSubMesh* subMeshes = (const MeshFileSubMesh*)(m_File.GetData() + m_Header->SubMeshesOffset);
+    const MeshFileSubMesh& src = subMeshes[lod * m_Header->SubMeshCount + index];
+
+    SubMesh subMesh;
+    subMesh.FirstIndex = src.FirstIndex;
+    subMesh.IndexCount = src.IndexCount;
+    subMesh.MaterialIndex = src.MaterialIndex;
+    subMesh.Bounds.Min = glm::vec3(src.BoundsMin[0], src.BoundsMin[1], src.BoundsMin[2]);
+    subMesh.Bounds.Max = glm::vec3(src.BoundsMax[0], src.BoundsMax[1], src.BoundsMax[2]);
+    return subMesh;
+}
+
+float MeshFile::GetLodError(unsigned int lod) const
+{
+    if (lod == 0)
+        return 0.0f;
+    return ((const float*)(m_File.GetData() + m_Header->LodsOffset))[lod - 1];
+}
+
+Meshlet MeshFile::GetMeshlet(unsigned int index) const
+{
+    const MeshFileMeshlet& src = ((const MeshFileMeshlet*)(m_File.GetData() + m_Header->MeshletsOffset))[index];
+
+    Meshlet meshlet;
+    meshlet.FirstIndex = src.FirstIndex;
+    meshlet.IndexCount = src.IndexCount;
+    meshlet.SubMesh = src.SubMesh;
+    meshlet.Center = glm::vec3(src.Center[0], src.Center[1], src.Center[2]);
+    meshlet.Radius = src.Radius;
+    meshlet.ConeAxis = glm::vec3(src.ConeAxis[0], src.ConeAxis[1], src.ConeAxis[2]);
+    meshlet.ConeCutoff = src.ConeCutoff;
+    return meshlet;
+}
+
+BoundingBox MeshFile::GetBounds() const
+{
+    BoundingBox bounds;
+    bounds.Min = glm::vec3(m_Header->BoundsMin[0], m_Header->BoundsMin[1], m_Header->BoundsMin[2]);
+    bounds.Max = glm::vec3(m_Header->BoundsMax[0], m_Header->BoundsMax[1], m_Header->BoundsMax[2]);
+    return bounds;
+}
+
+void MeshFile::GetMetadata(MeshData& mesh) const
+{
+    mesh = MeshData();
+    mesh.Layout = m_Layout;
+    mesh.Bounds = GetBounds();
+
+    for (unsigned int i = 0; i < m_Header->SubMeshCount; ++i)
+        mesh.SubMeshes.push_back(GetSubMesh(i));
+    for (unsigned int i = 0; i < m_Header->MeshletCount; ++i)
+        mesh.Meshlets.push_back(GetMeshlet(i));
+
+    mesh.Lods.resize(m_Header->LodCount);
+    for (unsigned int lod = 1; lod <= m_Header->LodCount; ++lod)
+    {
+        mesh.Lods[lod - 1].Error = GetLodError(lod);
+        for (unsigned int i = 0; i < m_Header->SubMeshCount; ++i)
+            mesh.Lods[lod - 1].SubMeshes.push_back(GetSubMesh(i, lod));
+    }
+}
+
+bool MeshFile::Save(const std::string& filePath, const MeshData& mesh)
+{
+    const auto& elements = mesh.Layout.GetElements();
+
+    MeshFileHeader header = {};
+    header.Magic = MeshFileMagic;
+    header.Version = MeshFileVersion;
+    header.ElementCount = (unsigned int)elements.size();
+    header.Stride = mesh.Layout.GetStride();
+    header.VertexCount = mesh.GetVertexCount();
+    header.IndexCount = (unsigned int)mesh.Indices.size();
+    header.SubMeshCount = (unsigned int)mesh.SubMeshes.size();
+    header.MeshletCount = (unsigned int)mesh.Meshlets.size();
+    header.LodCount = (unsigned int)mesh.Lods.size();
+    for (int i = 0; i < 3; ++i)
+    {
+        header.BoundsMin[i] = mesh.Bounds.Min[i];
+        header.BoundsMax[i] = mesh.Bounds.Max[i];
+    }
+
+    header.ElementsOffset = sizeof(MeshFileHeader);
+    header.SubMeshesOffset = header.ElementsOffset + header.ElementCount * sizeof(MeshFileElement);
+    header.MeshletsOffset = header.SubMeshesOffset + (header.LodCount + 1) * header.SubMeshCount * sizeof(MeshFileSubMesh);
+    header.LodsOffset = header.MeshletsOffset + header.MeshletCount * sizeof(MeshFileMeshlet);
+    header.VerticesOffset = AlignOffset(header.LodsOffset + header.LodCount * sizeof(float));
+    header.IndicesOffset = AlignOffset(header.VerticesOffset + mesh.Vertices.size());
+
+    std::ofstream stream(filePath, std::ios::binary);
+    if (!stream)
+    {
+        std::cout << "Error: failed to create mesh file '" << filePath << "'" << std::endl;
+        return false;
+    }
+
+    stream.write((const char*)&header, sizeof(header));
+
+    for (const auto& element : elements)
+    {
+        MeshFileElement fileElement = { element.type, element.count, element.normalized };
+        stream.write((const char*)&fileElement, sizeof(fileElement));
+    }
+
+    for (unsigned int lod = 0; lod <= header.LodCount; ++lod)
+    {
+        for (const auto& subMesh : lod ? mesh.Lods[lod - 1].SubMeshes : mesh.SubMeshes)
+        {
+            MeshFileSubMesh fileSubMesh = {};
+            fileSubMesh.FirstIndex = subMesh.FirstIndex;
+            fileSubMesh.IndexCount = subMesh.IndexCount;
+            fileSubMesh.MaterialIndex = subMesh.MaterialIndex;
+            for (int i = 0; i < 3; ++i)
+            {
+                fileSubMesh.BoundsMin[i] = subMesh.Bounds.Min[i];
+                fileSubMesh.BoundsMax[i] = subMesh.Bounds.Max[i];
+            }
+            stream.write((const char*)&fileSubMesh, sizeof(fileSubMesh));
+        }
+    }
+
+    for (const auto& meshlet : mesh.Meshlets)
+    {
+        MeshFileMeshlet fileMeshlet = {};
+        fileMeshlet.FirstIndex = meshlet.FirstIndex;
+        fileMeshlet.IndexCount = meshlet.IndexCount;
+        fileMeshlet.SubMesh = meshlet.SubMesh;
+        for (int i = 0; i < 3; ++i)
+        {
+            fileMeshlet.Center[i] = meshlet.Center[i];
+            fileMeshlet.ConeAxis[i] = meshlet.ConeAxis[i];
+        }
+        fileMeshlet.Radius = meshlet.Radius;
+        fileMeshlet.ConeCutoff = meshlet.ConeCutoff;
+        stream.write((const char*)&fileMeshlet, sizeof(fileMeshlet));
+    }
+
+    for (const auto& lod : mesh.Lods)
+        stream.write((const char*)&lod.Error, sizeof(lod.Error));
+
+    /* Pad up to the aligned blob offsets */
+    static const char padding[MeshFileAlignment] = {};
+    stream.write(padding, header.VerticesOffset - (unsigned long long)stream.tellp());
+    stream.write((const char*)mesh.Vertices.data(), mesh.Vertices.size());
+    stream.write(padding, header.IndicesOffset - (unsigned long long)stream.tellp());
+    stream.write((const char*)mesh.Indices.data(), mesh.Indices.size() * sizeof(unsigned int));
+
+    return (bool)stream;
+}
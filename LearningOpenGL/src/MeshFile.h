@@ -0,0 +1,127 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+#include "MappedFile.h"
+#include "MeshData.h"
+
+/* Binary mesh asset (.mesh), laid out so it can be used straight from a memory mapping:
+ *
+ *   MeshFileHeader
+ *   MeshFileElement[ElementCount]    vertex layout, same as VertexBufferLayout
+ *   MeshFileSubMesh[SubMeshCount * (LodCount + 1)]    full detail first, then each LOD
+ *   MeshFileMeshlet[MeshletCount]
+ *   float[LodCount]                  LOD errors
+ *   vertex blob                      aligned to MeshFileAlignment
+ *   index blob (unsigned int)        aligned to MeshFileAlignment
+ *
+ * Everything is little endian, offsets are from the start of the file. Only files of
+ * MeshFileVersion are accepted, older ones have to be converted again.
+ */
+static const unsigned int MeshFileMagic = 0x4D4C474C;     // "LGLM"
+static const unsigned int MeshFileVersion = 3;
+static const unsigned int MeshFileAlignment = 64;
+
+struct MeshFileHeader
+{
+	unsigned int Magic;
+	unsigned int Version;
+	unsigned int ElementCount;
+	unsigned int Stride;
+	unsigned int VertexCount;
+	unsigned int IndexCount;
+	unsigned int SubMeshCount;
+	float BoundsMin[3];
+	float BoundsMax[3];
+	unsigned int MeshletCount;
+	unsigned long long ElementsOffset;
+	unsigned long long SubMeshesOffset;
+	unsigned long long VerticesOffset;
+	unsigned long long IndicesOffset;
+	unsigned long long MeshletsOffset;
+	unsigned int LodCount;
+	unsigned int Reserved;
+	unsigned long long LodsOffset;
+};
+
+struct MeshFileElement
+{
+	unsigned int Type;
+	unsigned int Count;
+	unsigned int Normalized;
+};
+
+struct MeshFileSubMesh
+{
+	unsigned int FirstIndex;
+	unsigned int IndexCount;
+	unsigned int MaterialIndex;
+	float BoundsMin[3];
+	float BoundsMax[3];
+};
+
+struct MeshFileMeshlet
+{
+	unsigned int FirstIndex;
+	unsigned int IndexCount;
+	unsigned int SubMesh;
+	float Center[3];
+	float Radius;
+	float ConeAxis[3];
+	float ConeCutoff;
+};
+
+class MeshFile
+{
+private:
+	MappedFile m_File;
+
+	const MeshFileHeader* m_Header;
+
+	VertexBufferLayout m_Layout;
+
+public:
+	MeshFile();
+
+	/* Maps the file and validates the header and tables, no vertex or index data is touched */
+	bool Open(const std::string& filePath);
+
+	void Close();
+
+	static bool Save(const std::string& filePath, const MeshData& mesh);
+
+	inline bool IsOpen() const { return m_Header != nullptr; }
+
+	inline const VertexBufferLayout& GetLayout() const { return m_Layout; }
+
+	inline unsigned int GetVertexCount() const { return m_Header->VertexCount; }
+
+	inline unsigned int GetIndexCount() const { return m_Header->IndexCount; }
+
+	inline unsigned int GetSubMeshCount() const { return m_Header->SubMeshCount; }
+
+	inline unsigned int GetMeshletCount() const { return m_Header->MeshletCount; }
+
+	// Number of simplified levels, not counting the full detail one
+	inline unsigned int GetLodCount() const { return m_Header->LodCount; }
+
+	// Pointers into the mapping, valid until Close
+	inline const void* GetVertices() const { return m_File.GetData() + m_Header->VerticesOffset; }
+
+	inline const unsigned int* GetIndices() const { return (const unsigned int*)(m_File.GetData() + m_Header->IndicesOffset); }
+
+	// Checked against the mapping size in Open
+	inline size_t GetVertexDataSize() const { return (size_t)m_Header->VertexCount * m_Header->Stride; }
+
+	SubMesh GetSubMesh(unsigned int index, unsigned int lod = 0) const;
+
+	float GetLodError(unsigned int lod) const;
+
+	Meshlet GetMeshlet(unsigned int index) const;
+
+	BoundingBox GetBounds() const;
+
+	/* Copies layout, SubMeshes, meshlets, LODs and bounds into mesh and leaves its vertices
+	 * and indices empty, those are uploaded straight from the mapping */
+	void GetMetadata(MeshData& mesh) const;
+};
@@ -0,0 +1,140 @@
+#include "MeshImporter.h"
+#include "MeshFile.h"
+#include "ObjLoader.h"
+#include "GltfLoader.h"
+#include "Meshlet.h"
+#include "MeshSimplifier.h"
+
+#include <iostream>
+#include <cctype>
+#include <cfloat>
+#include <cstring>
+
+static std::string GetExtension(const std::string& filePath)
+{
+    size_t dot = filePath.find_last_of('.');
+    if (dot == std::string::npos || filePath.find_first_of("/\\", dot) != std::string::npos)
+        return "";
+
+    std::string extension = filePath.substr(dot + 1);
+    for (char& c : extension)
+        c = (char)std::tolower((unsigned char)c);
+    return extension;
+}
+
+/* Appends position, texcoord and normal of every vertex of source, transformed */
+static void AppendInstance(MeshData& mesh, const MeshData& source, const glm::mat4& transform)
+{
+    const unsigned int baseVertex = mesh.GetVertexCount();
+    const unsigned int firstIndex = (unsigned int)mesh.Indices.size();
+    const unsigned int stride = source.Layout.GetStride();
+    const glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(transform)));
+
+    mesh.Vertices.resize(mesh.Vertices.size() + (size_t)source.GetVertexCount() * mesh.Layout.GetStride());
+    float* destination = (float*)&mesh.Vertices[(size_t)baseVertex * mesh.Layout.GetStride()];
+    for (unsigned int v = 0; v < source.GetVertexCount(); ++v, destination += 8)
+    {
+        float vertex[8];
+        std::memcpy(vertex, &source.Vertices[(size_t)v * stride], sizeof(vertex));
+
+        glm::vec3 position = glm::vec3(transform * glm::vec4(vertex[0], vertex[1], vertex[2], 1.0f));
+        glm::vec3 normal = normalMatrix * glm::vec3(vertex[5], vertex[6], vertex[7]);
+        float length = glm::length(normal);
+        if (length > 0.0f)
+            normal /= length;
+
+        const float result[8] = { position.x, position.y, position.z, vertex[3], vertex[4], normal.x, normal.y, normal.z };
+        std::memcpy(destination, result, sizeof(result));
+    }
+
+    for (unsigned int index : source.Indices)
+        mesh.Indices.push_back(baseVertex + index);
+
+    for (SubMesh subMesh : source.SubMeshes)
+    {
+        subMesh.FirstIndex += firstIndex;
+        subMesh.Bounds.Min = glm::vec3(FLT_MAX);
+        subMesh.Bounds.Max = glm::vec3(-FLT_MAX);
+        for (unsigned int i = subMesh.FirstIndex; i < subMesh.FirstIndex + subMesh.IndexCount; ++i)
+        {
+            subMesh.Bounds.Min = glm::min(subMesh.Bounds.Min, mesh.GetPosition(mesh.Indices[i]));
+            subMesh.Bounds.Max = glm::max(subMesh.Bounds.Max, mesh.GetPosition(mesh.Indices[i]));
+        }
+        mesh.Bounds.Min = glm::min(mesh.Bounds.Min, subMesh.Bounds.Min);
+        mesh.Bounds.Max = glm::max(mesh.Bounds.Max, subMesh.Bounds.Max);
+        mesh.SubMeshes.push_back(subMesh);
+    }
+}
+
+static bool ImportGltf(const std::string& filePath, MeshData& mesh)
+{
+    GltfScene scene;
+    if (!GltfLoader::Load(filePath, scene))
+        return false;
+
+    mesh = MeshData();
+    mesh.Layout.Push<float>(3);
+    mesh.Layout.Push<float>(2);
+    mesh.Layout.Push<float>(3);
+    mesh.Bounds.Min = glm::vec3(FLT_MAX);
+    mesh.Bounds.Max = glm::vec3(-FLT_MAX);
+
+    /* Files without a scene still have meshes, take each of them once */
+    if (scene.Instances.empty())
+    {
+        for (unsigned int i = 0; i < scene.Meshes.size(); ++i)
+            scene.Instances.push_back({ i, glm::mat4(1.0f) });
+    }
+    for (const auto& instance : scene.Instances)
+        AppendInstance(mesh, scene.Meshes[instance.Mesh].Mesh, instance.Transform);
+
+    if (mesh.Indices.empty())
+    {
+        std::cout << "Error: glTF file '" << filePath << "' has no triangles" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool MeshImporter::Import(const std::string& filePath, MeshData& mesh)
+{
+    const std::string extension = GetExtension(filePath);
+    bool loaded = false;
+    if (extension == "obj")
+    {
+        loaded = ObjLoader::Load(filePath, mesh);
+    }
+    else if (extension == "gltf" || extension == "glb")
+    {
+        loaded = ImportGltf(filePath, mesh);
+    }
+    else
+    {
+        std::cout << "Error: don't know how to import '" << filePath << "'" << std::endl;
+    }
+
+    if (loaded)
+        Prepare(mesh);
+    return loaded;
+}
+
+void MeshImporter::Prepare(MeshData& mesh)
+{
+    /* Meshlets first, LOD indices go after the full detail ones and are left alone */
+    MeshletBuilder::Build(mesh);
+    MeshSimplifier::BuildLods(mesh);
+}
+
+bool MeshImporter::Convert(const std::string& inputPath, const std::string& outputPath)
+{
+    MeshData mesh;
+    if (!Import(inputPath, mesh))
+        return false;
+
+    if (!MeshFile::Save(outputPath, mesh))
+        return false;
+
+    std::cout << "Converted '" << inputPath << "' to '" << outputPath << "': " << mesh.GetVertexCount() << " vertices, "
+        << mesh.Indices.size() / 3 << " triangles, " << mesh.Meshlets.size() << " meshlets, " << mesh.Lods.size() << " LODs" << std::endl;
+    return true;
+}
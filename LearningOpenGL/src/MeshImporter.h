@@ -0,0 +1,25 @@
+#pragma once
+#include <string>
+
+#include "MeshData.h"
+
+/* Offline side of the .mesh pipeline. Source assets are parsed once and written as a
+ * MeshFile, which the application maps at load time instead of parsing text:
+ *
+ *   LearningOpenGL --convert model.obj model.mesh
+ */
+class MeshImporter
+{
+public:
+	/* Picks the loader by extension (.obj, .gltf, .glb). Every instance of a glTF scene
+	 * is baked into one mesh with its node transform; vertices keep float3 position,
+	 * float2 texcoord and float3 normal, like OBJ meshes. */
+	static bool Import(const std::string& filePath, MeshData& mesh);
+
+	/* Adds what the renderer culls and selects detail with: meshlets of the full detail
+	 * level, then the LOD chain. Import calls it, generated meshes have to call it themselves */
+	static void Prepare(MeshData& mesh);
+
+	/* Import followed by MeshFile::Save */
+	static bool Convert(const std::string& inputPath, const std::string& outputPath);
+};
@@ -0,0 +1,120 @@
+#include "MeshPool.h"
+
+#include "Renderer.h"
+
+#include <iostream>
+
+MeshPool::Page::Page(unsigned int vertexCapacity, unsigned int indexCapacity, unsigned int stride)
+    : Vertices(nullptr, vertexCapacity * stride),
+      Indices(nullptr, indexCapacity),
+      VertexAllocator(vertexCapacity, 16),
+      IndexAllocator(indexCapacity, 64)
+{
+}
+
+MeshPool::MeshPool(VertexArrayCache& cache, const VertexBufferLayout& layout,
+    unsigned int verticesPerPage, unsigned int indicesPerPage)
+    : m_VertexArrayCache(cache),
+      m_Layout(layout),
+      m_VerticesPerPage(BuddyAllocator::NextPowerOfTwo(verticesPerPage)),
+      m_IndicesPerPage(BuddyAllocator::NextPowerOfTwo(indicesPerPage))
+{
+}
+
+MeshAllocation MeshPool::Allocate(const void* vertices, unsigned int vertexCount, const unsigned int* indices, unsigned int indexCount)
+{
+    MeshAllocation mesh = { BuddyAllocator::InvalidOffset, 0, vertexCount, 0, indexCount };
+    if (vertexCount == 0 || indexCount == 0)
+        return mesh;
+
+    for (unsigned int i = 0; i < m_Pages.size(); ++i)
+    {
+        Page& page = m_Pages[i];
+        unsigned int baseVertex = page.VertexAllocator.Allocate(vertexCount);
+        if (baseVertex == BuddyAllocator::InvalidOffset)
+            continue;
+
+        unsigned int firstIndex = page.IndexAllocator.Allocate(indexCount);
+        if (firstIndex == BuddyAllocator::InvalidOffset)
+        {
+            page.VertexAllocator.Free(baseVertex);
+            continue;
+        }
+
+        mesh.Page = i;
+        mesh.BaseVertex = baseVertex;
+        mesh.FirstIndex = firstIndex;
+        break;
+    }
+
+    /* Nothing fits, open a new page. Meshes bigger than a page get a page of their own */
+    if (!mesh.IsValid())
+    {
+        unsigned int vertexCapacity = BuddyAllocator::NextPowerOfTwo(vertexCount);
+        unsigned int indexCapacity = BuddyAllocator::NextPowerOfTwo(indexCount);
+        vertexCapacity = vertexCapacity > m_VerticesPerPage ? vertexCapacity : m_VerticesPerPage;
+        indexCapacity = indexCapacity > m_IndicesPerPage ? indexCapacity : m_IndicesPerPage;
+
+        /* Buffer sizes are 32 bit byte counts */
+        if (vertexCount > vertexCapacity || indexCount > indexCapacity ||
+            (unsigned long long)vertexCapacity * m_Layout.GetStride() > 0xffffffffull ||
+            (unsigned long long)indexCapacity * sizeof(unsigned int) > 0xffffffffull)
+        {
+            std::cout << "Error: mesh with " << vertexCount << " vertices and " << indexCount << " indices does not fit a MeshPool page" << std::endl;
+            return mesh;
+        }
+
+        m_Pages.emplace_back(vertexCapacity, indexCapacity, m_Layout.GetStride());
+        Page& page = m_Pages.back();
+
+        mesh.Page = (unsigned int)m_Pages.size() - 1;
+        mesh.BaseVertex = page.VertexAllocator.Allocate(vertexCount);
+        mesh.FirstIndex = page.IndexAllocator.Allocate(indexCount);
+    }
+
+    Update(mesh, vertices, indices);
+    return mesh;
+}
+
+void MeshPool::Update(const MeshAllocation& mesh, const void* vertices, const unsigned int* indices)
+{
+    ASSERT(mesh.IsValid());
+    Page& page = m_Pages[mesh.Page];
+
+    /* Binding the index buffer would otherwise modify whatever VAO is bound */
+    GLCall(glBindVertexArray(0));
+
+    if (vertices)
+    {
+        unsigned int stride = m_Layout.GetStride();
+        page.Vertices.SetData(vertices, mesh.VertexCount * stride, mesh.BaseVertex * stride);
+    }
+    if (indices)
+    {
+        page.Indices.SetData(indices, mesh.IndexCount, mesh.FirstIndex);
+    }
+}
+
+void MeshPool::Free(MeshAllocation& mesh)
+{
+    if (!mesh.IsValid())
+        return;
+
+    Page& page = m_Pages[mesh.Page];
+    page.VertexAllocator.Free(mesh.BaseVertex);
+    page.IndexAllocator.Free(mesh.FirstIndex);
+    mesh.Page = BuddyAllocator::InvalidOffset;
+}
+
+void MeshPool::Clear()
+{
+    m_Pages.clear();
+}
+
+const VertexArray& MeshPool::Bind(unsigned int page) const
+{
+    const VertexArray& va = m_VertexArrayCache.Bind(m_Layout, m_Pages[page].Vertices);
+    /* Element buffer binding is VAO state and the VAO is shared by format, so rebind it */
+    m_Pages[page].Indices.Bind();
+    return va;
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <memory>
+#include <vector>
+
+#include "BuddyAllocator.h"
+#include "IndexBuffer.h"
+#include "VertexArrayCache.h"
+
+/* Where a mesh lives inside a MeshPool. BaseVertex and FirstIndex are offsets in
+ * vertices and indices, so they can be passed straight to glDrawElementsBaseVertex.
+ */
+struct MeshAllocation
+{
+	unsigned int Page;
+	unsigned int BaseVertex;
+	unsigned int VertexCount;
+	unsigned int FirstIndex;
+	unsigned int IndexCount;
+
+	inline bool IsValid() const { return Page != BuddyAllocator::InvalidOffset; }
+};
+
+/* Sub-allocates mesh data for one vertex format out of a few big GL buffers.
+ * Every page is one vertex buffer and one index buffer split with a buddy allocator,
+ * so thousands of meshes share a handful of buffer objects and one cached VAO.
+ */
+class MeshPool
+{
+private:
+	struct Page
+	{
+		VertexBuffer Vertices;
+		IndexBuffer Indices;
+		BuddyAllocator VertexAllocator;
+		BuddyAllocator IndexAllocator;
+
+		Page(unsigned int vertexCapacity, unsigned int indexCapacity, unsigned int stride);
+	};
+
+	VertexArrayCache& m_VertexArrayCache;
+
+	VertexBufferLayout m_Layout;
+
+	unsigned int m_VerticesPerPage;
+	unsigned int m_IndicesPerPage;
+
+	// Stored by value, pages move on growth and their buffers move with them
+	std::vector<Page> m_Pages;
+
+public:
+	/* Page sizes are rounded up to powers of two, the defaults are
+	 * 256K vertices and 1M indices per page.
+	 */
+	MeshPool(VertexArrayCache& cache, const VertexBufferLayout& layout,
+		unsigned int verticesPerPage = 1 << 18, unsigned int indicesPerPage = 1 << 20);
+
+	/* Reserve space and upload a mesh, data can be nullptr to fill it later with Update.
+	 * Empty meshes and meshes too big for a buffer get an invalid allocation. */
+	MeshAllocation Allocate(const void* vertices, unsigned int vertexCount, const unsigned int* indices, unsigned int indexCount);
+
+	void Update(const MeshAllocation& mesh, const void* vertices, const unsigned int* indices);
+
+	void Free(MeshAllocation& mesh);
+
+	/* Deletes every page and its GL buffers, outstanding allocations become dangling.
+	 * Needs the context, so call it on the render thread before the context goes away */
+	void Clear();
+
+	// Binds the shared VAO with the vertex and index buffer of the given page
+	const VertexArray& Bind(unsigned int page) const;
+
+	inline const VertexBufferLayout& GetLayout() const { return m_Layout; }
+
+	inline unsigned int GetPageCount() const { return (unsigned int)m_Pages.size(); }
+
+	inline const VertexBuffer& GetVertexBuffer(unsigned int page) const { return m_Pages[page].Vertices; }
+
+	inline const IndexBuffer& GetIndexBuffer(unsigned int page) const { return m_Pages[page].Indices; }
+};
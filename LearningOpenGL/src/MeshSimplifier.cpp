@@ -0,0 +1,347 @@
+#include "MeshSimplifier.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+/* Symmetric 4x4 error quadric plus the total area it was built from, so the
+ * error can be reported as a squared distance */
+struct Quadric
+{
+    double a2, ab, ac, ad, b2, bc, bd, c2, cd, d2, Weight;
+
+    void AddPlane(const glm::vec3& normal, float distance, double weight)
+    {
+        double a = normal.x, b = normal.y, c = normal.z, d = distance;
+        a2 += weight * a * a; ab += weight * a * b; ac += weight * a * c; ad += weight * a * d;
+        b2 += weight * b * b; bc += weight * b * c; bd += weight * b * d;
+        c2 += weight * c * c; cd += weight * c * d;
+        d2 += weight * d * d;
+        Weight += weight;
+    }
+
+    void Add(const Quadric& other)
+    {
+        a2 += other.a2; ab += other.ab; ac += other.ac; ad += other.ad;
+        b2 += other.b2; bc += other.bc; bd += other.bd;
+        c2 += other.c2; cd += other.cd;
+        d2 += other.d2;
+        Weight += other.Weight;
+    }
+
+    double Evaluate(const glm::vec3& p) const
+    {
+        double x = p.x, y = p.y, z = p.z;
+        double error = a2 * x * x + b2 * y * y + c2 * z * z
+            + 2.0 * (ab * x * y + ac * x * z + bc * y * z)
+            + 2.0 * (ad * x + bd * y + cd * z) + d2;
+        return Weight > 0.0 ? std::max(error / Weight, 0.0) : 0.0;
+    }
+};
+
+enum VertexKind : unsigned char
+{
+    Manifold,   // may collapse onto any neighbour
+    Border,     // may only collapse along a border edge
+    Locked      // seams and non-manifold vertices
+};
+
+/* Weight of the planes that keep open borders in place, relative to surface area */
+static const double BorderWeight = 10.0;
+
+struct Collapse
+{
+    unsigned int Source;
+    unsigned int Target;
+    double Error;
+
+    bool operator<(const Collapse& other) const { return Error < other.Error; }
+};
+
+static unsigned long long EdgeKey(unsigned int a, unsigned int b)
+{
+    return a < b ? ((unsigned long long)a << 32) | b : ((unsigned long long)b << 32) | a;
+}
+
+/* Vertices that only differ in their attributes share a position id */
+static void WeldPositions(const std::vector<glm::vec3>& positions, std::vector<unsigned int>& weld)
+{
+    struct PositionHash
+    {
+        size_t operator()(const glm::vec3& p) const
+        {
+            unsigned int bits[3];
+            memcpy(bits, &p, sizeof(bits));
+            return (bits[0] * 73856093u) ^ (bits[1] * 19349663u) ^ (bits[2] * 83492791u);
+        }
+    };
+
+    std::unordered_map<glm::vec3, unsigned int, PositionHash> first;
+    first.reserve(positions.size());
+    weld.resize(positions.size());
+    for (unsigned int v = 0; v < positions.size(); ++v)
+        weld[v] = first.emplace(positions[v], v).first->second;
+}
+
+static unsigned int SimplifyWelded(const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& weld,
+    const unsigned int* indices, unsigned int indexCount, unsigned int targetIndexCount, float targetError,
+    unsigned int* destination, float* resultError)
+{
+    const unsigned int vertexCount = (unsigned int)positions.size();
+    std::vector<unsigned int> result(indices, indices + indexCount);
+
+    /* Topology is classified on welded positions, so seams look like any other edge */
+    std::unordered_map<unsigned long long, unsigned int> edgeUse;
+    edgeUse.reserve(indexCount);
+    std::vector<unsigned int> attributeVertex(vertexCount, ~0u);
+    std::vector<unsigned char> kind(vertexCount, Manifold);
+    for (unsigned int i = 0; i < indexCount; i += 3)
+    {
+        for (int e = 0; e < 3; ++e)
+        {
+            unsigned int v = result[i + e];
+            ++edgeUse[EdgeKey(weld[v], weld[result[i + (e + 1) % 3]])];
+
+            unsigned int& seen = attributeVertex[weld[v]];
+            if (seen != ~0u && seen != v)
+                kind[weld[v]] = Locked;
+            seen = v;
+        }
+    }
+
+    std::vector<Quadric> quadrics(vertexCount);
+    memset(quadrics.data(), 0, quadrics.size() * sizeof(Quadric));
+    for (unsigned int i = 0; i < indexCount; i += 3)
+    {
+        unsigned int w[3] = { weld[result[i]], weld[result[i + 1]], weld[result[i + 2]] };
+        const glm::vec3& p0 = positions[w[0]];
+        glm::vec3 normal = glm::cross(positions[w[1]] - p0, positions[w[2]] - p0);
+        float area = glm::length(normal);
+        if (area <= 0.0f)
+            continue;
+        normal /= area;
+
+        for (int e = 0; e < 3; ++e)
+            quadrics[w[e]].AddPlane(normal, -glm::dot(normal, p0), area * 0.5);
+
+        for (int e = 0; e < 3; ++e)
+        {
+            unsigned int a = w[e], b = w[(e + 1) % 3];
+            unsigned int use = edgeUse[EdgeKey(a, b)];
+            if (use == 1)
+            {
+                /* Plane through the border edge, perpendicular to the face */
+                glm::vec3 edge = positions[b] - positions[a];
+                glm::vec3 side = glm::cross(edge, normal);
+                float length = glm::length(side);
+                if (length > 0.0f)
+                {
+                    side /= length;
+                    double weight = BorderWeight * glm::dot(edge, edge);
+                    quadrics[a].AddPlane(side, -glm::dot(side, positions[a]), weight);
+                    quadrics[b].AddPlane(side, -glm::dot(side, positions[a]), weight);
+                }
+                if (kind[a] == Manifold) kind[a] = Border;
+                if (kind[b] == Manifold) kind[b] = Border;
+            }
+            else if (use > 2)
+            {
+                kind[a] = Locked;
+                kind[b] = Locked;
+            }
+        }
+    }
+
+    const double maxError = (double)targetError * targetError;
+    double worstError = 0.0;
+
+    std::vector<Collapse> collapses;
+    std::vector<unsigned int> offsets(vertexCount + 1), adjacency;
+    std::vector<unsigned int> remap(vertexCount);
+    for (unsigned int v = 0; v < vertexCount; ++v)
+        remap[v] = v;
+    std::vector<unsigned char> touched(vertexCount);
+
+    auto allowed = [&](unsigned int source, unsigned int target)
+    {
+        unsigned int ws = weld[source], wt = weld[target];
+        if (ws == wt || kind[ws] == Locked)
+            return false;
+        return kind[ws] == Manifold || edgeUse[EdgeKey(ws, wt)] == 1;
+    };
+
+    /* Passes of independent collapses, cheapest first, until the target is reached */
+    while (result.size() > targetIndexCount)
+    {
+        collapses.clear();
+        for (unsigned int i = 0; i < result.size(); i += 3)
+        {
+            for (int e = 0; e < 3; ++e)
+            {
+                unsigned int a = result[i + e], b = result[i + (e + 1) % 3];
+                Quadric q = quadrics[weld[a]];
+                q.Add(quadrics[weld[b]]);
+
+                double ab = allowed(a, b) ? q.Evaluate(positions[b]) : DBL_MAX;
+                double ba = allowed(b, a) ? q.Evaluate(positions[a]) : DBL_MAX;
+                if (ab <= ba && ab <= maxError)
+                    collapses.push_back({ a, b, ab });
+                else if (ba < ab && ba <= maxError)
+                    collapses.push_back({ b, a, ba });
+            }
+        }
+        if (collapses.empty())
+            break;
+        std::sort(collapses.begin(), collapses.end());
+
+        std::fill(offsets.begin(), offsets.end(), 0);
+        for (unsigned int index : result)
+            ++offsets[index + 1];
+        for (unsigned int v = 0; v < vertexCount; ++v)
+            offsets[v + 1] += offsets[v];
+        adjacency.resize(result.size());
+        {
+            std::vector<unsigned int> cursor(offsets.begin(), offsets.end() - 1);
+            for (unsigned int i = 0; i < result.size(); ++i)
+                adjacency[cursor[result[i]]++] = i / 3;
+        }
+
+        std::fill(touched.begin(), touched.end(), 0);
+        size_t remaining = result.size() / 3;
+        unsigned int applied = 0;
+        for (const auto& collapse : collapses)
+        {
+            unsigned int s = collapse.Source, t = collapse.Target;
+            if (touched[s] || touched[t])
+                continue;
+
+            /* Reject collapses that would flip a face around the source */
+            bool flips = false;
+            unsigned int degenerate = 0;
+            for (unsigned int a = offsets[s]; a < offsets[s + 1] && !flips; ++a)
+            {
+                const unsigned int* tri = &result[adjacency[a] * 3];
+                if (tri[0] == t || tri[1] == t || tri[2] == t)
+                {
+                    ++degenerate;
+                    continue;
+                }
+                int corner = tri[0] == s ? 0 : tri[1] == s ? 1 : 2;
+                const glm::vec3& p1 = positions[tri[(corner + 1) % 3]];
+                const glm::vec3& p2 = positions[tri[(corner + 2) % 3]];
+                glm::vec3 before = glm::cross(p1 - positions[s], p2 - positions[s]);
+                glm::vec3 after = glm::cross(p1 - positions[t], p2 - positions[t]);
+                flips = glm::dot(before, after) <= 0.0f;
+            }
+            if (flips)
+                continue;
+
+            remap[s] = t;
+            quadrics[weld[t]].Add(quadrics[weld[s]]);
+            worstError = std::max(worstError, collapse.Error);
+            ++applied;
+
+            /* The one-ring of the source changes, keep it stable for the rest of the pass */
+            for (unsigned int a = offsets[s]; a < offsets[s + 1]; ++a)
+            {
+                const unsigned int* tri = &result[adjacency[a] * 3];
+                touched[tri[0]] = touched[tri[1]] = touched[tri[2]] = 1;
+            }
+            touched[t] = 1;
+
+            remaining -= degenerate;
+            if (remaining * 3 <= targetIndexCount)
+                break;
+        }
+        if (applied == 0)
+            break;
+
+        size_t write = 0;
+        for (size_t i = 0; i < result.size(); i += 3)
+        {
+            unsigned int a = remap[result[i]], b = remap[result[i + 1]], c = remap[result[i + 2]];
+            if (weld[a] == weld[b] || weld[b] == weld[c] || weld[c] == weld[a])
+                continue;
+            result[write++] = a;
+            result[write++] = b;
+            result[write++] = c;
+        }
+        result.resize(write);
+        for (unsigned int v = 0; v < vertexCount; ++v)
+            remap[v] = v;
+    }
+
+    std::copy(result.begin(), result.end(), destination);
+    if (resultError)
+        *resultError = (float)std::sqrt(worstError);
+    return (unsigned int)result.size();
+}
+
+static void GetPositions(const MeshData& mesh, std::vector<glm::vec3>& positions)
+{
+    positions.resize(mesh.GetVertexCount());
+    for (unsigned int v = 0; v < positions.size(); ++v)
+        positions[v] = mesh.GetPosition(v);
+}
+
+unsigned int MeshSimplifier::Simplify(const MeshData& mesh, const unsigned int* indices, unsigned int indexCount,
+    unsigned int targetIndexCount, float targetError, unsigned int* destination, float* resultError)
+{
+    std::vector<glm::vec3> positions;
+    std::vector<unsigned int> weld;
+    GetPositions(mesh, positions);
+    WeldPositions(positions, weld);
+    return SimplifyWelded(positions, weld, indices, indexCount, targetIndexCount, targetError, destination, resultError);
+}
+
+void MeshSimplifier::BuildLods(MeshData& mesh, unsigned int maxLevels, float ratio)
+{
+    mesh.Lods.clear();
+
+    std::vector<glm::vec3> positions;
+    std::vector<unsigned int> weld;
+    GetPositions(mesh, positions);
+    WeldPositions(positions, weld);
+
+    /* Every level is simplified from the previous one, errors add up */
+    std::vector<SubMesh> previous = mesh.SubMeshes;
+    float previousError = 0.0f;
+    std::vector<unsigned int> simplified;
+    for (unsigned int level = 0; level < maxLevels; ++level)
+    {
+        MeshLod lod;
+        lod.Error = previousError;
+        lod.SubMeshes = previous;
+
+        unsigned int previousCount = 0, count = 0;
+        for (auto& subMesh : lod.SubMeshes)
+        {
+            simplified.resize(subMesh.IndexCount);
+            unsigned int target = (unsigned int)(subMesh.IndexCount / 3 * ratio) * 3;
+            float error = 0.0f;
+            unsigned int indexCount = SimplifyWelded(positions, weld, mesh.Indices.data() + subMesh.FirstIndex,
+                subMesh.IndexCount, target, FLT_MAX, simplified.data(), &error);
+
+            previousCount += subMesh.IndexCount;
+            count += indexCount;
+            lod.Error = std::max(lod.Error, previousError + error);
+
+            subMesh.FirstIndex = (unsigned int)mesh.Indices.size();
+            subMesh.IndexCount = indexCount;
+            mesh.Indices.insert(mesh.Indices.end(), simplified.begin(), simplified.begin() + indexCount);
+        }
+
+        /* Not worth a level of its own, drop it again */
+        if (count == 0 || count > previousCount * 9 / 10)
+        {
+            mesh.Indices.resize(mesh.Indices.size() - count);
+            break;
+        }
+
+        previous = lod.SubMeshes;
+        previousError = lod.Error;
+        mesh.Lods.push_back(std::move(lod));
+    }
+}
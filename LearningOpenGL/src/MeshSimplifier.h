@@ -0,0 +1,23 @@
+#pragma once
+#include <vector>
+
+#include "MeshData.h"
+
+/* Offline quadric error metric simplifier (Garland & Heckbert). Edges are collapsed
+ * onto one of their end points so the result keeps using the original vertices.
+ * Vertices on attribute seams never move and open borders only slide along
+ * themselves, so texture coordinates and silhouettes of open meshes survive. */
+class MeshSimplifier
+{
+public:
+	/* Simplifies a triangle list until it has at most targetIndexCount indices or the
+	 * next collapse would deviate more than targetError (object space) from the input.
+	 * Writes to destination, which must hold indexCount indices, and returns the new
+	 * index count. */
+	static unsigned int Simplify(const MeshData& mesh, const unsigned int* indices, unsigned int indexCount,
+		unsigned int targetIndexCount, float targetError, unsigned int* destination, float* resultError = nullptr);
+
+	/* Builds mesh.Lods, each level with about ratio times the triangles of the previous one.
+	 * Stops early once a level can no longer be reduced noticeably. */
+	static void BuildLods(MeshData& mesh, unsigned int maxLevels = 4, float ratio = 0.5f);
+};
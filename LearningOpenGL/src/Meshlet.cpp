@@ -0,0 +1,206 @@
+#include "Meshlet.h"
+#include "Frustum.h"
+
+#include <cfloat>
+
+const unsigned int Meshlet::MaxVertices;
+const unsigned int Meshlet::MaxTriangles;
+
+static const unsigned int Unused = 0xffffffff;
+
+static void ComputeBounds(const MeshData& mesh, const unsigned int* indices, unsigned int indexCount, Meshlet& meshlet)
+{
+    glm::vec3 min(FLT_MAX), max(-FLT_MAX);
+    for (unsigned int i = 0; i < indexCount; ++i)
+    {
+        min = glm::min(min, mesh.GetPosition(indices[i]));
+        max = glm::max(max, mesh.GetPosition(indices[i]));
+    }
+
+    meshlet.Center = (min + max) * 0.5f;
+    meshlet.Radius = 0.0f;
+    for (unsigned int i = 0; i < indexCount; ++i)
+        meshlet.Radius = glm::max(meshlet.Radius, glm::length(mesh.GetPosition(indices[i]) - meshlet.Center));
+
+    /* Normal cone: average face normal, spread given by the least aligned face */
+    glm::vec3 normals[Meshlet::MaxTriangles];
+    unsigned int normalCount = 0;
+    glm::vec3 axis(0.0f);
+    for (unsigned int i = 0; i + 2 < indexCount; i += 3)
+    {
+        const glm::vec3& a = mesh.GetPosition(indices[i]);
+        glm::vec3 normal = glm::cross(mesh.GetPosition(indices[i + 1]) - a, mesh.GetPosition(indices[i + 2]) - a);
+        float length = glm::length(normal);
+        if (length <= 0.0f)
+            continue;
+        normals[normalCount++] = normal / length;
+        axis += normal / length;
+    }
+
+    meshlet.ConeAxis = glm::vec3(0.0f, 0.0f, 1.0f);
+    meshlet.ConeCutoff = 1.0f;
+
+    float axisLength = glm::length(axis);
+    if (normalCount == 0 || axisLength <= 0.0f)
+        return;
+    axis /= axisLength;
+
+    float minDot = 1.0f;
+    for (unsigned int i = 0; i < normalCount; ++i)
+        minDot = glm::min(minDot, glm::dot(normals[i], axis));
+
+    /* Cones wider than ~84 degrees almost never cull anything */
+    meshlet.ConeAxis = axis;
+    if (minDot > 0.1f)
+        meshlet.ConeCutoff = glm::sqrt(1.0f - minDot * minDot);
+}
+
+void MeshletBuilder::Build(MeshData& mesh)
+{
+    mesh.Meshlets.clear();
+
+    const unsigned int vertexCount = mesh.GetVertexCount();
+    const unsigned int triangleCount = (unsigned int)mesh.Indices.size() / 3;
+
+    /* Vertex -> triangle adjacency in compressed rows */
+    std::vector<unsigned int> offsets(vertexCount + 1, 0);
+    for (unsigned int index : mesh.Indices)
+        ++offsets[index + 1];
+    for (unsigned int v = 0; v < vertexCount; ++v)
+        offsets[v + 1] += offsets[v];
+    std::vector<unsigned int> adjacency(mesh.Indices.size());
+    {
+        std::vector<unsigned int> cursor(offsets.begin(), offsets.end() - 1);
+        for (unsigned int i = 0; i < mesh.Indices.size(); ++i)
+            adjacency[cursor[mesh.Indices[i]]++] = i / 3;
+    }
+
+    std::vector<unsigned char> emitted(triangleCount, 0);
+    std::vector<unsigned int> vertexMeshlet(vertexCount, Unused);
+    /* Indices outside of any SubMesh are kept as they are */
+    std::vector<unsigned int> reordered(mesh.Indices);
+
+    for (unsigned int s = 0; s < mesh.SubMeshes.size(); ++s)
+    {
+        const SubMesh& subMesh = mesh.SubMeshes[s];
+        unsigned int firstTriangle = subMesh.FirstIndex / 3;
+        unsigned int lastTriangle = (subMesh.FirstIndex + subMesh.IndexCount) / 3;
+        unsigned int seed = firstTriangle;
+        unsigned int write = firstTriangle * 3;
+
+        while (true)
+        {
+            while (seed < lastTriangle && emitted[seed])
+                ++seed;
+            if (seed >= lastTriangle)
+                break;
+
+            unsigned int meshletID = (unsigned int)mesh.Meshlets.size();
+            unsigned int vertices[Meshlet::MaxVertices];
+            unsigned int meshletVertexCount = 0, meshletTriangleCount = 0;
+            unsigned int firstIndex = write;
+
+            unsigned int triangle = seed;
+            while (triangle != Unused)
+            {
+                emitted[triangle] = 1;
+                for (int c = 0; c < 3; ++c)
+                {
+                    unsigned int vertex = mesh.Indices[triangle * 3 + c];
+                    if (vertexMeshlet[vertex] != meshletID)
+                    {
+                        vertexMeshlet[vertex] = meshletID;
+                        vertices[meshletVertexCount++] = vertex;
+                    }
+                    reordered[write++] = vertex;
+                }
+                if (++meshletTriangleCount == Meshlet::MaxTriangles)
+                    break;
+
+                /* Greedy growth: the neighbouring triangle that adds the fewest new vertices */
+                unsigned int best = Unused, bestNew = 4;
+                for (unsigned int i = 0; i < meshletVertexCount && bestNew > 0; ++i)
+                {
+                    unsigned int v = vertices[i];
+                    for (unsigned int a = offsets[v]; a < offsets[v + 1]; ++a)
+                    {
+                        unsigned int candidate = adjacency[a];
+                        if (emitted[candidate] || candidate < firstTriangle || candidate >= lastTriangle)
+                            continue;
+
+                        unsigned int added = 0;
+                        for (int c = 0; c < 3; ++c)
+                            added += vertexMeshlet[mesh.Indices[candidate * 3 + c]] != meshletID;
+                        if (added < bestNew)
+                        {
+                            best = candidate;
+                            bestNew = added;
+                            if (added == 0)
+                                break;
+                        }
+                    }
+                }
+
+                if (best != Unused && meshletVertexCount + bestNew > Meshlet::MaxVertices)
+                    best = Unused;
+                triangle = best;
+            }
+
+            Meshlet meshlet;
+            meshlet.FirstIndex = firstIndex;
+            meshlet.IndexCount = meshletTriangleCount * 3;
+            meshlet.SubMesh = s;
+            ComputeBounds(mesh, &reordered[firstIndex], meshlet.IndexCount, meshlet);
+            mesh.Meshlets.push_back(meshlet);
+        }
+    }
+
+    mesh.Indices.swap(reordered);
+}
+
+unsigned int MeshletCuller::Cull(const std::vector<Meshlet>& meshlets, const glm::mat4& model,
+    const glm::mat4& viewProjection, const glm::vec3& cameraPosition, std::vector<IndexRange>& visible)
+{
+    /* Work in object space: one matrix product here instead of one per meshlet */
+    Frustum frustum(viewProjection * model);
+    glm::vec3 camera = glm::vec3(glm::inverse(model) * glm::vec4(cameraPosition, 1.0f));
+
+    visible.clear();
+    unsigned int count = 0;
+    for (const auto& meshlet : meshlets)
+    {
+        if (!frustum.IntersectsSphere(meshlet.Center, meshlet.Radius))
+            continue;
+
+        /* All faces point away if the view direction is inside the (widened) cone */
+        glm::vec3 toCenter = meshlet.Center - camera;
+        if (glm::dot(toCenter, meshlet.ConeAxis) >= meshlet.ConeCutoff * glm::length(toCenter) + meshlet.Radius)
+            continue;
+
+        ++count;
+        /* Ranges never span SubMeshes, each one may use a different material */
+        if (!visible.empty() && visible.back().SubMesh == meshlet.SubMesh
+            && visible.back().FirstIndex + visible.back().IndexCount == meshlet.FirstIndex)
+            visible.back().IndexCount += meshlet.IndexCount;
+        else
+            visible.push_back({ meshlet.FirstIndex, meshlet.IndexCount, meshlet.SubMesh });
+    }
+    return count;
+}
+
+unsigned int MeshletCuller::Cull(const std::vector<Meshlet>& meshlets, const glm::mat4& model,
+    const glm::mat4& viewProjection, const glm::vec3& cameraPosition,
+    const MeshAllocation& mesh, IndirectDrawList& draws)
+{
+    static thread_local std::vector<IndexRange> visible;
+    unsigned int count = Cull(meshlets, model, viewProjection, cameraPosition, visible);
+
+    for (const auto& range : visible)
+    {
+        MeshAllocation part = mesh;
+        part.FirstIndex = mesh.FirstIndex + range.FirstIndex;
+        part.IndexCount = range.IndexCount;
+        draws.Add(part);
+    }
+    return count;
+}
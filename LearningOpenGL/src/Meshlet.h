@@ -0,0 +1,37 @@
+#pragma once
+#include <vector>
+
+#include "MeshData.h"
+#include "IndirectDrawList.h"
+
+/* Splits every SubMesh into meshlets at import time. Triangles are regrouped so each
+ * meshlet is a contiguous index range; SubMesh ranges stay valid. */
+class MeshletBuilder
+{
+public:
+	static void Build(MeshData& mesh);
+};
+
+struct IndexRange
+{
+	unsigned int FirstIndex;
+	unsigned int IndexCount;
+	unsigned int SubMesh;
+};
+
+/* Per-frame CPU cluster culling: frustum test against the bounding sphere and
+ * backface test against the normal cone of every meshlet. Visible meshlets of the same
+ * SubMesh that are next to each other in the index buffer are merged into one range.
+ * The model matrix may only contain rotation, translation and uniform scale. */
+class MeshletCuller
+{
+public:
+	// Returns the number of visible meshlets
+	static unsigned int Cull(const std::vector<Meshlet>& meshlets, const glm::mat4& model,
+		const glm::mat4& viewProjection, const glm::vec3& cameraPosition, std::vector<IndexRange>& visible);
+
+	/* Same, but adds the visible ranges of a mesh uploaded to a MeshPool to a draw list */
+	static unsigned int Cull(const std::vector<Meshlet>& meshlets, const glm::mat4& model,
+		const glm::mat4& viewProjection, const glm::vec3& cameraPosition,
+		const MeshAllocation& mesh, IndirectDrawList& draws);
+};
@@ -0,0 +1,685 @@
+#include "ObjLoader.h"
+#include "MappedFile.h"
+#include "ParallelFor.h"
+
+#include <iostream>
+#include <atomic>
+#include <cfloat>
+#include <climits>
+#include <cmath>
+#include <cstring>
+
+/* Files are split into chunks of about this size, each parsed by one worker */
+static const unsigned int ObjChunkSize = 4 << 20;
+/* Deduplication runs in this many independent hash shards */
+static const unsigned int ObjShardBits = 6;
+static const unsigned int ObjShardCount = 1 << ObjShardBits;
+
+static const unsigned int ObjInvalid = 0xffffffff;
+
+/* Resolved position/uv/normal indices of one triangle corner, -1 when missing */
+struct ObjCorner
+{
+    int Position, TexCoord, Normal;
+
+    bool operator==(const ObjCorner& other) const
+    {
+        return Position == other.Position && TexCoord == other.TexCoord && Normal == other.Normal;
+    }
+};
+
+/* Corner as parsed by a chunk. Negative OBJ indices are relative to the vertices
+ * seen so far, which a chunk only knows locally, so they are flagged and rebased
+ * once every chunk has been counted. */
+struct ObjRawCorner
+{
+    int Index[3];
+    unsigned char Relative;
+    bool Invalid;    // an index was given but is 0 or does not fit an int
+};
+
+struct ObjMaterialSwitch
+{
+    unsigned int Triangle;
+    std::string Name;
+};
+
+struct ObjChunk
+{
+    const char* Begin;
+    const char* End;
+
+    std::vector<glm::vec3> Positions;
+    std::vector<glm::vec2> TexCoords;
+    std::vector<glm::vec3> Normals;
+    std::vector<ObjRawCorner> Corners;
+    std::vector<ObjMaterialSwitch> Switches;
+    std::vector<std::string> Libraries;
+
+    unsigned int PositionBase, TexCoordBase, NormalBase, CornerBase;
+    unsigned int Warnings;
+
+    // Corner indices of this chunk bucketed by dedup shard
+    std::vector<unsigned int> Shards[ObjShardCount];
+};
+
+/* Parsing helpers, all bounded by end since the mapping is not null terminated */
+
+static inline bool IsBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+static inline void SkipBlanks(const char*& p, const char* end)
+{
+    while (p < end && IsBlank(*p))
+        ++p;
+}
+
+static inline void SkipLine(const char*& p, const char* end)
+{
+    const char* newline = (const char*)memchr(p, '\n', end - p);
+    p = newline ? newline + 1 : end;
+}
+
+static inline bool StartsWith(const char* p, const char* end, const char* keyword, size_t length)
+{
+    return (size_t)(end - p) > length && memcmp(p, keyword, length) == 0 && IsBlank(p[length]);
+}
+
+static inline bool ParseInt(const char*& p, const char* end, int& value)
+{
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+'))
+        negative = *p++ == '-';
+
+    if (p >= end || *p < '0' || *p > '9')
+        return false;
+
+    /* Digits are always consumed, values beyond the int range fail */
+    unsigned long long result = 0;
+    while (p < end && *p >= '0' && *p <= '9')
+    {
+        if (result <= (unsigned long long)INT_MAX)
+            result = result * 10 + (*p - '0');
+        ++p;
+    }
+    if (result > (unsigned long long)INT_MAX)
+        return false;
+    value = negative ? -(int)result : (int)result;
+    return true;
+}
+
+/* Hand-written float parser: much faster than iostreams or strtod and locale independent.
+ * Mantissas beyond 19 digits lose precision, which is far below float resolution. */
+static inline bool ParseFloat(const char*& p, const char* end, float& value)
+{
+    static const double powers[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    SkipBlanks(p, end);
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+'))
+        negative = *p++ == '-';
+
+    unsigned long long mantissa = 0;
+    int exponent = 0, digits = 0;
+    bool any = false;
+    while (p < end && *p >= '0' && *p <= '9')
+    {
+        if (digits < 19) { mantissa = mantissa * 10 + (*p - '0'); ++digits; }
+        else ++exponent;
+        any = true;
+        ++p;
+    }
+    if (p < end && *p == '.')
+    {
+        ++p;
+        while (p < end && *p >= '0' && *p <= '9')
+        {
+            if (digits < 19) { mantissa = mantissa * 10 + (*p - '0'); ++digits; --exponent; }
+            any = true;
+            ++p;
+        }
+    }
+    if (!any)
+        return false;
+
+    if (p < end && (*p == 'e' || *p == 'E'))
+    {
+        const char* save = p++;
+        int e;
+        if (ParseInt(p, end, e))
+            exponent += std::max(std::min(e, 1000), -1000);
+        else
+            p = save;
+    }
+
+    double result = (double)mantissa;
+    if (exponent < 0)
+        result = -exponent <= 22 ? result / powers[-exponent] : result * std::pow(10.0, exponent);
+    else if (exponent > 0)
+        result = exponent <= 22 ? result * powers[exponent] : result * std::pow(10.0, exponent);
+
+    value = (float)(negative ? -result : result);
+    return true;
+}
+
+static std::string ParseName(const char*& p, const char* end)
+{
+    SkipBlanks(p, end);
+    const char* start = p;
+    while (p < end && *p != '\n')
+        ++p;
+    const char* last = p;
+    while (last > start && IsBlank(last[-1]))
+        --last;
+    return std::string(start, last);
+}
+
+static void ParseChunk(ObjChunk& chunk)
+{
+    const char* p = chunk.Begin;
+    const char* end = chunk.End;
+    std::vector<ObjRawCorner> polygon;
+
+    while (p < end)
+    {
+        SkipBlanks(p, end);
+        if (p >= end)
+            break;
+
+        if (*p == 'v' && p + 1 < end)
+        {
+            if (IsBlank(p[1]))
+            {
+                p += 2;
+                glm::vec3 v(0.0f);
+                ParseFloat(p, end, v.x) && ParseFloat(p, end, v.y) && ParseFloat(p, end, v.z);
+                chunk.Positions.push_back(v);
+            }
+            else if (p[1] == 't' && p + 2 < end && IsBlank(p[2]))
+            {
+                p += 3;
+                glm::vec2 t(0.0f);
+                ParseFloat(p, end, t.x) && ParseFloat(p, end, t.y);
+                chunk.TexCoords.push_back(t);
+            }
+            else if (p[1] == 'n' && p + 2 < end && IsBlank(p[2]))
+            {
+                p += 3;
+                glm::vec3 n(0.0f);
+                ParseFloat(p, end, n.x) && ParseFloat(p, end, n.y) && ParseFloat(p, end, n.z);
+                chunk.Normals.push_back(n);
+            }
+        }
+        else if (*p == 'f' && p + 1 < end && IsBlank(p[1]))
+        {
+            ++p;
+            polygon.clear();
+            const unsigned int counts[3] = {
+                (unsigned int)chunk.Positions.size(), (unsigned int)chunk.TexCoords.size(), (unsigned int)chunk.Normals.size()
+            };
+
+            /* v, v/vt, v//vn or v/vt/vn */
+            while (true)
+            {
+                SkipBlanks(p, end);
+                ObjRawCorner corner = { { -1, -1, -1 }, 0, false };
+                for (int field = 0; field < 3; ++field)
+                {
+                    const char* start = p;
+                    int index;
+                    if (!ParseInt(p, end, index) || index == 0)
+                    {
+                        corner.Invalid |= p != start;
+                    }
+                    else
+                    {
+                        if (index < 0)
+                        {
+                            corner.Index[field] = (int)counts[field] + index;
+                            corner.Relative |= 1 << field;
+                        }
+                        else
+                        {
+                            corner.Index[field] = index - 1;
+                        }
+                    }
+                    if (p >= end || *p != '/')
+                        break;
+                    ++p;
+                }
+                if (corner.Index[0] == -1 && !(corner.Relative & 1) && !corner.Invalid)
+                    break;
+                polygon.push_back(corner);
+            }
+
+            /* Triangulate as a fan, OBJ polygons are expected to be convex */
+            for (size_t i = 2; i < polygon.size(); ++i)
+            {
+                chunk.Corners.push_back(polygon[0]);
+                chunk.Corners.push_back(polygon[i - 1]);
+                chunk.Corners.push_back(polygon[i]);
+            }
+            if (polygon.size() < 3)
+                ++chunk.Warnings;
+        }
+        else if (StartsWith(p, end, "usemtl", 6))
+        {
+            p += 6;
+            chunk.Switches.push_back({ (unsigned int)chunk.Corners.size() / 3, ParseName(p, end) });
+        }
+        else if (StartsWith(p, end, "mtllib", 6))
+        {
+            p += 6;
+            chunk.Libraries.push_back(ParseName(p, end));
+        }
+
+        SkipLine(p, end);
+    }
+}
+
+static inline unsigned int HashCorner(const ObjCorner& corner)
+{
+    unsigned int hash = (unsigned int)corner.Position * 0x9E3779B1u;
+    hash ^= (unsigned int)corner.TexCoord * 0x85EBCA77u;
+    hash ^= (unsigned int)corner.Normal * 0xC2B2AE3Du;
+    hash ^= hash >> 15;
+    hash *= 0x2C1B3C6Du;
+    hash ^= hash >> 12;
+    return hash;
+}
+
+/* White, not shiny, opaque and untextured */
+static ObjMaterial DefaultMaterial(const std::string& name)
+{
+    ObjMaterial material = {};
+    material.Name = name;
+    material.DiffuseColor = glm::vec3(1.0f);
+    material.SpecularColor = glm::vec3(0.0f);
+    material.SpecularExponent = 1.0f;
+    material.Opacity = 1.0f;
+    return material;
+}
+
+static std::string GetDirectory(const std::string& filePath)
+{
+    size_t slash = filePath.find_last_of("/\\");
+    return slash == std::string::npos ? "" : filePath.substr(0, slash + 1);
+}
+
+bool ObjLoader::Load(const std::string& filePath, MeshData& mesh, std::vector<ObjMaterial>* materials)
+{
+    MappedFile file;
+    if (!file.Open(filePath))
+    {
+        std::cout << "Error: failed to open '" << filePath << "'" << std::endl;
+        return false;
+    }
+
+    /* Split into chunks that end on line boundaries */
+    const char* data = (const char*)file.GetData();
+    const char* end = data + file.GetSize();
+    std::vector<ObjChunk> chunks;
+    for (const char* begin = data; begin < end;)
+    {
+        const char* chunkEnd = (size_t)(end - begin) > ObjChunkSize ? begin + ObjChunkSize : end;
+        if (chunkEnd < end)
+            SkipLine(chunkEnd, end);
+
+        chunks.emplace_back();
+        chunks.back().Begin = begin;
+        chunks.back().End = chunkEnd;
+        chunks.back().Warnings = 0;
+        begin = chunkEnd;
+    }
+
+    ParallelFor((unsigned int)chunks.size(), 1, [&](unsigned int first, unsigned int last)
+    {
+        for (unsigned int i = first; i < last; ++i)
+            ParseChunk(chunks[i]);
+    });
+
+    /* Rebase every chunk onto the totals of the chunks before it */
+    unsigned int positionCount = 0, texCoordCount = 0, normalCount = 0, cornerCount = 0, warnings = 0;
+    for (auto& chunk : chunks)
+    {
+        chunk.PositionBase = positionCount;
+        chunk.TexCoordBase = texCoordCount;
+        chunk.NormalBase = normalCount;
+        chunk.CornerBase = cornerCount;
+        positionCount += (unsigned int)chunk.Positions.size();
+        texCoordCount += (unsigned int)chunk.TexCoords.size();
+        normalCount += (unsigned int)chunk.Normals.size();
+        cornerCount += (unsigned int)chunk.Corners.size();
+        warnings += chunk.Warnings;
+    }
+
+    if (cornerCount == 0)
+    {
+        std::cout << "Warning: '" << filePath << "' contains no faces" << std::endl;
+        return false;
+    }
+
+    std::vector<glm::vec3> positions(positionCount);
+    std::vector<glm::vec2> texCoords(texCoordCount);
+    std::vector<glm::vec3> normals(normalCount);
+    std::vector<ObjCorner> corners(cornerCount);
+    std::vector<unsigned int> cornerIDs(cornerCount);
+    std::atomic<unsigned int> invalidCorners(0);
+
+    ParallelFor((unsigned int)chunks.size(), 1, [&](unsigned int first, unsigned int last)
+    {
+        for (unsigned int c = first; c < last; ++c)
+        {
+            ObjChunk& chunk = chunks[c];
+            std::copy(chunk.Positions.begin(), chunk.Positions.end(), positions.begin() + chunk.PositionBase);
+            std::copy(chunk.TexCoords.begin(), chunk.TexCoords.end(), texCoords.begin() + chunk.TexCoordBase);
+            std::copy(chunk.Normals.begin(), chunk.Normals.end(), normals.begin() + chunk.NormalBase);
+
+            const int bases[3] = { (int)chunk.PositionBase, (int)chunk.TexCoordBase, (int)chunk.NormalBase };
+            const int counts[3] = { (int)positionCount, (int)texCoordCount, (int)normalCount };
+            for (unsigned int i = 0; i < chunk.Corners.size(); ++i)
+            {
+                const ObjRawCorner& raw = chunk.Corners[i];
+                int resolved[3];
+                bool invalid = raw.Invalid;
+                for (int field = 0; field < 3; ++field)
+                {
+                    bool relative = (raw.Relative >> field) & 1;
+                    if (raw.Index[field] == -1 && !relative)
+                    {
+                        resolved[field] = -1;
+                        continue;
+                    }
+                    int index = raw.Index[field] + (relative ? bases[field] : 0);
+                    invalid |= index < 0 || index >= counts[field];
+                    resolved[field] = index;
+                }
+                if (invalid)
+                {
+                    ++invalidCorners;
+                    resolved[0] = resolved[1] = resolved[2] = -1;
+                }
+
+                unsigned int corner = chunk.CornerBase + i;
+                corners[corner] = { resolved[0], resolved[1], resolved[2] };
+                chunk.Shards[HashCorner(corners[corner]) >> (32 - ObjShardBits)].push_back(corner);
+            }
+
+            std::vector<glm::vec3>().swap(chunk.Positions);
+            std::vector<glm::vec2>().swap(chunk.TexCoords);
+            std::vector<glm::vec3>().swap(chunk.Normals);
+            std::vector<ObjRawCorner>().swap(chunk.Corners);
+        }
+    });
+
+    /* Faces pointing past any attribute stream would read out of bounds below */
+    if (invalidCorners)
+    {
+        std::cout << "Error: '" << filePath << "' has " << invalidCorners << " face corners with indices out of range" << std::endl;
+        return false;
+    }
+    if (warnings)
+        std::cout << "Warning: '" << filePath << "' has " << warnings << " faces with less than 3 vertices" << std::endl;
+
+    /* Deduplicate: every shard owns a disjoint set of keys, so shards are
+     * processed in parallel with their own open addressing table */
+    unsigned int shardUnique[ObjShardCount] = {};
+    ParallelFor(ObjShardCount, 1, [&](unsigned int first, unsigned int last)
+    {
+        for (unsigned int shard = first; shard < last; ++shard)
+        {
+            size_t total = 0;
+            for (const auto& chunk : chunks)
+                total += chunk.Shards[shard].size();
+            if (total == 0)
+                continue;
+
+            unsigned int capacity = 16;
+            while (capacity < total * 2)
+                capacity <<= 1;
+            std::vector<unsigned int> table(capacity, ObjInvalid);    // first corner with that key
+            std::vector<unsigned int> tableIDs(capacity);
+
+            unsigned int unique = 0;
+            for (const auto& chunk : chunks)
+            {
+                for (unsigned int corner : chunk.Shards[shard])
+                {
+                    unsigned int slot = HashCorner(corners[corner]) & (capacity - 1);
+                    while (table[slot] != ObjInvalid && !(corners[table[slot]] == corners[corner]))
+                        slot = (slot + 1) & (capacity - 1);
+
+                    if (table[slot] == ObjInvalid)
+                    {
+                        table[slot] = corner;
+                        tableIDs[slot] = unique++;
+                    }
+                    cornerIDs[corner] = tableIDs[slot];
+                }
+            }
+            shardUnique[shard] = unique;
+        }
+    });
+
+    unsigned int shardBase[ObjShardCount];
+    unsigned int vertexCount = 0;
+    for (unsigned int shard = 0; shard < ObjShardCount; ++shard)
+    {
+        shardBase[shard] = vertexCount;
+        vertexCount += shardUnique[shard];
+    }
+
+    /* Renumber vertices in order of first use, which keeps the vertex fetch
+     * order close to the index order. This pass is a plain array lookup */
+    std::vector<unsigned int> remap(vertexCount, ObjInvalid);
+    std::vector<unsigned int> firstCorner(vertexCount);
+    mesh = MeshData();
+    mesh.Indices.resize(cornerCount);
+    unsigned int next = 0;
+    for (unsigned int corner = 0; corner < cornerCount; ++corner)
+    {
+        unsigned int shard = HashCorner(corners[corner]) >> (32 - ObjShardBits);
+        unsigned int& id = remap[shardBase[shard] + cornerIDs[corner]];
+        if (id == ObjInvalid)
+        {
+            id = next++;
+            firstCorner[id] = corner;
+        }
+        mesh.Indices[corner] = id;
+    }
+
+    mesh.Layout.Push<float>(3);
+    mesh.Layout.Push<float>(2);
+    mesh.Layout.Push<float>(3);
+    mesh.Vertices.resize((size_t)vertexCount * mesh.Layout.GetStride());
+
+    ParallelFor(vertexCount, 1 << 16, [&](unsigned int first, unsigned int last)
+    {
+        for (unsigned int v = first; v < last; ++v)
+        {
+            const ObjCorner& corner = corners[firstCorner[v]];
+            float* vertex = (float*)&mesh.Vertices[(size_t)v * mesh.Layout.GetStride()];
+            const glm::vec3& p = positions[corner.Position];
+            glm::vec2 t = corner.TexCoord >= 0 ? texCoords[corner.TexCoord] : glm::vec2(0.0f);
+            glm::vec3 n = corner.Normal >= 0 ? normals[corner.Normal] : glm::vec3(0.0f);
+            vertex[0] = p.x; vertex[1] = p.y; vertex[2] = p.z;
+            vertex[3] = t.x; vertex[4] = t.y;
+            vertex[5] = n.x; vertex[6] = n.y; vertex[7] = n.z;
+        }
+    });
+
+    /* One SubMesh per usemtl, material indices in order of first use */
+    std::vector<std::string> materialNames;
+    std::vector<std::string> libraries;
+    auto getMaterial = [&](const std::string& name) -> unsigned int
+    {
+        for (unsigned int i = 0; i < materialNames.size(); ++i)
+            if (materialNames[i] == name)
+                return i;
+        materialNames.push_back(name);
+        return (unsigned int)materialNames.size() - 1;
+    };
+
+    const BoundingBox empty = { glm::vec3(FLT_MAX), glm::vec3(-FLT_MAX) };
+    for (const auto& chunk : chunks)
+    {
+        libraries.insert(libraries.end(), chunk.Libraries.begin(), chunk.Libraries.end());
+        for (const auto& materialSwitch : chunk.Switches)
+        {
+            unsigned int firstIndex = chunk.CornerBase + materialSwitch.Triangle * 3;
+            unsigned int material = getMaterial(materialSwitch.Name);
+
+            if (!mesh.SubMeshes.empty() && mesh.SubMeshes.back().FirstIndex == firstIndex)
+            {
+                mesh.SubMeshes.back().MaterialIndex = material;
+            }
+            else
+            {
+                /* Faces before the first usemtl get a default material */
+                if (mesh.SubMeshes.empty() && firstIndex > 0)
+                    mesh.SubMeshes.push_back({ 0, 0, getMaterial("default"), empty });
+                mesh.SubMeshes.push_back({ firstIndex, 0, material, empty });
+            }
+        }
+    }
+    if (mesh.SubMeshes.empty())
+        mesh.SubMeshes.push_back({ 0, 0, getMaterial("default"), empty });
+    for (size_t i = 0; i < mesh.SubMeshes.size(); ++i)
+    {
+        unsigned int last = i + 1 < mesh.SubMeshes.size() ? mesh.SubMeshes[i + 1].FirstIndex : cornerCount;
+        mesh.SubMeshes[i].IndexCount = last - mesh.SubMeshes[i].FirstIndex;
+    }
+
+    ParallelFor((unsigned int)mesh.SubMeshes.size(), 1, [&](unsigned int first, unsigned int last)
+    {
+        for (unsigned int s = first; s < last; ++s)
+        {
+            SubMesh& subMesh = mesh.SubMeshes[s];
+            for (unsigned int i = subMesh.FirstIndex; i < subMesh.FirstIndex + subMesh.IndexCount; ++i)
+            {
+                subMesh.Bounds.Min = glm::min(subMesh.Bounds.Min, mesh.GetPosition(mesh.Indices[i]));
+                subMesh.Bounds.Max = glm::max(subMesh.Bounds.Max, mesh.GetPosition(mesh.Indices[i]));
+            }
+        }
+    });
+
+    /* Drop empty ranges, e.g. two usemtl in a row at the end of the file */
+    std::vector<SubMesh> subMeshes;
+    mesh.Bounds = empty;
+    for (const auto& subMesh : mesh.SubMeshes)
+    {
+        if (subMesh.IndexCount == 0)
+            continue;
+        subMeshes.push_back(subMesh);
+        mesh.Bounds.Min = glm::min(mesh.Bounds.Min, subMesh.Bounds.Min);
+        mesh.Bounds.Max = glm::max(mesh.Bounds.Max, subMesh.Bounds.Max);
+    }
+    mesh.SubMeshes.swap(subMeshes);
+
+    if (materials)
+    {
+        std::vector<ObjMaterial> library;
+        for (const auto& name : libraries)
+            LoadMaterials(GetDirectory(filePath) + name, library);
+
+        materials->clear();
+        for (const auto& name : materialNames)
+        {
+            ObjMaterial material = DefaultMaterial(name);
+            for (const auto& candidate : library)
+            {
+                if (candidate.Name == name)
+                {
+                    material = candidate;
+                    break;
+                }
+            }
+            materials->push_back(material);
+        }
+    }
+    return true;
+}
+
+bool ObjLoader::LoadMaterials(const std::string& filePath, std::vector<ObjMaterial>& materials)
+{
+    MappedFile file;
+    if (!file.Open(filePath))
+    {
+        std::cout << "Warning: failed to open material library '" << filePath << "'" << std::endl;
+        return false;
+    }
+
+    std::string directory = GetDirectory(filePath);
+    const char* p = (const char*)file.GetData();
+    const char* end = p + file.GetSize();
+    ObjMaterial* current = nullptr;
+
+    while (p < end)
+    {
+        SkipBlanks(p, end);
+        if (StartsWith(p, end, "newmtl", 6))
+        {
+            p += 6;
+            materials.push_back(DefaultMaterial(ParseName(p, end)));
+            current = &materials.back();
+        }
+        else if (current)
+        {
+            if (StartsWith(p, end, "Kd", 2))
+            {
+                p += 2;
+                ParseFloat(p, end, current->DiffuseColor.r) && ParseFloat(p, end, current->DiffuseColor.g) && ParseFloat(p, end, current->DiffuseColor.b);
+            }
+            else if (StartsWith(p, end, "Ks", 2))
+            {
+                p += 2;
+                ParseFloat(p, end, current->SpecularColor.r) && ParseFloat(p, end, current->SpecularColor.g) && ParseFloat(p, end, current->SpecularColor.b);
+            }
+            else if (StartsWith(p, end, "Ns", 2))
+            {
+                p += 2;
+                ParseFloat(p, end, current->SpecularExponent);
+            }
+            else if (StartsWith(p, end, "d", 1))
+            {
+                p += 1;
+                ParseFloat(p, end, current->Opacity);
+            }
+            else if (StartsWith(p, end, "Tr", 2))
+            {
+                p += 2;
+                float transparency;
+                if (ParseFloat(p, end, transparency))
+                    current->Opacity = 1.0f - transparency;
+            }
+            /* Texture options (-bm, -s...) are not supported, the rest of the line is the path */
+            else if (StartsWith(p, end, "map_Kd", 6))
+            {
+                p += 6;
+                current->DiffuseTexture = directory + ParseName(p, end);
+            }
+            else if (StartsWith(p, end, "map_Ks", 6))
+            {
+                p += 6;
+                current->SpecularTexture = directory + ParseName(p, end);
+            }
+            else if (StartsWith(p, end, "map_Bump", 8) || StartsWith(p, end, "map_bump", 8))
+            {
+                p += 8;
+                current->NormalTexture = directory + ParseName(p, end);
+            }
+            else if (StartsWith(p, end, "bump", 4))
+            {
+                p += 4;
+                current->NormalTexture = directory + ParseName(p, end);
+            }
+        }
+        SkipLine(p, end);
+    }
+    return true;
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <string>
+#include <vector>
+
+#include "MeshData.h"
+
+/* Subset of MTL that maps onto our shaders, texture paths are resolved
+ * relative to the .mtl file */
+struct ObjMaterial
+{
+	std::string Name;
+	glm::vec3 DiffuseColor;
+	glm::vec3 SpecularColor;
+	float SpecularExponent;
+	float Opacity;
+	std::string DiffuseTexture;
+	std::string SpecularTexture;
+	std::string NormalTexture;
+};
+
+/* Wavefront OBJ/MTL importer. Produces an indexed mesh with a float3 position,
+ * float2 texture coordinate and float3 normal per vertex, one SubMesh per usemtl.
+ *
+ * The file is memory mapped and split into line-aligned chunks that are parsed in
+ * parallel, then position/uv/normal tuples are deduplicated in parallel hash shards.
+ */
+class ObjLoader
+{
+public:
+	static bool Load(const std::string& filePath, MeshData& mesh, std::vector<ObjMaterial>* materials = nullptr);
+
+	static bool LoadMaterials(const std::string& filePath, std::vector<ObjMaterial>& materials);
+};
@@ -0,0 +1,186 @@
+#include "OcclusionCuller.h"
+
+#include "Renderer.h"
+#include "VertexBufferLayout.h"
+
+const unsigned int OcclusionCuller::QueryLatency;
+
+static const float CubeVertices[] = {
+    -1.0f, -1.0f, -1.0f,
+     1.0f, -1.0f, -1.0f,
+     1.0f,  1.0f, -1.0f,
+    -1.0f,  1.0f, -1.0f,
+    -1.0f, -1.0f,  1.0f,
+     1.0f, -1.0f,  1.0f,
+     1.0f,  1.0f,  1.0f,
+    -1.0f,  1.0f,  1.0f
+};
+
+static const unsigned int CubeIndices[] = {
+    0, 2, 1,  2, 0, 3,  // back
+    4, 5, 6,  6, 7, 4,  // front
+    0, 4, 7,  7, 3, 0,  // left
+    1, 2, 6,  6, 5, 1,  // right
+    0, 1, 5,  5, 4, 0,  // bottom
+    3, 7, 6,  6, 2, 3   // top
+};
+
+/* Boxes this close to the camera may be cut by the near plane, treat them as visible */
+static const float NearMargin = 0.5f;
+
+OcclusionCuller::OcclusionCuller(const std::string& shaderPath)
+    : m_Frame(0), m_VisibleQueryInterval(4), m_ViewProjection(1.0f), m_CameraPosition(0.0f), m_CullFace(false), m_DepthTest(false),
+      m_Shader(shaderPath),
+      m_VertexBuffer(CubeVertices, sizeof(CubeVertices)),
+      m_IndexBuffer(CubeIndices, sizeof(CubeIndices) / sizeof(unsigned int)),
+      m_QueryCount(0)
+{
+    /* Conservative queries may skip the exact per-sample test, which is all we need */
+    m_QueryTarget = GLEW_VERSION_4_3 || GLEW_ARB_ES3_compatibility
+        ? GL_ANY_SAMPLES_PASSED_CONSERVATIVE : GL_ANY_SAMPLES_PASSED;
+
+    VertexBufferLayout layout;
+    layout.Push<float>(3);
+    m_VertexArray.AddBuffer(m_VertexBuffer, layout);
+    m_IndexBuffer.Bind();
+    m_VertexArray.Unbind();
+}
+
+OcclusionCuller::~OcclusionCuller()
+{
+    for (auto& object : m_Objects)
+    {
+        GLCall(glDeleteQueries(QueryLatency, object.Queries));
+    }
+}
+
+bool OcclusionCuller::IsConservative() const
+{
+    return m_QueryTarget == GL_ANY_SAMPLES_PASSED_CONSERVATIVE;
+}
+
+unsigned int OcclusionCuller::AddObject()
+{
+    Object object = {};
+    GLCall(glGenQueries(QueryLatency, object.Queries));
+    object.LastQueryFrame = 0xffffffff;
+    object.Visible = true;
+    m_Objects.push_back(object);
+    return (unsigned int)m_Objects.size() - 1;
+}
+
+void OcclusionCuller::BeginFrame(const glm::mat4& viewProjection, const glm::vec3& cameraPosition)
+{
+    ++m_Frame;
+    m_ViewProjection = viewProjection;
+    m_CameraPosition = cameraPosition;
+    m_QueryCount = 0;
+
+    /* Oldest query first, results become available in issue order */
+    for (auto& object : m_Objects)
+    {
+        for (unsigned int i = 0; i < QueryLatency; ++i)
+        {
+            unsigned int slot = (object.Next + i) % QueryLatency;
+            if (!object.Pending[slot])
+                continue;
+
+            GLuint available = 0;
+            GLCall(glGetQueryObjectuiv(object.Queries[slot], GL_QUERY_RESULT_AVAILABLE, &available));
+            if (!available)
+                break;
+
+            GLuint samples = 0;
+            GLCall(glGetQueryObjectuiv(object.Queries[slot], GL_QUERY_RESULT, &samples));
+            object.Visible = samples != 0;
+            object.Pending[slot] = false;
+        }
+    }
+}
+
+bool OcclusionCuller::NeedsQuery(unsigned int object) const
+{
+    const Object& current = m_Objects[object];
+    if (current.LastQueryFrame == m_Frame)
+        return false;
+    if (!current.Visible)
+        return true;
+    return (m_Frame + object) % m_VisibleQueryInterval == 0;
+}
+
+void OcclusionCuller::BeginQueries()
+{
+    GLCall(glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE));
+    GLCall(glDepthMask(GL_FALSE));
+    GLCall(m_CullFace = glIsEnabled(GL_CULL_FACE) == GL_TRUE);
+    GLCall(glDisable(GL_CULL_FACE));
+    /* Without it every box passes */
+    GLCall(m_DepthTest = glIsEnabled(GL_DEPTH_TEST) == GL_TRUE);
+    GLCall(glEnable(GL_DEPTH_TEST));
+
+    m_Shader.Bind();
+    m_Shader.SetUniformMat4f("u_ViewProjection", m_ViewProjection);
+    m_VertexArray.Bind();
+}
+
+void OcclusionCuller::Query(unsigned int object, const BoundingBox& bounds)
+{
+    Object& current = m_Objects[object];
+
+    glm::vec3 extents = bounds.GetExtents() + glm::vec3(NearMargin);
+    glm::vec3 offset = glm::abs(m_CameraPosition - bounds.GetCenter());
+    if (offset.x <= extents.x && offset.y <= extents.y && offset.z <= extents.z)
+    {
+        current.Visible = true;
+        return;
+    }
+
+    /* Reusing a slot whose result never arrived just drops that old result */
+    unsigned int slot = current.Next;
+    current.Next = (slot + 1) % QueryLatency;
+    current.Pending[slot] = true;
+    current.LastQueryFrame = m_Frame;
+
+    glm::vec3 center = bounds.GetCenter();
+    extents = bounds.GetExtents();
+    m_Shader.SetUniform4f("u_Center", center.x, center.y, center.z, 0.0f);
+    m_Shader.SetUniform4f("u_Extents", extents.x, extents.y, extents.z, 0.0f);
+
+    GLCall(glBeginQuery(m_QueryTarget, current.Queries[slot]));
+    GLCall(glDrawElements(GL_TRIANGLES, m_IndexBuffer.GetCount(), GL_UNSIGNED_INT, nullptr));
+    GLCall(glEndQuery(m_QueryTarget));
+    ++m_QueryCount;
+}
+
+void OcclusionCuller::EndQueries()
+{
+    m_VertexArray.Unbind();
+    m_Shader.Unbind();
+
+    GLCall(glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE));
+    GLCall(glDepthMask(GL_TRUE));
+    if (m_CullFace)
+    {
+        GLCall(glEnable(GL_CULL_FACE));
+    }
+    if (!m_DepthTest)
+    {
+        GLCall(glDisable(GL_DEPTH_TEST));
+    }
+}
+
+bool OcclusionCuller::BeginConditionalRender(unsigned int object) const
+{
+    const Object& current = m_Objects[object];
+    if (current.LastQueryFrame != m_Frame)
+        return false;
+
+    unsigned int slot = (current.Next + QueryLatency - 1) % QueryLatency;
+    GLCall(glBeginConditionalRender(current.Queries[slot], GL_QUERY_NO_WAIT));
+    return true;
+}
+
+void OcclusionCuller::EndConditionalRender() const
+{
+    GLCall(glEndConditionalRender());
+}
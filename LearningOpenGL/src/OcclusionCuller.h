@@ -0,0 +1,96 @@
+#pragma once
+#include <string>
+#include <vector>
+
+#include "MeshData.h"
+#include "Shader.h"
+#include "VertexArray.h"
+#include "VertexBuffer.h"
+#include "IndexBuffer.h"
+
+/* Hardware occlusion culling with temporal coherence. Every object gets a small ring
+ * of queries so results are read back frames later, when they are ready, never
+ * stalling the pipeline. A frame looks like:
+ *
+ *   culler.BeginFrame(viewProjection, cameraPosition);
+ *   draw every object with culler.IsVisible(i)            // last known visible, the occluders
+ *   culler.BeginQueries();
+ *   culler.Query(i, bounds) for objects with NeedsQuery(i)
+ *   culler.EndQueries();
+ *   for objects that were hidden: if (culler.BeginConditionalRender(i)) { draw; culler.EndConditionalRender(); }
+ *
+ * Hidden objects are only drawn when the GPU finds their box visible this frame,
+ * without the CPU ever waiting for the answer.
+ */
+class OcclusionCuller
+{
+public:
+	static const unsigned int QueryLatency = 3;
+
+private:
+	struct Object
+	{
+		unsigned int Queries[QueryLatency];
+		bool Pending[QueryLatency];
+		unsigned int Next;
+		unsigned int LastQueryFrame;
+		bool Visible;
+	};
+
+	std::vector<Object> m_Objects;
+
+	unsigned int m_QueryTarget;
+	unsigned int m_Frame;
+	unsigned int m_VisibleQueryInterval;
+
+	glm::mat4 m_ViewProjection;
+	glm::vec3 m_CameraPosition;
+	bool m_CullFace;
+	bool m_DepthTest;
+
+	Shader m_Shader;
+	VertexBuffer m_VertexBuffer;
+	IndexBuffer m_IndexBuffer;
+	VertexArray m_VertexArray;
+
+	unsigned int m_QueryCount;
+
+public:
+	OcclusionCuller(const std::string& shaderPath = "res/shaders/BoundingBox.shader");
+
+	~OcclusionCuller();
+
+	/* New objects start out visible */
+	unsigned int AddObject();
+
+	inline unsigned int GetObjectCount() const { return (unsigned int)m_Objects.size(); }
+
+	/* Collects every query result that is already available */
+	void BeginFrame(const glm::mat4& viewProjection, const glm::vec3& cameraPosition);
+
+	inline bool IsVisible(unsigned int object) const { return m_Objects[object].Visible; }
+
+	/* Hidden objects are tested every frame, visible ones only every few frames, nothing
+	 * is tested twice in a frame */
+	bool NeedsQuery(unsigned int object) const;
+
+	/* Binds the box shader, disables color and depth writes and enables the depth test,
+	 * EndQueries restores the previous state */
+	void BeginQueries();
+
+	void Query(unsigned int object, const BoundingBox& bounds);
+
+	void EndQueries();
+
+	/* Returns false when the object has no query this frame, draw it normally then */
+	bool BeginConditionalRender(unsigned int object) const;
+
+	void EndConditionalRender() const;
+
+	// Visible objects are re-tested every interval frames, spread out over the frames
+	inline void SetVisibleQueryInterval(unsigned int interval) { m_VisibleQueryInterval = interval ? interval : 1; }
+
+	inline unsigned int GetQueryCount() const { return m_QueryCount; }
+
+	bool IsConservative() const;
+};
@@ -0,0 +1,53 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "JobSystem.h"
+
+/* Runs function(begin, end) over [0, count) split into batches of batchSize items,
+ * on the calling thread plus the job system workers, or up to hardware_concurrency - 1
+ * helper threads when no JobSystem exists. Batches are handed out dynamically so
+ * uneven work still balances.
+ */
+template<typename Function>
+void ParallelFor(unsigned int count, unsigned int batchSize, Function function)
+{
+	if (count == 0)
+		return;
+	batchSize = std::max(batchSize, 1u);
+
+	if (JobSystem* jobs = JobSystem::Get())
+	{
+		jobs->ParallelFor(count, batchSize, function);
+		return;
+	}
+
+	unsigned int batches = (count + batchSize - 1) / batchSize;
+	unsigned int threads = std::min(std::max(std::thread::hardware_concurrency(), 1u), batches);
+	if (threads <= 1)
+	{
+		function(0u, count);
+		return;
+	}
+
+	std::atomic<unsigned int> next(0);
+	auto worker = [&]()
+	{
+		for (unsigned int batch = next++; batch < batches; batch = next++)
+		{
+			unsigned int begin = batch * batchSize;
+			function(begin, std::min(begin + batchSize, count));
+		}
+	};
+
+	std::vector<std::thread> helpers;
+	helpers.reserve(threads - 1);
+	for (unsigned int i = 1; i < threads; ++i)
+		helpers.emplace_back(worker);
+
+	worker();
+	for (auto& helper : helpers)
+		helper.join();
+}
@@ -0,0 +1,407 @@
+#include "Profiler.h"
+#include "Renderer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+
+const unsigned int Profiler::EventsPerTrack;
+const unsigned int Profiler::FrameHistory;
+const unsigned int GpuProfiler::FrameLatency;
+const unsigned int GpuProfiler::MaxZones;
+
+static_assert((Profiler::EventsPerTrack & (Profiler::EventsPerTrack - 1)) == 0, "EventsPerTrack must be a power of two");
+
+namespace {
+
+    /* One writer per track, readers copy and drop whatever may have been overwritten meanwhile */
+    struct Track
+    {
+        char Name[32];
+        unsigned int Depth;
+        std::atomic<unsigned long long> Written;
+        std::atomic<unsigned long long> First;  // first event of the current owner
+        ProfileEvent Events[Profiler::EventsPerTrack];
+    };
+
+    const std::chrono::steady_clock::time_point s_Epoch = std::chrono::steady_clock::now();
+
+    std::mutex s_TracksMutex;
+    std::vector<Track*> s_Tracks;
+    std::vector<unsigned int> s_FreeTracks;  // of exited threads
+
+    thread_local Track* t_Track = nullptr;
+
+    /* Hands the thread's track back on exit, so threads coming and going don't pile up tracks */
+    struct ThreadTrackOwner
+    {
+        bool Owned = false;
+        unsigned int Index = 0;
+
+        ~ThreadTrackOwner()
+        {
+            if (!Owned)
+                return;
+            std::lock_guard<std::mutex> lock(s_TracksMutex);
+            s_FreeTracks.push_back(Index);
+        }
+    };
+
+    thread_local ThreadTrackOwner t_TrackOwner;
+
+    unsigned long long s_FrameStarts[Profiler::FrameHistory];
+    std::atomic<unsigned int> s_FrameCount(0);
+
+    /* Without a name the track is called after its index */
+    Track* AddTrack(const char* name, unsigned int& index)
+    {
+        // Tracks are never freed, readers may still be copying from one after its thread exited
+        Track* track = new Track();
+
+        std::lock_guard<std::mutex> lock(s_TracksMutex);
+        index = (unsigned int)s_Tracks.size();
+        if (name)
+            std::snprintf(track->Name, sizeof(track->Name), "%s", name);
+        else
+            std::snprintf(track->Name, sizeof(track->Name), "Thread %u", index);
+        s_Tracks.push_back(track);
+        return track;
+    }
+
+    /* Reuses the track of an exited thread if there is one. Its old events are hidden
+     * rather than cleared, a reader may be copying them right now */
+    Track* AcquireThreadTrack(unsigned int& index)
+    {
+        {
+            std::lock_guard<std::mutex> lock(s_TracksMutex);
+            if (!s_FreeTracks.empty())
+            {
+                index = s_FreeTracks.back();
+                s_FreeTracks.pop_back();
+
+                Track* track = s_Tracks[index];
+                std::snprintf(track->Name, sizeof(track->Name), "Thread %u", index);
+                track->Depth = 0;
+                track->First.store(track->Written.load(std::memory_order_relaxed), std::memory_order_release);
+                return track;
+            }
+        }
+        return AddTrack(nullptr, index);
+    }
+
+    Track& GetThreadTrack()
+    {
+        if (!t_Track)
+        {
+            t_Track = AcquireThreadTrack(t_TrackOwner.Index);
+            t_TrackOwner.Owned = true;
+        }
+        return *t_Track;
+    }
+
+    inline void Write(Track& track, unsigned int index, const char* name, unsigned long long start, unsigned long long end, unsigned int depth)
+    {
+        unsigned long long written = track.Written.load(std::memory_order_relaxed);
+        ProfileEvent& event = track.Events[written & (Profiler::EventsPerTrack - 1)];
+        event.Name = name;
+        event.Start = start;
+        event.End = end;
+        event.Depth = depth;
+        event.Track = index;
+        track.Written.store(written + 1, std::memory_order_release);
+    }
+
+    void Collect(Track& track, std::vector<ProfileEvent>& events, unsigned long long since)
+    {
+        unsigned long long owner = track.First.load(std::memory_order_acquire);
+        unsigned long long written = track.Written.load(std::memory_order_acquire);
+        unsigned long long first = written > Profiler::EventsPerTrack ? written - Profiler::EventsPerTrack : 0;
+        first = std::max(first, owner);
+
+        size_t offset = events.size();
+        for (unsigned long long i = first; i < written; ++i)
+            events.push_back(track.Events[i & (Profiler::EventsPerTrack - 1)]);
+
+        /* The writer may have lapped us while copying */
+        unsigned long long after = track.Written.load(std::memory_order_acquire);
+        unsigned long long valid = after > Profiler::EventsPerTrack ? after - Profiler::EventsPerTrack : 0;
+        size_t skip = valid > first ? (size_t)std::min(valid - first, written - first) : 0;
+        events.erase(events.begin() + offset, events.begin() + offset + skip);
+
+        events.erase(std::remove_if(events.begin() + offset, events.end(),
+            [since](const ProfileEvent& event) { return event.End < since; }), events.end());
+    }
+
+    void WriteJsonString(std::ofstream& stream, const char* text)
+    {
+        stream << '"';
+        for (const char* c = text; *c; ++c)
+        {
+            if (*c == '"' || *c == '\\')
+                stream << '\\' << *c;
+            else if ((unsigned char)*c >= 0x20)
+                stream << *c;
+        }
+        stream << '"';
+    }
+
+}
+
+unsigned long long Profiler::GetTime()
+{
+    return (unsigned long long)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - s_Epoch).count();
+}
+
+void Profiler::SetThreadName(const char* name)
+{
+    Track& track = GetThreadTrack();
+    std::lock_guard<std::mutex> lock(s_TracksMutex);
+    std::snprintf(track.Name, sizeof(track.Name), "%s", name);
+}
+
+unsigned int Profiler::CreateTrack(const char* name)
+{
+    unsigned int index;
+    AddTrack(name, index);
+    return index;
+}
+
+void Profiler::Record(unsigned int track, const char* name, unsigned long long start, unsigned long long end, unsigned int depth)
+{
+    Track* target;
+    {
+        std::lock_guard<std::mutex> lock(s_TracksMutex);
+        ASSERT(track < s_Tracks.size());
+        target = s_Tracks[track];
+    }
+    Write(*target, track, name, start, end, depth);
+}
+
+void Profiler::BeginFrame()
+{
+    unsigned long long now = GetTime();
+    unsigned int frame = s_FrameCount.load(std::memory_order_relaxed);
+    if (frame > 0)
+    {
+        Track& track = GetThreadTrack();
+        Write(track, (unsigned int)-1, "Frame", s_FrameStarts[(frame - 1) % FrameHistory], now, track.Depth);
+    }
+    s_FrameStarts[frame % FrameHistory] = now;
+    s_FrameCount.store(frame + 1, std::memory_order_release);
+}
+
+void Profiler::GetFrameTimes(std::vector<unsigned long long>& durations, unsigned int count)
+{
+    durations.clear();
+    unsigned int frames = s_FrameCount.load(std::memory_order_acquire);
+    if (frames < 2)
+        return;
+
+    count = std::min(count, std::min(frames - 1, FrameHistory - 1));
+    for (unsigned int i = frames - 1 - count; i < frames - 1; ++i)
+        durations.push_back(s_FrameStarts[(i + 1) % FrameHistory] - s_FrameStarts[i % FrameHistory]);
+}
+
+void Profiler::CollectEvents(std::vector<ProfileEvent>& events, unsigned long long since)
+{
+    std::vector<Track*> tracks;
+    {
+        std::lock_guard<std::mutex> lock(s_TracksMutex);
+        tracks = s_Tracks;
+    }
+
+    events.clear();
+    for (unsigned int i = 0; i < tracks.size(); ++i)
+    {
+        size_t offset = events.size();
+        Collect(*tracks[i], events, since);
+        // Frame markers are written without knowing their own index
+        for (size_t j = offset; j < events.size(); ++j)
+            events[j].Track = i;
+    }
+}
+
+unsigned int Profiler::Enter()
+{
+    return GetThreadTrack().Depth++;
+}
+
+void Profiler::Leave(const char* name, unsigned long long start)
+{
+    unsigned long long end = GetTime();
+    Track& track = *t_Track;
+    --track.Depth;
+    Write(track, (unsigned int)-1, name, start, end, track.Depth);
+}
+
+bool Profiler::ExportChromeTrace(const std::string& filePath)
+{
+    std::ofstream stream(filePath);
+    if (!stream)
+    {
+        std::cout << "Error: Failed to write trace " << filePath << std::endl;
+        return false;
+    }
+
+    std::vector<ProfileEvent> events;
+    CollectEvents(events);
+
+    stream << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    {
+        std::lock_guard<std::mutex> lock(s_TracksMutex);
+        for (unsigned int i = 0; i < s_Tracks.size(); ++i)
+        {
+            stream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << i << ",\"args\":{\"name\":";
+            WriteJsonString(stream, s_Tracks[i]->Name);
+            stream << "}},\n{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":1,\"tid\":" << i
+                << ",\"args\":{\"sort_index\":" << i << "}}" << (events.empty() && i + 1 == s_Tracks.size() ? "\n" : ",\n");
+        }
+    }
+
+    /* Chrome wants microseconds, keep the nanoseconds as decimals */
+    char number[32];
+    for (size_t i = 0; i < events.size(); ++i)
+    {
+        const ProfileEvent& event = events[i];
+        stream << "{\"name\":";
+        WriteJsonString(stream, event.Name);
+        std::snprintf(number, sizeof(number), "%llu.%03llu", event.Start / 1000, event.Start % 1000);
+        stream << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.Track << ",\"ts\":" << number;
+        unsigned long long duration = event.End > event.Start ? event.End - event.Start : 0;
+        std::snprintf(number, sizeof(number), "%llu.%03llu", duration / 1000, duration % 1000);
+        stream << ",\"dur\":" << number << (i + 1 < events.size() ? "},\n" : "}\n");
+    }
+    stream << "]}\n";
+
+    return (bool)stream;
+}
+
+GpuProfiler* GpuProfiler::s_Instance = nullptr;
+
+GpuProfiler::GpuProfiler()
+    : m_Frame(0), m_Depth(0), m_OpenCount(0), m_ClockOffset(0), m_FrameTime(0)
+{
+    ASSERT(!s_Instance);
+    s_Instance = this;
+
+    for (Frame& frame : m_Frames)
+    {
+        GLCall(glGenQueries(MaxZones * 2, frame.Queries));
+        frame.ZoneCount = 0;
+        frame.LastQuery = 0;
+    }
+
+    /* Core since 4.3, 3.3 drivers usually still expose it */
+    m_DebugGroups = GLEW_VERSION_4_3 || GLEW_KHR_debug;
+    m_Track = Profiler::CreateTrack("GPU");
+    Calibrate();
+}
+
+GpuProfiler::~GpuProfiler()
+{
+    for (Frame& frame : m_Frames)
+    {
+        GLCall(glDeleteQueries(MaxZones * 2, frame.Queries));
+    }
+    s_Instance = nullptr;
+}
+
+void GpuProfiler::Calibrate()
+{
+    /* GL_TIMESTAMP queried directly does not wait for the GPU */
+    GLint64 gpuTime = 0;
+    GLCall(glGetInteger64v(GL_TIMESTAMP, &gpuTime));
+    m_ClockOffset = (long long)Profiler::GetTime() - gpuTime;
+}
+
+bool GpuProfiler::BeginFrame()
+{
+    ASSERT(m_OpenCount == 0);
+
+    // The GPU clock drifts slowly against the CPU clock
+    if (++m_Frame % 256 == 0)
+        Calibrate();
+
+    Frame& frame = m_Frames[m_Frame % FrameLatency];
+    bool collected = ReadBack(frame);
+    frame.ZoneCount = 0;
+    return collected;
+}
+
+bool GpuProfiler::ReadBack(Frame& frame)
+{
+    if (frame.ZoneCount == 0)
+        return false;
+
+    /* Queries finish in order, if the last one is not ready the driver is too far behind
+     * and the frame is dropped instead of stalling */
+    GLuint available = 0;
+    GLCall(glGetQueryObjectuiv(frame.Queries[frame.LastQuery], GL_QUERY_RESULT_AVAILABLE, &available));
+    if (!available)
+        return false;
+
+    m_FrameTime = 0;
+    for (unsigned int i = 0; i < frame.ZoneCount; ++i)
+    {
+        GLuint64 begin = 0, end = 0;
+        GLCall(glGetQueryObjectui64v(frame.Queries[i * 2], GL_QUERY_RESULT, &begin));
+        GLCall(glGetQueryObjectui64v(frame.Queries[i * 2 + 1], GL_QUERY_RESULT, &end));
+        if (frame.Zones[i].Depth == 0 && end > begin)
+            m_FrameTime += end - begin;
+
+        long long start = (long long)begin + m_ClockOffset;
+        long long finish = (long long)end + m_ClockOffset;
+        if (start < 0 || finish < start)
+            continue;
+        Profiler::Record(m_Track, frame.Zones[i].Name, (unsigned long long)start, (unsigned long long)finish, frame.Zones[i].Depth);
+    }
+    return true;
+}
+
+void GpuProfiler::Begin(const char* name)
+{
+    ASSERT(m_OpenCount < MaxZones);
+
+    if (m_DebugGroups)
+    {
+        GLCall(glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0, -1, name));
+    }
+
+    Frame& frame = m_Frames[m_Frame % FrameLatency];
+    unsigned int zone = MaxZones;
+    if (frame.ZoneCount < MaxZones)
+    {
+        zone = frame.ZoneCount++;
+        frame.Zones[zone].Name = name;
+        frame.Zones[zone].Depth = m_Depth;
+        frame.LastQuery = zone * 2;
+        GLCall(glQueryCounter(frame.Queries[zone * 2], GL_TIMESTAMP));
+    }
+    m_Open[m_OpenCount++] = zone;
+    ++m_Depth;
+}
+
+void GpuProfiler::End()
+{
+    ASSERT(m_OpenCount > 0);
+
+    --m_Depth;
+    unsigned int zone = m_Open[--m_OpenCount];
+    if (zone < MaxZones)
+    {
+        Frame& frame = m_Frames[m_Frame % FrameLatency];
+        frame.LastQuery = zone * 2 + 1;
+        GLCall(glQueryCounter(frame.Queries[zone * 2 + 1], GL_TIMESTAMP));
+    }
+
+    if (m_DebugGroups)
+    {
+        GLCall(glPopDebugGroup());
+    }
+}
@@ -0,0 +1,184 @@
+#pragma once
+#include <string>
+#include <vector>
+
+/* Scoped CPU markers, cheap enough to leave on: a zone is two clock reads and a store
+ * into a ring owned by the calling thread, no locks. Rings keep the most recent
+ * events of every thread (the rolling history) and can be exported as a Chrome
+ * trace_event file for chrome://tracing or Perfetto. The ring of an exited thread is
+ * handed to the next new one.
+ *
+ *   void Update()
+ *   {
+ *       PROFILE_SCOPE("Update");
+ *       ...
+ *   }
+ *
+ * Names must be string literals (or otherwise outlive the profiler), only the
+ * pointer is stored.
+ */
+struct ProfileEvent
+{
+	const char* Name;
+	unsigned long long Start;  // nanoseconds since Profiler start
+	unsigned long long End;
+	unsigned int Depth;
+	unsigned int Track;
+};
+
+class Profiler
+{
+public:
+	static const unsigned int EventsPerTrack = 1 << 16;
+	static const unsigned int FrameHistory = 256;
+
+	static unsigned long long GetTime();
+
+	/* Shows up as the thread's name in the trace */
+	static void SetThreadName(const char* name);
+
+	/* Separate timeline not bound to a thread, e.g. for GPU zones. Record is only
+	 * safe from one thread per track */
+	static unsigned int CreateTrack(const char* name);
+
+	static void Record(unsigned int track, const char* name, unsigned long long start, unsigned long long end, unsigned int depth);
+
+	/* Marks a frame boundary of the simulation, frames appear in the trace as well */
+	static void BeginFrame();
+
+	/* Duration of the last count frames, oldest first */
+	static void GetFrameTimes(std::vector<unsigned long long>& durations, unsigned int count = FrameHistory);
+
+	/* Copies every recorded event that ended after since */
+	static void CollectEvents(std::vector<ProfileEvent>& events, unsigned long long since = 0);
+
+	static bool ExportChromeTrace(const std::string& filePath);
+
+	// Used by ProfileScope
+	static unsigned int Enter();
+
+	static void Leave(const char* name, unsigned long long start);
+};
+
+class ProfileScope
+{
+private:
+	const char* m_Name;
+	unsigned long long m_Start;
+
+public:
+	explicit ProfileScope(const char* name)
+		: m_Name(name)
+	{
+		Profiler::Enter();
+		m_Start = Profiler::GetTime();
+	}
+
+	~ProfileScope() { Profiler::Leave(m_Name, m_Start); }
+
+	ProfileScope(const ProfileScope&) = delete;
+	ProfileScope& operator=(const ProfileScope&) = delete;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#ifdef PROFILER_DISABLED
+#define PROFILE_SCOPE(name)
+#else
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#endif
+
+/* GPU zones timed with GL_TIMESTAMP query pairs (nestable, unlike GL_TIME_ELAPSED)
+ * and wrapped in glPushDebugGroup so RenderDoc and Nsight show the same names.
+ * Results are read back FrameLatency frames later, never waited on, and land in
+ * the profiler on a "GPU" track in the CPU time base.
+ *
+ * Everything here runs on the thread that owns the context.
+ */
+class GpuProfiler
+{
+public:
+	static const unsigned int FrameLatency = 4;
+	static const unsigned int MaxZones = 128;
+
+private:
+	struct Zone
+	{
+		const char* Name;
+		unsigned int Depth;
+	};
+
+	struct Frame
+	{
+		unsigned int Queries[MaxZones * 2];
+		Zone Zones[MaxZones];
+		unsigned int ZoneCount;
+		unsigned int LastQuery;  // issued last, finishes last
+	};
+
+	Frame m_Frames[FrameLatency];
+	unsigned int m_Frame;
+	unsigned int m_Depth;
+	unsigned int m_Open[MaxZones];
+	unsigned int m_OpenCount;
+	long long m_ClockOffset;  // CPU time minus GPU time, nanoseconds
+	unsigned long long m_FrameTime;
+	unsigned int m_Track;
+	bool m_DebugGroups;
+
+	static GpuProfiler* s_Instance;
+
+	void Calibrate();
+	bool ReadBack(Frame& frame);
+
+public:
+	GpuProfiler();
+
+	~GpuProfiler();
+
+	GpuProfiler(const GpuProfiler&) = delete;
+	GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+	/* Once per frame before the first zone, collects the frame recorded FrameLatency ago.
+	 * Returns whether that frame's results were ready */
+	bool BeginFrame();
+
+	/* Sum of the outermost zones of the last collected frame, nanoseconds */
+	inline unsigned long long GetFrameTime() const { return m_FrameTime; }
+
+	void Begin(const char* name);
+
+	void End();
+
+	static inline GpuProfiler* Get() { return s_Instance; }
+};
+
+class GpuProfileScope
+{
+private:
+	GpuProfiler* m_Profiler;
+
+public:
+	explicit GpuProfileScope(const char* name)
+		: m_Profiler(GpuProfiler::Get())
+	{
+		if (m_Profiler)
+			m_Profiler->Begin(name);
+	}
+
+	~GpuProfileScope()
+	{
+		if (m_Profiler)
+			m_Profiler->End();
+	}
+
+	GpuProfileScope(const GpuProfileScope&) = delete;
+	GpuProfileScope& operator=(const GpuProfileScope&) = delete;
+};
+
+#ifdef PROFILER_DISABLED
+#define PROFILE_GPU_SCOPE(name)
+#else
+#define PROFILE_GPU_SCOPE(name) GpuProfileScope PROFILE_CONCAT(gpuProfileScope, __LINE__)(name); PROFILE_SCOPE(name)
+#endif
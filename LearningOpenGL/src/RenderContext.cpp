@@ -0,0 +1,300 @@
+#include "RenderContext.h"
+#include "Renderer.h"
+
+#include <GLFW/glfw3.h>
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#ifdef __linux__
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+RenderContext::RenderContext()
+    : m_Window(nullptr), m_Display(nullptr), m_Config(nullptr), m_Context(nullptr), m_OwnsDisplay(false),
+      m_Width(0), m_Height(0), m_Framebuffer(0), m_ColorBuffer(0), m_DepthBuffer(0)
+{
+}
+
+RenderContext::~RenderContext()
+{
+    if (m_Window)
+        glfwDestroyWindow(m_Window);
+
+#ifdef __linux__
+    if (m_Context)
+        eglDestroyContext(m_Display, m_Context);
+    if (m_OwnsDisplay)
+        eglTerminate(m_Display);
+#endif
+}
+
+std::unique_ptr<RenderContext> RenderContext::CreateWindowed(unsigned int width, unsigned int height, const std::string& title)
+{
+    /* Specified OpenGL version and use core profile */
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_CORE_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+    /* Create debug context before create OpenGL context */
+    glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GL_TRUE);
+
+    /* Create a windowed mode window and its OpenGL context */
+    GLFWwindow* window = glfwCreateWindow(width, height, title.c_str(), NULL, NULL);
+    if (!window)
+    {
+        std::cout << "Error: Failed to create the window" << std::endl;
+        return nullptr;
+    }
+
+    std::unique_ptr<RenderContext> context(new RenderContext());
+    context->m_Window = window;
+    context->m_Width = width;
+    context->m_Height = height;
+    return context;
+}
+
+#ifdef __linux__
+static EGLContext CreateEglContext(EGLDisplay display, EGLConfig config, EGLContext shareWith)
+{
+    /* Same as the window: 3.3 core with a debug context */
+    const EGLint attributes[] = {
+        EGL_CONTEXT_MAJOR_VERSION_KHR, 3,
+        EGL_CONTEXT_MINOR_VERSION_KHR, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK_KHR, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT_KHR,
+        EGL_CONTEXT_FLAGS_KHR, EGL_CONTEXT_OPENGL_DEBUG_BIT_KHR,
+        EGL_NONE
+    };
+    return eglCreateContext(display, config, shareWith, attributes);
+}
+#endif
+
+std::unique_ptr<RenderContext> RenderContext::CreateHeadless(unsigned int width, unsigned int height)
+{
+#ifdef __linux__
+    const char* clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+        (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if (!clientExtensions || !std::strstr(clientExtensions, "EGL_MESA_platform_surfaceless") || !getPlatformDisplay)
+    {
+        std::cout << "Error: EGL_MESA_platform_surfaceless is not supported" << std::endl;
+        return nullptr;
+    }
+
+    EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    EGLint major, minor;
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor))
+    {
+        std::cout << "Error: Failed to initialize the surfaceless EGL display" << std::endl;
+        return nullptr;
+    }
+
+    std::unique_ptr<RenderContext> context(new RenderContext());
+    context->m_Display = display;
+    context->m_OwnsDisplay = true;
+    context->m_Width = width;
+    context->m_Height = height;
+
+    /* There is no surface at all, the context is made current with EGL_NO_SURFACE */
+    const char* extensions = eglQueryString(display, EGL_EXTENSIONS);
+    if (!extensions || !std::strstr(extensions, "EGL_KHR_surfaceless_context") || !eglBindAPI(EGL_OPENGL_API))
+    {
+        std::cout << "Error: Desktop OpenGL without a surface is not supported" << std::endl;
+        return nullptr;
+    }
+
+    const EGLint configAttributes[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE, 8,
+        EGL_GREEN_SIZE, 8,
+        EGL_BLUE_SIZE, 8,
+        EGL_NONE
+    };
+    EGLConfig config;
+    EGLint configCount = 0;
+    if (!eglChooseConfig(display, configAttributes, &config, 1, &configCount) || configCount == 0)
+    {
+        std::cout << "Error: No EGL config for desktop OpenGL" << std::endl;
+        return nullptr;
+    }
+    context->m_Config = config;
+
+    context->m_Context = CreateEglContext(display, config, EGL_NO_CONTEXT);
+    if (context->m_Context == EGL_NO_CONTEXT)
+    {
+        context->m_Context = nullptr;
+        std::cout << "Error: Failed to create an OpenGL 3.3 core context (" << eglGetError() << ")" << std::endl;
+        return nullptr;
+    }
+    return context;
+#else
+    (void)width;
+    (void)height;
+    std::cout << "Error: Headless rendering needs EGL, only available on Linux" << std::endl;
+    return nullptr;
+#endif
+}
+
+std::unique_ptr<RenderContext> RenderContext::CreateShared() const
+{
+    std::unique_ptr<RenderContext> context(new RenderContext());
+
+    if (m_Window)
+    {
+        /* GLFW windows can only be created on the main thread, the context inherits the
+         * version hints of the main window */
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        context->m_Window = glfwCreateWindow(1, 1, "Shared", NULL, m_Window);
+        glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+        if (!context->m_Window)
+            return nullptr;
+        return context;
+    }
+
+#ifdef __linux__
+    context->m_Display = m_Display;
+    context->m_Config = m_Config;
+    context->m_Context = CreateEglContext(m_Display, m_Config, m_Context);
+    if (context->m_Context == EGL_NO_CONTEXT)
+    {
+        context->m_Context = nullptr;
+        return nullptr;
+    }
+    return context;
+#else
+    return nullptr;
+#endif
+}
+
+void RenderContext::MakeCurrent()
+{
+    if (m_Window)
+    {
+        glfwMakeContextCurrent(m_Window);
+        return;
+    }
+
+#ifdef __linux__
+    eglMakeCurrent(m_Display, EGL_NO_SURFACE, EGL_NO_SURFACE, m_Context);
+#endif
+}
+
+void RenderContext::ReleaseCurrent()
+{
+    if (m_Window)
+    {
+        glfwMakeContextCurrent(nullptr);
+        return;
+    }
+
+#ifdef __linux__
+    eglMakeCurrent(m_Display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+#endif
+}
+
+bool RenderContext::InitializeGL()
+{
+    /* We need to create a valid OpenGL rendering context before call glewInit.
+     * A GLEW built for GLX loads every GL function first and only then fails to find
+     * an X display, which a headless context doesn't need */
+    GLenum result = glewInit();     // we should define GLEW_STATIC if we use static library
+    if (result != GLEW_OK && !(IsHeadless() && result == GLEW_ERROR_NO_GLX_DISPLAY))
+    {
+        std::cout << "Error: glewInit failed (" << result << ")" << std::endl;
+        return false;
+    }
+
+    if (!IsHeadless())
+        return true;
+
+    GLCall(glGenRenderbuffers(1, &m_ColorBuffer));
+    GLCall(glBindRenderbuffer(GL_RENDERBUFFER, m_ColorBuffer));
+    GLCall(glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, m_Width, m_Height));
+
+    GLCall(glGenRenderbuffers(1, &m_DepthBuffer));
+    GLCall(glBindRenderbuffer(GL_RENDERBUFFER, m_DepthBuffer));
+    GLCall(glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, m_Width, m_Height));
+    GLCall(glBindRenderbuffer(GL_RENDERBUFFER, 0));
+
+    /* Stays bound for the lifetime of the context, the renderer never binds another one */
+    GLCall(glGenFramebuffers(1, &m_Framebuffer));
+    GLCall(glBindFramebuffer(GL_FRAMEBUFFER, m_Framebuffer));
+    GLCall(glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_ColorBuffer));
+    GLCall(glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_DepthBuffer));
+
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    if (status != GL_FRAMEBUFFER_COMPLETE)
+    {
+        std::cout << "Error: Headless framebuffer is incomplete (" << status << ")" << std::endl;
+        return false;
+    }
+
+    GLCall(glViewport(0, 0, m_Width, m_Height));
+    return true;
+}
+
+void RenderContext::ShutdownGL()
+{
+    if (m_Framebuffer)
+    {
+        GLCall(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+        GLCall(glDeleteFramebuffers(1, &m_Framebuffer));
+        GLCall(glDeleteRenderbuffers(1, &m_ColorBuffer));
+        GLCall(glDeleteRenderbuffers(1, &m_DepthBuffer));
+        m_Framebuffer = m_ColorBuffer = m_DepthBuffer = 0;
+    }
+}
+
+void RenderContext::SwapBuffers()
+{
+    if (m_Window)
+    {
+        /* Swap front and back buffers */
+        glfwSwapBuffers(m_Window);
+        return;
+    }
+
+    GLCall(glFinish());
+}
+
+bool RenderContext::ShouldClose() const
+{
+    return m_Window && glfwWindowShouldClose(m_Window);
+}
+
+void RenderContext::PollEvents()
+{
+    /* Poll for and process events */
+    if (m_Window)
+        glfwPollEvents();
+}
+
+bool RenderContext::SaveImage(const std::string& filePath) const
+{
+    if (!m_Framebuffer)
+    {
+        std::cout << "Error: Only headless frames can be saved" << std::endl;
+        return false;
+    }
+
+    std::vector<unsigned char> pixels(m_Width * m_Height * 3);
+    GLCall(glPixelStorei(GL_PACK_ALIGNMENT, 1));
+    GLCall(glReadPixels(0, 0, m_Width, m_Height, GL_RGB, GL_UNSIGNED_BYTE, pixels.data()));
+
+    std::ofstream stream(filePath, std::ios::binary);
+    if (!stream)
+    {
+        std::cout << "Error: Failed to write " << filePath << std::endl;
+        return false;
+    }
+
+    /* GL rows start at the bottom, PPM rows at the top */
+    stream << "P6\n" << m_Width << " " << m_Height << "\n255\n";
+    for (unsigned int row = m_Height; row-- > 0;)
+        stream.write((const char*)&pixels[row * m_Width * 3], m_Width * 3);
+    return (bool)stream;
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <memory>
+#include <string>
+
+struct GLFWwindow;
+
+/* The GL context the render thread draws with. Either a GLFW window, or a headless
+ * EGL context on Mesa's surfaceless platform (EGL_MESA_platform_surfaceless) that
+ * draws into a framebuffer object, so nothing needs a display: CI, render servers,
+ * GPU-less machines with llvmpipe. Headless contexts are Linux only.
+ *
+ * Contexts are created and destroyed on the main thread. InitializeGL, SwapBuffers,
+ * SaveImage and ShutdownGL need the context current on the calling thread.
+ */
+class RenderContext
+{
+private:
+	GLFWwindow* m_Window;
+	void* m_Display;   // EGLDisplay
+	void* m_Config;    // EGLConfig
+	void* m_Context;   // EGLContext
+	bool m_OwnsDisplay;
+	unsigned int m_Width;
+	unsigned int m_Height;
+
+	// Headless render target
+	unsigned int m_Framebuffer;
+	unsigned int m_ColorBuffer;
+	unsigned int m_DepthBuffer;
+
+	RenderContext();
+
+public:
+	/* GLFW must be initialized, returns nullptr on failure */
+	static std::unique_ptr<RenderContext> CreateWindowed(unsigned int width, unsigned int height, const std::string& title);
+
+	static std::unique_ptr<RenderContext> CreateHeadless(unsigned int width, unsigned int height);
+
+	~RenderContext();
+
+	RenderContext(const RenderContext&) = delete;
+	RenderContext& operator=(const RenderContext&) = delete;
+
+	/* A second context sharing objects with this one, with nothing to draw to */
+	std::unique_ptr<RenderContext> CreateShared() const;
+
+	void MakeCurrent();
+
+	void ReleaseCurrent();
+
+	/* Loads the GL functions, headless contexts also create and bind their framebuffer */
+	bool InitializeGL();
+
+	void ShutdownGL();
+
+	/* Headless contexts have nothing to present, they wait for the frame instead so
+	 * the CPU never runs more than a frame ahead */
+	void SwapBuffers();
+
+	bool ShouldClose() const;
+
+	void PollEvents();
+
+	/* Writes the headless framebuffer as a binary PPM */
+	bool SaveImage(const std::string& filePath) const;
+
+	inline bool IsHeadless() const { return m_Window == nullptr; }
+	inline GLFWwindow* GetWindow() const { return m_Window; }
+	inline unsigned int GetWidth() const { return m_Width; }
+	inline unsigned int GetHeight() const { return m_Height; }
+};
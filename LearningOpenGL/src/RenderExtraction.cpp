@@ -0,0 +1,170 @@
+#include "RenderExtraction.h"
+#include "Components.h"
+#include "TransformHierarchy.h"
+#include "ResourceRegistry.h"
+#include "CommandBuffer.h"
+#include "Meshlet.h"
+#include "LodSelector.h"
+#include "FrustumCuller.h"
+#include "DepthRasterizer.h"
+#include "Profiler.h"
+
+#include <algorithm>
+
+void RenderExtraction::SyncTransforms(const EntityWorld& world, const TransformHierarchy& hierarchy)
+{
+    world.ForEachChunk<TransformNodeComponent, TransformComponent>(
+        [&hierarchy](unsigned int count, TransformNodeComponent* nodes, TransformComponent* transforms)
+    {
+        for (unsigned int i = 0; i < count; ++i)
+            transforms[i].World = hierarchy.GetWorldMatrix(nodes[i].Node);
+    });
+}
+
+/* Index range covered by the SubMeshes of one level, each level is stored in one piece */
+static void GetLevelRange(const std::vector<SubMesh>& subMeshes, unsigned int& firstIndex, unsigned int& indexCount)
+{
+    unsigned int first = 0xffffffff, last = 0;
+    for (const auto& subMesh : subMeshes)
+    {
+        first = std::min(first, subMesh.FirstIndex);
+        last = std::max(last, subMesh.FirstIndex + subMesh.IndexCount);
+    }
+    firstIndex = first < last ? first : 0;
+    indexCount = first < last ? last - first : 0;
+}
+
+/* Calls emit(item) for every entity of the chunk inside the frustum, once per visible
+ * meshlet range for meshes drawn with meshlets */
+template<typename Emit>
+static void ExtractChunk(const ResourceRegistry& resources, const RenderView& view, const Frustum& frustum, unsigned int count,
+    const TransformComponent* transforms, MeshComponent* meshes, const MaterialComponent* materials, const BoundsComponent* bounds, Emit emit)
+{
+    /* World boxes of the transformed local boxes (extents rotated with |M|), culled
+     * with SIMD in one go. Scratch space per thread, chunks are culled in parallel */
+    static thread_local FrustumCuller culler;
+    static thread_local std::vector<unsigned int> inside;
+    static thread_local std::vector<BoundingBox> worldBounds;
+    culler.Clear();
+    worldBounds.resize(count);
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        const glm::mat4& world = transforms[i].World;
+        glm::vec3 center = glm::vec3(world * glm::vec4(bounds[i].Local.GetCenter(), 1.0f));
+        glm::vec3 localExtents = bounds[i].Local.GetExtents();
+        glm::vec3 extents = glm::abs(glm::vec3(world[0])) * localExtents.x +
+            glm::abs(glm::vec3(world[1])) * localExtents.y + glm::abs(glm::vec3(world[2])) * localExtents.z;
+        culler.Add(center, extents, glm::length(extents));
+        worldBounds[i] = { center - extents, center + extents };
+    }
+    inside.resize(count);
+    const unsigned int insideCount = culler.Cull(frustum, 0, count, inside.data());
+
+    for (unsigned int v = 0; v < insideCount; ++v)
+    {
+        const unsigned int i = inside[v];
+        const glm::mat4& world = transforms[i].World;
+        if (view.Occlusion && !view.Occlusion->IsVisible(worldBounds[i]))
+            continue;
+
+        /* Released objects outlive their handles by a few frames, the pointers stay
+         * good until the recorded frame has been replayed */
+        const MaterialComponent& material = materials[i];
+        Shader* program = resources.Get(material.Program);
+        if (!program)
+            continue;
+        const Texture* texture = resources.Get(material.DiffuseTexture);
+
+        DrawItem item;
+        item.SortKey = DrawQueue::MakeSortKey(program->GetRendererID(),
+            texture ? texture->GetRendererID() : 0, meshes[i].Mesh.Page);
+        item.Pool = meshes[i].Pool;
+        item.Mesh = meshes[i].Mesh;
+        item.Program = program;
+        item.DiffuseTexture = texture;
+        item.Color = material.Color;
+        item.Model = world;
+        item.OcclusionObject = bounds[i].OcclusionObject;
+        item.Bounds = worldBounds[i];
+
+        const MeshData* data = meshes[i].Data;
+        if (!data)
+        {
+            emit(item);
+            continue;
+        }
+
+        /* The index data holds every level, only the selected one is drawn */
+        unsigned int& lod = meshes[i].Lod;
+        lod = LodSelector::Select(*data, view.ViewProjection * world, view.ViewportHeight, lod);
+        if (lod > 0 || data->Meshlets.empty())
+        {
+            unsigned int firstIndex, indexCount;
+            GetLevelRange(lod ? data->Lods[lod - 1].SubMeshes : data->SubMeshes, firstIndex, indexCount);
+            item.Mesh.FirstIndex = meshes[i].Mesh.FirstIndex + firstIndex;
+            item.Mesh.IndexCount = indexCount;
+            if (indexCount)
+                emit(item);
+            continue;
+        }
+
+        /* Meshlets cover the full detail level. Clusters outside the frustum or facing
+         * away are dropped, neighbours are merged */
+        static thread_local std::vector<IndexRange> visible;
+        MeshletCuller::Cull(data->Meshlets, world, view.ViewProjection, view.CameraPosition, visible);
+        for (const auto& range : visible)
+        {
+            item.Mesh.FirstIndex = meshes[i].Mesh.FirstIndex + range.FirstIndex;
+            item.Mesh.IndexCount = range.IndexCount;
+            emit(item);
+        }
+    }
+}
+
+void RenderExtraction::RasterizeOccluders(const EntityWorld& world, const glm::mat4& viewProjection, DepthRasterizer& rasterizer)
+{
+    PROFILE_SCOPE("Occluders");
+    rasterizer.Begin(viewProjection);
+    world.ForEachChunk<TransformComponent, OccluderComponent>(
+        [&rasterizer](unsigned int count, TransformComponent* transforms, OccluderComponent* occluders)
+    {
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            rasterizer.AddOccluder(occluders[i].Positions, occluders[i].VertexCount,
+                occluders[i].Indices, occluders[i].IndexCount, transforms[i].World);
+        }
+    });
+    rasterizer.Rasterize();
+}
+
+unsigned int RenderExtraction::Extract(const EntityWorld& world, const ResourceRegistry& resources, const RenderView& view, DrawQueue& queue)
+{
+    queue.Clear();
+    const Frustum frustum(view.ViewProjection);
+    world.ForEachChunk<TransformComponent, MeshComponent, MaterialComponent, BoundsComponent>(
+        [&](unsigned int count, TransformComponent* transforms, MeshComponent* meshes,
+            MaterialComponent* materials, BoundsComponent* bounds)
+    {
+        ExtractChunk(resources, view, frustum, count, transforms, meshes, materials, bounds,
+            [&queue](const DrawItem& item) { queue.Push(item); });
+    });
+
+    queue.Sort();
+    return queue.GetCount();
+}
+
+void RenderExtraction::Record(const EntityWorld& world, const ResourceRegistry& resources, const RenderView& view, CommandRecorder& recorder)
+{
+    PROFILE_SCOPE("Record");
+    const Frustum frustum(view.ViewProjection);
+    world.ParallelForEachChunk<TransformComponent, MeshComponent, MaterialComponent, BoundsComponent>(
+        [&](unsigned int chunk, unsigned int count, TransformComponent* transforms, MeshComponent* meshes,
+            MaterialComponent* materials, BoundsComponent* bounds)
+    {
+        /* Chunk and emit order break SortKey ties, whichever worker ran the chunk */
+        CommandBuffer& buffer = recorder.GetThreadBuffer();
+        unsigned long long order = (unsigned long long)chunk << 32;
+        ExtractChunk(resources, view, frustum, count, transforms, meshes, materials, bounds,
+            [&buffer, &order](const DrawItem& item) { buffer.Draw(item, order++); });
+    });
+}
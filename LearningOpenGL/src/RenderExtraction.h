@@ -0,0 +1,43 @@
+#pragma once
+
+#include "EntityWorld.h"
+#include "DrawQueue.h"
+#include "Frustum.h"
+
+class TransformHierarchy;
+class CommandRecorder;
+class ResourceRegistry;
+class DepthRasterizer;
+
+/* The camera entities are culled and drawn for */
+struct RenderView
+{
+	glm::mat4 ViewProjection;
+	glm::vec3 CameraPosition;
+	float ViewportHeight;    // in pixels, for LOD selection
+	const DepthRasterizer* Occlusion;    // occluders of this frame, nullptr skips occlusion culling
+};
+
+/* Systems that turn entities into draws */
+class RenderExtraction
+{
+public:
+	/* Copies world matrices of entities with a TransformNodeComponent from the hierarchy */
+	static void SyncTransforms(const EntityWorld& world, const TransformHierarchy& hierarchy);
+
+	/* Starts a frame of CPU occlusion culling: rasterizes every entity with a transform
+	 * and an OccluderComponent, tiles run on the job system */
+	static void RasterizeOccluders(const EntityWorld& world, const glm::mat4& viewProjection, DepthRasterizer& rasterizer);
+
+	/* Frustum and occlusion culls every entity with transform, mesh, material and bounds and fills
+	 * the queue, sorted. Meshes with LODs get the coarsest level that looks the same
+	 * (stored back in MeshComponent::Lod), at full detail meshes with meshlets are
+	 * drawn as their visible clusters.
+	 * Material handles are resolved through resources, entities whose shader is gone
+	 * are skipped. Returns the number of draws. */
+	static unsigned int Extract(const EntityWorld& world, const ResourceRegistry& resources, const RenderView& view, DrawQueue& queue);
+
+	/* Same culling with chunks spread over the job system, each thread records into its
+	 * own buffer of recorder. Call recorder.Merge afterwards. */
+	static void Record(const EntityWorld& world, const ResourceRegistry& resources, const RenderView& view, CommandRecorder& recorder);
+};
@@ -0,0 +1,167 @@
+#include "RenderStats.h"
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+
+const unsigned int RenderStats::FrameHistory;
+
+namespace {
+
+    const size_t CounterCount = (size_t)RenderCounter::Count;
+
+    const char* const s_Names[CounterCount] = {
+        "DrawCalls", "Instances", "Triangles", "ShaderBinds", "VertexArrayBinds", "BufferBinds",
+        "TextureBinds", "UniformUploads", "BufferBytesUploaded", "TextureBytesUploaded", "GLCalls"
+    };
+
+    /* Only the owning thread writes, so a plain load and store is enough and EndFrame
+     * reads running totals that never go backwards */
+    struct ThreadCounters
+    {
+        std::atomic<unsigned long long> Values[CounterCount];
+
+        ThreadCounters()
+        {
+            for (auto& value : Values)
+                value.store(0, std::memory_order_relaxed);
+        }
+    };
+
+    std::mutex s_Mutex;
+    // Never freed, threads may count until the very end
+    std::vector<ThreadCounters*> s_Threads;
+    thread_local ThreadCounters* t_Counters = nullptr;
+
+    RenderFrameStats s_Totals = {};
+    RenderFrameStats s_History[RenderStats::FrameHistory] = {};
+    unsigned int s_FrameCount = 0;
+    unsigned int s_LogInterval = 0;
+    // Totals when the current log interval began, intervals may be longer than the history
+    RenderFrameStats s_LogStart = {};
+    unsigned int s_LogStartFrame = 0;
+    std::ofstream s_Csv;
+
+    ThreadCounters& GetThreadCounters()
+    {
+        if (!t_Counters)
+        {
+            t_Counters = new ThreadCounters();
+            std::lock_guard<std::mutex> lock(s_Mutex);
+            s_Threads.push_back(t_Counters);
+        }
+        return *t_Counters;
+    }
+
+    void Log()
+    {
+        unsigned int count = s_FrameCount - s_LogStartFrame;
+        std::cout << "Render stats, average of " << count << " frames:";
+        for (size_t i = 0; i < CounterCount; ++i)
+            std::cout << " " << s_Names[i] << "=" << (s_Totals.Values[i] - s_LogStart.Values[i]) / count;
+        std::cout << std::endl;
+
+        s_LogStart = s_Totals;
+        s_LogStartFrame = s_FrameCount;
+    }
+
+}
+
+void RenderStats::Add(RenderCounter counter, unsigned long long value)
+{
+    std::atomic<unsigned long long>& total = GetThreadCounters().Values[(size_t)counter];
+    total.store(total.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+void RenderStats::EndFrame()
+{
+    std::lock_guard<std::mutex> lock(s_Mutex);
+
+    RenderFrameStats totals = {};
+    for (const ThreadCounters* counters : s_Threads)
+    {
+        for (size_t i = 0; i < CounterCount; ++i)
+            totals.Values[i] += counters->Values[i].load(std::memory_order_relaxed);
+    }
+
+    RenderFrameStats& frame = s_History[s_FrameCount % FrameHistory];
+    for (size_t i = 0; i < CounterCount; ++i)
+        frame.Values[i] = totals.Values[i] - s_Totals.Values[i];
+    s_Totals = totals;
+    ++s_FrameCount;
+
+    if (s_Csv.is_open())
+    {
+        s_Csv << s_FrameCount - 1;
+        for (size_t i = 0; i < CounterCount; ++i)
+            s_Csv << ',' << frame.Values[i];
+        s_Csv << '\n';
+    }
+
+    if (s_LogInterval && s_FrameCount % s_LogInterval == 0)
+        Log();
+}
+
+RenderFrameStats RenderStats::GetLastFrame()
+{
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    if (s_FrameCount == 0)
+        return RenderFrameStats();
+    return s_History[(s_FrameCount - 1) % FrameHistory];
+}
+
+RenderFrameStats RenderStats::GetTotals()
+{
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    return s_Totals;
+}
+
+void RenderStats::GetHistory(std::vector<RenderFrameStats>& frames, unsigned int count)
+{
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    count = std::min(count, std::min(s_FrameCount, FrameHistory));
+    frames.clear();
+    for (unsigned int frame = s_FrameCount - count; frame < s_FrameCount; ++frame)
+        frames.push_back(s_History[frame % FrameHistory]);
+}
+
+const char* RenderStats::GetName(RenderCounter counter)
+{
+    return s_Names[(size_t)counter];
+}
+
+void RenderStats::SetLogInterval(unsigned int frames)
+{
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    s_LogInterval = frames;
+    s_LogStart = s_Totals;
+    s_LogStartFrame = s_FrameCount;
+}
+
+bool RenderStats::OpenCsv(const std::string& filePath)
+{
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    if (s_Csv.is_open())
+        s_Csv.close();
+
+    s_Csv.open(filePath);
+    if (!s_Csv)
+    {
+        std::cout << "Error: Failed to open " << filePath << std::endl;
+        return false;
+    }
+
+    s_Csv << "Frame";
+    for (size_t i = 0; i < CounterCount; ++i)
+        s_Csv << ',' << s_Names[i];
+    s_Csv << '\n';
+    return true;
+}
+
+void RenderStats::CloseCsv()
+{
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    s_Csv.close();
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <string>
+#include <vector>
+
+enum class RenderCounter
+{
+	DrawCalls,
+	Instances,
+	Triangles,
+	ShaderBinds,
+	VertexArrayBinds,
+	BufferBinds,
+	TextureBinds,
+	UniformUploads,
+	BufferBytesUploaded,
+	TextureBytesUploaded,
+	GLCalls,   // calls issued through GLCall
+	Count
+};
+
+struct RenderFrameStats
+{
+	unsigned long long Values[(size_t)RenderCounter::Count];
+
+	inline unsigned long long operator[](RenderCounter counter) const { return Values[(size_t)counter]; }
+};
+
+/* What the renderer did, per frame. Every thread that touches GL counts into its own
+ * block of counters without locking; EndFrame sums the blocks on the render thread
+ * and turns the running totals into per-frame numbers.
+ *
+ * Frames can be logged every few frames and written to a CSV file, one row each.
+ */
+class RenderStats
+{
+public:
+	static const unsigned int FrameHistory = 256;
+
+	static void Add(RenderCounter counter, unsigned long long value = 1);
+
+	/* Once per rendered frame on the render thread */
+	static void EndFrame();
+
+	static RenderFrameStats GetLastFrame();
+
+	static RenderFrameStats GetTotals();
+
+	/* Up to count most recent frames, oldest first */
+	static void GetHistory(std::vector<RenderFrameStats>& frames, unsigned int count = FrameHistory);
+
+	static const char* GetName(RenderCounter counter);
+
+	/* Prints the average of the frames since the last print every interval frames, 0 turns it off */
+	static void SetLogInterval(unsigned int frames);
+
+	static bool OpenCsv(const std::string& filePath);
+
+	static void CloseCsv();
+};
@@ -0,0 +1,136 @@
+#include "RenderThread.h"
+#include "Profiler.h"
+#include "FrameTimer.h"
+#include "RenderContext.h"
+
+RenderThread::RenderThread(RenderContext& context)
+    : m_Context(context), m_WriteIndex(0), m_PendingIndex(-1), m_RenderingIndex(-1), m_Running(true)
+{
+    m_Thread = std::thread(&RenderThread::Run, this);
+}
+
+RenderThread::~RenderThread()
+{
+    Stop();
+}
+
+void RenderThread::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (!m_Running)
+            return;
+        m_Running = false;
+    }
+    m_Changed.notify_all();
+    m_Thread.join();
+}
+
+CommandList& RenderThread::BeginFrame()
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_Changed.wait(lock, [this]() { return m_RenderingIndex != (int)m_WriteIndex; });
+    return m_Lists[m_WriteIndex];
+}
+
+void RenderThread::EndFrame()
+{
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_Changed.wait(lock, [this]() { return m_PendingIndex < 0 || !m_Running; });
+        m_PendingIndex = (int)m_WriteIndex;
+        m_WriteIndex ^= 1;
+    }
+    m_Changed.notify_all();
+}
+
+void RenderThread::Submit(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Tasks.push_back(std::move(task));
+    }
+    m_Changed.notify_all();
+}
+
+void RenderThread::Execute(const std::function<void()>& task)
+{
+    // Would wait for itself forever
+    ASSERT(std::this_thread::get_id() != m_Thread.get_id());
+
+    std::mutex mutex;
+    std::condition_variable finished;
+    bool done = false;
+
+    Submit([&]()
+    {
+        task();
+        std::lock_guard<std::mutex> lock(mutex);
+        done = true;
+        finished.notify_one();
+    });
+
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [&]() { return done; });
+}
+
+void RenderThread::Run()
+{
+    m_Context.MakeCurrent();
+    Profiler::SetThreadName("Render");
+
+    std::vector<std::function<void()>> tasks;
+    while (true)
+    {
+        int index;
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_Changed.wait(lock, [this]() { return m_PendingIndex >= 0 || !m_Tasks.empty() || !m_Running; });
+
+            tasks.swap(m_Tasks);
+            index = m_PendingIndex;
+            if (tasks.empty() && index < 0 && !m_Running)
+                break;
+
+            m_PendingIndex = -1;
+            m_RenderingIndex = index;
+        }
+        m_Changed.notify_all();
+
+        if (!tasks.empty())
+        {
+            PROFILE_SCOPE("Render Tasks");
+            for (auto& task : tasks)
+                task();
+            tasks.clear();
+        }
+
+        if (index >= 0)
+        {
+            /* Collects the GPU times of an older frame, GPU zones below belong to this one */
+            GpuProfiler* gpuProfiler = GpuProfiler::Get();
+            if (gpuProfiler && gpuProfiler->BeginFrame())
+                FrameTimer::Record(FramePhase::Gpu, gpuProfiler->GetFrameTime());
+
+            {
+                PROFILE_GPU_SCOPE("Replay");
+                m_Renderer.Execute(m_Lists[index]);
+            }
+
+            {
+                PROFILE_SCOPE("Swap");
+                FrameTimerScope present(FramePhase::Present);
+                m_Context.SwapBuffers();
+            }
+            RenderStats::EndFrame();
+
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                m_RenderingIndex = -1;
+            }
+            m_Changed.notify_all();
+        }
+    }
+
+    m_Context.ReleaseCurrent();
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "CommandList.h"
+#include "Renderer.h"
+
+class RenderContext;
+
+/* Owns the window's (or the headless) GL context on a thread of its own. The simulation records a
+ * CommandList per frame while the render thread replays the previous one, with at
+ * most one finished frame waiting so input latency stays bounded.
+ *
+ *   CommandList& commands = renderThread.BeginFrame();
+ *   commands.Reset();
+ *   ...record...
+ *   renderThread.EndFrame();
+ *
+ * Anything else that touches GL (creating shaders, textures, buffers) goes through
+ * Submit or Execute.
+ */
+class RenderThread
+{
+private:
+	RenderContext& m_Context;
+	Renderer m_Renderer;
+	std::thread m_Thread;
+
+	std::mutex m_Mutex;
+	std::condition_variable m_Changed;
+
+	CommandList m_Lists[2];
+	unsigned int m_WriteIndex;
+	int m_PendingIndex;    // finished by the simulation, not yet picked up
+	int m_RenderingIndex;  // being replayed
+	bool m_Running;
+
+	std::vector<std::function<void()>> m_Tasks;
+
+	void Run();
+
+public:
+	/* The context must not be current on the calling thread */
+	RenderThread(RenderContext& context);
+
+	~RenderThread();
+
+	RenderThread(const RenderThread&) = delete;
+	RenderThread& operator=(const RenderThread&) = delete;
+
+	/* Blocks until the list it returns is no longer being replayed */
+	CommandList& BeginFrame();
+
+	/* Hands the list over, blocks while the previous frame still waits to be picked up */
+	void EndFrame();
+
+	/* Runs task on the render thread before the next frame */
+	void Submit(std::function<void()> task);
+
+	/* Runs task on the render thread and waits for it */
+	void Execute(const std::function<void()>& task);
+
+	/* Finishes the pending frame and releases the context, called by the destructor */
+	void Stop();
+};
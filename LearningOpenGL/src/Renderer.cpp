@@ -1,4 +1,10 @@
 #include "Renderer.h"
+#include "MeshPool.h"
+#include "IndirectDrawList.h"
+#include "DrawQueue.h"
+#include "CommandList.h"
+#include "Texture.h"
+#include "OcclusionCuller.h"
 
 #include <iostream>
 
@@ -21,9 +27,16 @@ bool GLLogCall(const char* function, const char* file, int line)
     return true;
 }
 
+static void CountDraw(unsigned int indexCount, unsigned int instanceCount)
+{
+    RenderStats::Add(RenderCounter::DrawCalls);
+    RenderStats::Add(RenderCounter::Instances, instanceCount);
+    RenderStats::Add(RenderCounter::Triangles, (unsigned long long)indexCount / 3 * instanceCount);
+}
+
 void Renderer::Clear() const
 {
-    GLCall(glClear(GL_COLOR_BUFFER_BIT));
+    GLCall(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
 }
 
 /* We usually use material substitute for shader here, but it's more complex */
@@ -40,4 +53,192 @@ void Renderer::Draw(const VertexArray& va, const IndexBuffer& ib, const Shader&
      * indices: Specifies an offset of the first index in the array in the data
      */
     GLCall(glDrawElements(GL_TRIANGLES, ib.GetCount(), GL_UNSIGNED_INT, NULL));  
+    CountDraw(ib.GetCount(), 1);
+}
+
+void Renderer::Draw(const MeshPool& pool, const MeshAllocation& mesh, const Shader& shader) const
+{
+    shader.Bind();
+    pool.Bind(mesh.Page);
+
+    /* basevertex: a constant that should be added to each element of indices
+     * when chosing elements from the enabled vertex arrays
+     */
+    GLCall(glDrawElementsBaseVertex(GL_TRIANGLES, mesh.IndexCount, GL_UNSIGNED_INT,
+        (void*)(mesh.FirstIndex * sizeof(unsigned int)), mesh.BaseVertex));
+    CountDraw(mesh.IndexCount, 1);
+}
+
+void Renderer::DrawIndirect(const MeshPool& pool, IndirectDrawList& draws, const Shader& shader) const
+{
+    if (draws.GetCount() == 0)
+        return;
+
+    draws.Upload();
+    shader.Bind();
+
+    const auto& commands = draws.GetCommands();
+    const auto& drawIDs = draws.GetDrawIDs();
+    for (const auto& range : draws.GetRanges())
+    {
+        pool.Bind(range.Page);
+        draws.BindDrawIDs();
+
+        if (draws.IsMultiDrawIndirectSupported())
+        {
+            /* Parameters
+             * indirect: offset of the first command in the buffer bound to GL_DRAW_INDIRECT_BUFFER
+             * drawcount: number of commands
+             * stride: 0 means tightly packed commands
+             */
+            GLCall(glBindBuffer(GL_DRAW_INDIRECT_BUFFER, draws.GetIndirectBufferID()));
+            GLCall(glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT,
+                (const void*)(range.First * sizeof(DrawElementsIndirectCommand)), range.Count, 0));
+
+            draws.UnbindDrawIDs();
+
+            // One call, but the commands still say what the GPU was asked to draw
+            RenderStats::Add(RenderCounter::DrawCalls);
+            for (unsigned int i = range.First; i < range.First + range.Count; ++i)
+            {
+                RenderStats::Add(RenderCounter::Instances, commands[i].InstanceCount);
+                RenderStats::Add(RenderCounter::Triangles, (unsigned long long)commands[i].Count / 3 * commands[i].InstanceCount);
+            }
+            continue;
+        }
+
+        for (unsigned int i = range.First; i < range.First + range.Count; ++i)
+        {
+            const auto& command = commands[i];
+            GLCall(glVertexAttribI1ui(IndirectDrawList::DrawIDLocation, drawIDs[i]));
+            GLCall(glDrawElementsInstancedBaseVertex(GL_TRIANGLES, command.Count, GL_UNSIGNED_INT,
+                (void*)(command.FirstIndex * sizeof(unsigned int)), command.InstanceCount, command.BaseVertex));
+            CountDraw(command.Count, command.InstanceCount);
+        }
+    }
+}
+
+void Renderer::Draw(const DrawItem& item, const glm::mat4& viewProjection, BoundState& state) const
+{
+    if (item.Program != state.Program)
+    {
+        state.Program = item.Program;
+        state.Program->Bind();
+        state.Program->SetUniform1i("u_Texture", 0);
+    }
+    if (!state.TextureBound || item.DiffuseTexture != state.DiffuseTexture)
+    {
+        state.TextureBound = true;
+        state.DiffuseTexture = item.DiffuseTexture;
+        if (state.DiffuseTexture)
+        {
+            state.DiffuseTexture->Bind(0);
+        }
+        else
+        {
+            /* No texture (or a stale handle) draws untextured, not with the previous item's texture */
+            GLCall(glActiveTexture(GL_TEXTURE0));
+            GLCall(glBindTexture(GL_TEXTURE_2D, 0));
+        }
+    }
+    if (item.Pool != state.Pool || item.Mesh.Page != state.Page)
+    {
+        state.Pool = item.Pool;
+        state.Page = item.Mesh.Page;
+        state.Pool->Bind(state.Page);
+    }
+
+    state.Program->SetUniformMat4f("u_MVP", viewProjection * item.Model);
+    state.Program->SetUniform4f("u_Color", item.Color.r, item.Color.g, item.Color.b, item.Color.a);
+    GLCall(glDrawElementsBaseVertex(GL_TRIANGLES, item.Mesh.IndexCount, GL_UNSIGNED_INT,
+        (void*)(item.Mesh.FirstIndex * sizeof(unsigned int)), item.Mesh.BaseVertex));
+    CountDraw(item.Mesh.IndexCount, 1);
+}
+
+void Renderer::Draw(const DrawQueue& queue, const glm::mat4& viewProjection) const
+{
+    BoundState state;
+    for (const auto& item : queue.GetItems())
+        Draw(item, viewProjection, state);
+}
+
+void Renderer::ResolveOcclusion(OcclusionCuller& culler, const glm::mat4& viewProjection)
+{
+    culler.BeginQueries();
+    for (const DrawItem* item : m_OcclusionTested)
+    {
+        if (culler.NeedsQuery(item->OcclusionObject))
+            culler.Query(item->OcclusionObject, item->Bounds);
+    }
+    culler.EndQueries();
+
+    /* The box pass left its own program and vertex array bound */
+    BoundState state;
+    for (const DrawItem* item : m_OcclusionHidden)
+    {
+        if (culler.BeginConditionalRender(item->OcclusionObject))
+        {
+            Draw(*item, viewProjection, state);
+            culler.EndConditionalRender();
+        }
+        else
+        {
+            Draw(*item, viewProjection, state);
+        }
+    }
+}
+
+void Renderer::Execute(const CommandList& commands)
+{
+    BoundState state;
+    glm::mat4 viewProjection(1.0f);
+    OcclusionCuller* culler = nullptr;
+    m_OcclusionTested.clear();
+    m_OcclusionHidden.clear();
+
+    commands.ForEach([&](const CommandHeader& header, const void* data)
+    {
+        switch (header.Type)
+        {
+        case CommandType::Clear:
+        {
+            const glm::vec4& color = ((const ClearCommand*)data)->Color;
+            GLCall(glClearColor(color.r, color.g, color.b, color.a));
+            Clear();
+            break;
+        }
+        case CommandType::SetViewProjection:
+            viewProjection = ((const SetViewProjectionCommand*)data)->ViewProjection;
+            break;
+        case CommandType::BeginOcclusion:
+        {
+            const BeginOcclusionCommand& command = *(const BeginOcclusionCommand*)data;
+            culler = command.Culler;
+            culler->BeginFrame(viewProjection, command.CameraPosition);
+            break;
+        }
+        case CommandType::Draw:
+        {
+            const DrawItem& item = ((const DrawCommand*)data)->Item;
+            if (culler && item.OcclusionObject != NoOcclusionObject)
+            {
+                while (culler->GetObjectCount() <= item.OcclusionObject)
+                    culler->AddObject();
+                m_OcclusionTested.push_back(&item);
+
+                /* Hidden last time we know of, waits for this frame's query */
+                if (!culler->IsVisible(item.OcclusionObject))
+                {
+                    m_OcclusionHidden.push_back(&item);
+                    break;
+                }
+            }
+            Draw(item, viewProjection, state);
+            break;
+        }
+        }
+    });
+
+    if (culler && !m_OcclusionTested.empty())
+        ResolveOcclusion(*culler, viewProjection);
 }
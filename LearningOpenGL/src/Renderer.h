@@ -1,24 +1,74 @@
 #pragma once
-#include <GL\glew.h>
+#include <GL/glew.h>
+#include <vector>
 
 #include "VertexArray.h"
 #include "IndexBuffer.h"
 #include "Shader.h"
+#include "RenderStats.h"
 
+#ifdef _MSC_VER
 #define ASSERT(x) if(!(x)) __debugbreak();
+#else
+#define ASSERT(x) if(!(x)) __builtin_trap();
+#endif
 #define GLCall(x) GLClearError();\
                   x;\
+                  RenderStats::Add(RenderCounter::GLCalls);\
                   ASSERT(GLLogCall(#x, __FILE__, __LINE__))
 
 void GLClearError();
 
 bool GLLogCall(const char* function, const char* file, int line);
 
+class MeshPool;
+struct MeshAllocation;
+class IndirectDrawList;
+class DrawQueue;
+struct DrawItem;
+class CommandList;
+class Texture;
+class OcclusionCuller;
 
 class Renderer
 {
+private:
+    // What the last draw left bound, so sorted draws skip redundant binds
+    struct BoundState
+    {
+        Shader* Program = nullptr;
+        const Texture* DiffuseTexture = nullptr;
+        bool TextureBound = false;      // DiffuseTexture is only meaningful once set
+        const MeshPool* Pool = nullptr;
+        unsigned int Page = 0;
+    };
+
+    // Draws of the command list being replayed that go through the OcclusionCuller
+    std::vector<const DrawItem*> m_OcclusionTested;
+    std::vector<const DrawItem*> m_OcclusionHidden;
+
+    void Draw(const DrawItem& item, const glm::mat4& viewProjection, BoundState& state) const;
+
+    /* Queries the boxes of m_OcclusionTested against the depth drawn so far, then draws
+     * m_OcclusionHidden where the GPU finds them visible */
+    void ResolveOcclusion(OcclusionCuller& culler, const glm::mat4& viewProjection);
+
 public:
     void Clear() const;
 
     void Draw(const VertexArray& va, const IndexBuffer& ib, const Shader& shader) const;
+
+    // Draw a mesh that lives inside a MeshPool with a base-vertex draw
+    void Draw(const MeshPool& pool, const MeshAllocation& mesh, const Shader& shader) const;
+
+    /* Submit a whole draw list with one glMultiDrawElementsIndirect per pool page,
+     * or one glDrawElementsBaseVertex per draw on GL 3.3 */
+    void DrawIndirect(const MeshPool& pool, IndirectDrawList& draws, const Shader& shader) const;
+
+    /* Draw a sorted queue, shader, texture and page are only rebound when they change.
+     * Sets u_MVP, u_Color and u_Texture (slot 0) per draw */
+    void Draw(const DrawQueue& queue, const glm::mat4& viewProjection) const;
+
+    /* Replay a recorded command list on the thread that owns the context */
+    void Execute(const CommandList& commands);
 };
\ No newline at end of file
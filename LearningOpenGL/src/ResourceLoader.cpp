@@ -0,0 +1,126 @@
+#include "ResourceLoader.h"
+#include "Renderer.h"
+#include "Profiler.h"
+#include "RenderContext.h"
+
+#include <iostream>
+
+ResourceLoader::ResourceLoader(const RenderContext& shareWith)
+    : m_Context(shareWith.CreateShared()), m_Running(true)
+{
+    if (!m_Context)
+    {
+        std::cout << "Error: Failed to create the loader context, loading on the render thread" << std::endl;
+        return;
+    }
+
+    m_Thread = std::thread(&ResourceLoader::Run, this);
+}
+
+ResourceLoader::~ResourceLoader()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Running = false;
+    }
+    m_Changed.notify_all();
+    if (m_Thread.joinable())
+        m_Thread.join();
+}
+
+void ResourceLoader::Load(std::function<void()> load, std::function<void()> publish)
+{
+    if (!m_Context)
+    {
+        /* No second context, the load runs on the render thread during Poll */
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Uploads.push_back({ nullptr, [load, publish]() { load(); publish(); } });
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Requests.push_back({ std::move(load), std::move(publish) });
+    }
+    m_Changed.notify_one();
+}
+
+unsigned int ResourceLoader::Poll()
+{
+    std::vector<std::function<void()>> ready;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        for (unsigned int i = 0; i < m_Uploads.size();)
+        {
+            Upload& upload = m_Uploads[i];
+            if (upload.Fence)
+            {
+                /* Timeout 0 only queries the fence */
+                GLenum status = glClientWaitSync(upload.Fence, 0, 0);
+                if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+                {
+                    ++i;
+                    continue;
+                }
+                glDeleteSync(upload.Fence);
+            }
+
+            ready.push_back(std::move(upload.Publish));
+            m_Uploads[i] = std::move(m_Uploads.back());
+            m_Uploads.pop_back();
+        }
+    }
+
+    for (auto& publish : ready)
+        publish();
+    return (unsigned int)ready.size();
+}
+
+unsigned int ResourceLoader::GetPendingCount()
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return (unsigned int)(m_Requests.size() + m_Uploads.size());
+}
+
+void ResourceLoader::Run()
+{
+    m_Context->MakeCurrent();
+    Profiler::SetThreadName("Loader");
+
+    while (true)
+    {
+        Request request;
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_Changed.wait(lock, [this]() { return !m_Requests.empty() || !m_Running; });
+            if (!m_Running)
+                break;
+            request = std::move(m_Requests.front());
+            m_Requests.pop_front();
+        }
+
+        PROFILE_SCOPE("Load");
+        request.Load();
+
+        /* The flush makes sure the fence reaches the GPU, otherwise the render
+         * context could wait on a fence that is never submitted */
+        GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        glFlush();
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Uploads.push_back({ fence, std::move(request.Publish) });
+    }
+
+    /* Fences nobody will poll anymore */
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        for (auto& upload : m_Uploads)
+        {
+            if (upload.Fence)
+                glDeleteSync(upload.Fence);
+        }
+        m_Uploads.clear();
+    }
+
+    m_Context->ReleaseCurrent();
+}
@@ -0,0 +1,98 @@
+#pragma once
+#include <GL/glew.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class RenderContext;
+
+/* A GL object made by the ResourceLoader. Get returns nullptr until the GPU has
+ * finished its upload, after that it can be used on the render thread like any other.
+ * Release the last reference on the render thread, the object is deleted with it. */
+template<typename T>
+class AsyncResource
+{
+private:
+	friend class ResourceLoader;
+
+	std::unique_ptr<T> m_Object;
+	std::atomic<T*> m_Ready;
+
+public:
+	AsyncResource() : m_Ready(nullptr) {}
+
+	inline bool IsReady() const { return m_Ready.load(std::memory_order_acquire) != nullptr; }
+
+	inline T* Get() const { return m_Ready.load(std::memory_order_acquire); }
+};
+
+/* Creates and fills textures and buffers on a thread of its own, through a second
+ * context that shares objects with the main one. Every load ends with a
+ * fence; Poll, called on the render thread once per frame, publishes the loads whose
+ * fence has signaled, so the render thread never blocks on an upload.
+ *
+ * Only shared objects can be made here: buffers, textures, shaders. Vertex arrays
+ * and framebuffers belong to one context and still have to be created by the render
+ * thread.
+ */
+class ResourceLoader
+{
+private:
+	struct Request
+	{
+		std::function<void()> Load;
+		std::function<void()> Publish;
+	};
+
+	struct Upload
+	{
+		GLsync Fence;
+		std::function<void()> Publish;
+	};
+
+	std::unique_ptr<RenderContext> m_Context;
+	std::thread m_Thread;
+
+	std::mutex m_Mutex;
+	std::condition_variable m_Changed;
+	std::deque<Request> m_Requests;
+	std::vector<Upload> m_Uploads;  // fenced, waiting for Poll
+	bool m_Running;
+
+	void Run();
+
+public:
+	/* Call on the main thread, after glewInit, with the context the render thread uses */
+	explicit ResourceLoader(const RenderContext& shareWith);
+
+	/* Call on the main thread, loads still queued are dropped */
+	~ResourceLoader();
+
+	ResourceLoader(const ResourceLoader&) = delete;
+	ResourceLoader& operator=(const ResourceLoader&) = delete;
+
+	/* load runs on the loader thread, publish on the render thread once the GPU is done */
+	void Load(std::function<void()> load, std::function<void()> publish);
+
+	/* Loader thread calls create(), e.g. [] { return new Texture("a.png"); } */
+	template<typename T, typename Function>
+	std::shared_ptr<AsyncResource<T>> Load(Function create)
+	{
+		std::shared_ptr<AsyncResource<T>> resource = std::make_shared<AsyncResource<T>>();
+		AsyncResource<T>* target = resource.get();
+		Load([target, create]() { target->m_Object.reset(create()); },
+			[resource]() { resource->m_Ready.store(resource->m_Object.get(), std::memory_order_release); });
+		return resource;
+	}
+
+	/* Render thread, returns the number of loads published */
+	unsigned int Poll();
+
+	unsigned int GetPendingCount();
+};
@@ -0,0 +1,192 @@
+#pragma once
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <utility>
+
+#include "Renderer.h"
+
+/* 32 bit reference into a ResourcePool: slot index and the generation of the slot
+ * when the object was made. Once the object is released the generation moves on,
+ * so a stale handle resolves to nullptr instead of whatever reuses the slot.
+ * Value 0 is never handed out. */
+template<typename T>
+struct Handle
+{
+	static const unsigned int IndexBits = 20;
+	static const unsigned int IndexMask = (1u << IndexBits) - 1;
+	static const unsigned int GenerationMask = (1u << (32 - IndexBits)) - 1;
+
+	unsigned int Value;
+
+	Handle() : Value(0) {}
+
+	Handle(unsigned int index, unsigned int generation)
+		: Value(((generation & GenerationMask) << IndexBits) | (index & IndexMask)) {}
+
+	inline unsigned int GetIndex() const { return Value & IndexMask; }
+
+	inline unsigned int GetGeneration() const { return Value >> IndexBits; }
+
+	inline bool IsValid() const { return Value != 0; }
+
+	inline bool operator==(const Handle& other) const { return Value == other.Value; }
+
+	inline bool operator!=(const Handle& other) const { return Value != other.Value; }
+};
+
+/* Objects of one type in pages of slots that never move, so pointers stay valid for
+ * the object's lifetime and lookups from other threads need no lock. Slots of
+ * destroyed objects are reused. Objects are refcounted; Release only retires the
+ * handle, destroying is left to the owner (ResourceRegistry defers it).
+ */
+template<typename T>
+class ResourcePool
+{
+public:
+	static const unsigned int PageSize = 256;
+	static const unsigned int MaxPages = (Handle<T>::IndexMask + 1) / PageSize;
+
+private:
+	struct Slot
+	{
+		alignas(T) unsigned char Storage[sizeof(T)];
+		std::atomic<unsigned int> Generation;
+		std::atomic<int> RefCount;
+		unsigned int NextFree;
+		bool Constructed;
+	};
+
+	static const unsigned int EndOfList = 0xffffffff;
+
+	std::atomic<Slot*> m_Pages[MaxPages];
+	std::mutex m_Mutex;
+	unsigned int m_FreeList;
+	unsigned int m_SlotCount;
+	std::atomic<unsigned int> m_Count;
+
+	inline Slot* GetSlot(unsigned int index) const
+	{
+		Slot* page = m_Pages[index / PageSize].load(std::memory_order_acquire);
+		return page ? &page[index % PageSize] : nullptr;
+	}
+
+	unsigned int AllocateSlot()
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		if (m_FreeList != EndOfList)
+		{
+			unsigned int index = m_FreeList;
+			m_FreeList = GetSlot(index)->NextFree;
+			return index;
+		}
+
+		const unsigned int index = m_SlotCount++;
+		ASSERT(index <= Handle<T>::IndexMask);
+		if (index % PageSize == 0)
+		{
+			Slot* page = (Slot*)malloc(sizeof(Slot) * PageSize);
+			ASSERT(page);
+			for (unsigned int i = 0; i < PageSize; ++i)
+			{
+				new (&page[i].Generation) std::atomic<unsigned int>(1);
+				new (&page[i].RefCount) std::atomic<int>(0);
+				page[i].NextFree = EndOfList;
+				page[i].Constructed = false;
+			}
+			m_Pages[index / PageSize].store(page, std::memory_order_release);
+		}
+		return index;
+	}
+
+public:
+	ResourcePool()
+		: m_FreeList(EndOfList), m_SlotCount(0), m_Count(0)
+	{
+		for (auto& page : m_Pages)
+			page.store(nullptr, std::memory_order_relaxed);
+	}
+
+	/* Destroys whatever is still alive, call on the thread that owns the GL context */
+	~ResourcePool()
+	{
+		for (unsigned int i = 0; i < m_SlotCount; ++i)
+		{
+			Slot* slot = GetSlot(i);
+			if (slot->Constructed)
+				((T*)slot->Storage)->~T();
+		}
+		for (auto& page : m_Pages)
+			free(page.load(std::memory_order_relaxed));
+	}
+
+	ResourcePool(const ResourcePool&) = delete;
+	ResourcePool& operator=(const ResourcePool&) = delete;
+
+	/* Constructs the object in place, the handle starts with one reference */
+	template<typename... Args>
+	Handle<T> Create(Args&&... args)
+	{
+		const unsigned int index = AllocateSlot();
+		Slot* slot = GetSlot(index);
+		new (slot->Storage) T(std::forward<Args>(args)...);
+		slot->Constructed = true;
+		slot->RefCount.store(1, std::memory_order_relaxed);
+		m_Count.fetch_add(1, std::memory_order_relaxed);
+		return Handle<T>(index, slot->Generation.load(std::memory_order_relaxed));
+	}
+
+	/* nullptr once the handle is stale, callable from any thread */
+	inline T* Get(Handle<T> handle) const
+	{
+		if (!handle.IsValid())
+			return nullptr;
+		Slot* slot = GetSlot(handle.GetIndex());
+		if (!slot || slot->Generation.load(std::memory_order_acquire) != handle.GetGeneration())
+			return nullptr;
+		return (T*)slot->Storage;
+	}
+
+	inline bool IsAlive(Handle<T> handle) const { return Get(handle) != nullptr; }
+
+	/* Only while the caller holds a reference itself */
+	void AddRef(Handle<T> handle)
+	{
+		if (Get(handle))
+			GetSlot(handle.GetIndex())->RefCount.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	/* True when this dropped the last reference: the handle is stale from now on and
+	 * the caller must Destroy the slot once nothing uses the object anymore */
+	bool Release(Handle<T> handle)
+	{
+		if (!Get(handle))
+			return false;
+
+		Slot* slot = GetSlot(handle.GetIndex());
+		if (slot->RefCount.fetch_sub(1, std::memory_order_acq_rel) != 1)
+			return false;
+
+		unsigned int generation = (handle.GetGeneration() + 1) & Handle<T>::GenerationMask;
+		slot->Generation.store(generation ? generation : 1, std::memory_order_release);
+		m_Count.fetch_sub(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	/* Runs the destructor of a released slot and recycles it */
+	void Destroy(unsigned int index)
+	{
+		Slot* slot = GetSlot(index);
+		ASSERT(slot && slot->Constructed);
+		((T*)slot->Storage)->~T();
+		slot->Constructed = false;
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		slot->NextFree = m_FreeList;
+		m_FreeList = index;
+	}
+
+	// Objects with live handles
+	inline unsigned int GetCount() const { return m_Count.load(std::memory_order_relaxed); }
+};
@@ -0,0 +1,66 @@
+#include "ResourceRegistry.h"
+
+const unsigned int ResourceRegistry::DeferredFrames;
+
+ResourceRegistry::ResourceRegistry()
+    : m_Frame(0)
+{
+}
+
+ResourceRegistry::~ResourceRegistry()
+{
+    /* The pools destroy whatever is still referenced when they go */
+    for (auto& bucket : m_Pending)
+        DestroyBucket(bucket);
+    for (const auto& deletion : m_Released)
+        deletion.Destroy(*this, deletion.Index);
+}
+
+void ResourceRegistry::DestroyBucket(Bucket& bucket)
+{
+    if (bucket.Fence)
+        glDeleteSync(bucket.Fence);
+    for (const auto& deletion : bucket.Deletions)
+        deletion.Destroy(*this, deletion.Index);
+}
+
+void ResourceRegistry::Collect()
+{
+    ++m_Frame;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (!m_Released.empty())
+        {
+            m_Pending.push_back({ m_Frame, nullptr, std::vector<Deletion>() });
+            m_Pending.back().Deletions.swap(m_Released);
+        }
+    }
+
+    for (auto& bucket : m_Pending)
+    {
+        /* Fence right behind the last frame that may still reference the bucket */
+        if (!bucket.Fence && m_Frame >= bucket.Frame + DeferredFrames)
+            bucket.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+
+    while (!m_Pending.empty() && m_Pending.front().Fence)
+    {
+        /* Timeout 0 only queries the fence, buckets signal in order */
+        GLenum status = glClientWaitSync(m_Pending.front().Fence, 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+            break;
+
+        DestroyBucket(m_Pending.front());
+        m_Pending.pop_front();
+    }
+}
+
+unsigned int ResourceRegistry::GetPendingCount()
+{
+    unsigned int count = 0;
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    count += (unsigned int)m_Released.size();
+    for (const auto& bucket : m_Pending)
+        count += (unsigned int)bucket.Deletions.size();
+    return count;
+}
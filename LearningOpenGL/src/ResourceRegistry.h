@@ -0,0 +1,164 @@
+#pragma once
+#include <GL/glew.h>
+
+#include <deque>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+#include "ResourcePool.h"
+#include "VertexBuffer.h"
+#include "IndexBuffer.h"
+#include "VertexArray.h"
+#include "Shader.h"
+#include "Texture.h"
+
+typedef Handle<VertexBuffer> VertexBufferHandle;
+typedef Handle<IndexBuffer> IndexBufferHandle;
+typedef Handle<VertexArray> VertexArrayHandle;
+typedef Handle<Shader> ShaderHandle;
+typedef Handle<Texture> TextureHandle;
+
+/* Owns every GL object behind a handle. Releasing the last reference retires the
+ * handle right away, but the object itself is only destroyed once DeferredFrames
+ * frames have been recorded since and a fence says the GPU is past them, so
+ * commands already in flight never see a deleted name and nothing stalls on delete.
+ *
+ * Create and Collect need the GL context (render or loader thread); Get, AddRef
+ * and Release work from any thread.
+ */
+class ResourceRegistry
+{
+public:
+	static const unsigned int DeferredFrames = 2;
+
+private:
+	struct Deletion
+	{
+		void (*Destroy)(ResourceRegistry& registry, unsigned int index);
+		unsigned int Index;
+	};
+
+	struct Bucket
+	{
+		unsigned long long Frame;
+		GLsync Fence;
+		std::vector<Deletion> Deletions;
+	};
+
+	std::tuple<ResourcePool<VertexBuffer>, ResourcePool<IndexBuffer>, ResourcePool<VertexArray>,
+		ResourcePool<Shader>, ResourcePool<Texture>> m_Pools;
+
+	std::mutex m_Mutex;
+	std::vector<Deletion> m_Released;  // released since the last Collect
+	std::deque<Bucket> m_Pending;
+	unsigned long long m_Frame;
+
+	template<typename T>
+	static void DestroyObject(ResourceRegistry& registry, unsigned int index)
+	{
+		registry.GetPool<T>().Destroy(index);
+	}
+
+	void DestroyBucket(Bucket& bucket);
+
+public:
+	ResourceRegistry();
+
+	/* Destroys everything, pending or alive. Call with the context current */
+	~ResourceRegistry();
+
+	ResourceRegistry(const ResourceRegistry&) = delete;
+	ResourceRegistry& operator=(const ResourceRegistry&) = delete;
+
+	template<typename T>
+	inline ResourcePool<T>& GetPool() { return std::get<ResourcePool<T>>(m_Pools); }
+
+	template<typename T>
+	inline const ResourcePool<T>& GetPool() const { return std::get<ResourcePool<T>>(m_Pools); }
+
+	template<typename T, typename... Args>
+	inline Handle<T> Create(Args&&... args) { return GetPool<T>().Create(std::forward<Args>(args)...); }
+
+	template<typename T>
+	inline T* Get(Handle<T> handle) const { return GetPool<T>().Get(handle); }
+
+	template<typename T>
+	inline void AddRef(Handle<T> handle) { GetPool<T>().AddRef(handle); }
+
+	template<typename T>
+	void Release(Handle<T> handle)
+	{
+		if (!GetPool<T>().Release(handle))
+			return;
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Released.push_back({ &DestroyObject<T>, handle.GetIndex() });
+	}
+
+	/* Once per frame on the render thread: closes this frame's releases, fences the
+	 * ones that are old enough and destroys those whose fence has signaled */
+	void Collect();
+
+	// Released objects not destroyed yet, render thread
+	unsigned int GetPendingCount();
+};
+
+/* Move-only owner of one reference, releases it on destruction. Share hands out
+ * another reference to the same object. */
+template<typename T>
+class ResourceRef
+{
+private:
+	ResourceRegistry* m_Registry;
+	Handle<T> m_Handle;
+
+public:
+	ResourceRef() : m_Registry(nullptr) {}
+
+	// Takes over a reference the caller holds, e.g. the one Create returns
+	ResourceRef(ResourceRegistry& registry, Handle<T> handle) : m_Registry(&registry), m_Handle(handle) {}
+
+	ResourceRef(ResourceRef&& other) : m_Registry(other.m_Registry), m_Handle(other.m_Handle)
+	{
+		other.m_Registry = nullptr;
+		other.m_Handle = Handle<T>();
+	}
+
+	ResourceRef& operator=(ResourceRef&& other)
+	{
+		if (this != &other)
+		{
+			Reset();
+			std::swap(m_Registry, other.m_Registry);
+			std::swap(m_Handle, other.m_Handle);
+		}
+		return *this;
+	}
+
+	ResourceRef(const ResourceRef&) = delete;
+	ResourceRef& operator=(const ResourceRef&) = delete;
+
+	~ResourceRef() { Reset(); }
+
+	void Reset()
+	{
+		if (m_Registry)
+			m_Registry->Release(m_Handle);
+		m_Registry = nullptr;
+		m_Handle = Handle<T>();
+	}
+
+	ResourceRef Share() const
+	{
+		if (!m_Registry)
+			return ResourceRef();
+		m_Registry->AddRef(m_Handle);
+		return ResourceRef(*m_Registry, m_Handle);
+	}
+
+	inline T* Get() const { return m_Registry ? m_Registry->Get(m_Handle) : nullptr; }
+
+	inline T* operator->() const { return Get(); }
+
+	inline Handle<T> GetHandle() const { return m_Handle; }
+};
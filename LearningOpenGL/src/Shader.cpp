@@ -1,10 +1,13 @@
 #include "Shader.h"
 #include "Renderer.h"
 
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <cstring>
 #include <iostream>
-#include <fstream>
 #include <string>
-#include <sstream>
+#include <vector>
 
 
 
@@ -16,13 +19,42 @@ Shader::Shader(const std::string& filePath)
     m_RendererID = CreateShader(source.VertexShader, source.FragmentShader);
 }
 
+Shader::Shader(Shader&& other) noexcept
+    : m_RendererID(other.m_RendererID),
+      m_filePath(std::move(other.m_filePath)),
+      m_UniformLocationCache(std::move(other.m_UniformLocationCache))
+{
+    other.m_RendererID = 0;
+}
+
+Shader& Shader::operator=(Shader&& other) noexcept
+{
+    if (this != &other)
+    {
+        if (m_RendererID)
+        {
+            GLCall(glDeleteProgram(m_RendererID));
+        }
+        m_RendererID = other.m_RendererID;
+        m_filePath = std::move(other.m_filePath);
+        m_UniformLocationCache = std::move(other.m_UniformLocationCache);
+        other.m_RendererID = 0;
+        other.m_UniformLocationCache.clear();
+    }
+    return *this;
+}
+
 Shader::~Shader()
 {
-    GLCall(glDeleteProgram(m_RendererID));
+    if (m_RendererID)
+    {
+        GLCall(glDeleteProgram(m_RendererID));
+    }
 }
 
 void Shader::Bind() const
 {
+    RenderStats::Add(RenderCounter::ShaderBinds);
     GLCall(glUseProgram(m_RendererID));
 }
 
@@ -34,23 +66,27 @@ void Shader::Unbind() const
 void Shader::SetUniform1i(const std::string& name, int value)
 {
     GLCall(glUniform1i(GetUniformLocation(name), value));
+    RenderStats::Add(RenderCounter::UniformUploads);
 }
 
 void Shader::SetUniform4f(const std::string& name, float f0, float f1, float f2, float f3)
 {
     GLCall(glUniform4f(GetUniformLocation(name), f0, f1, f2, f3));
+    RenderStats::Add(RenderCounter::UniformUploads);
 }
 
 void Shader::SetUniformMat4f(const std::string& name, const glm::mat4& matrix)
 {
     GLCall(glUniformMatrix4fv(GetUniformLocation(name), 1, GL_FALSE, &matrix[0][0]));
+    RenderStats::Add(RenderCounter::UniformUploads);
 }
 
 int Shader::GetUniformLocation(const std::string& name)
 {
-    if (m_UniformLocationCache.find(name) != m_UniformLocationCache.end())
+    auto cached = m_UniformLocationCache.find(name);
+    if (cached != m_UniformLocationCache.end())
     {
-        return m_UniformLocationCache[name];
+        return cached->second;
     }
 
     GLCall(int location = glGetUniformLocation(m_RendererID, name.c_str()));
@@ -66,35 +102,62 @@ int Shader::GetUniformLocation(const std::string& name)
 
 ShaderProgramSource Shader::ParseShader()
 {
-    std::ifstream stream(m_filePath);
+    ShaderProgramSource source;
+
+    /* One mapping and two strings instead of a line by line stream copy */
+    MappedFile file;
+    if (!file.Open(m_filePath))
+    {
+        std::cout << "Error: Failed to open shader " << m_filePath << std::endl;
+        return source;
+    }
 
     enum class ShaderType {
         NONE = -1, VERTEX = 0, FRAGMENT = 1
     };
 
-    std::string line;
-    std::stringstream ss[2];
+    const char* data = (const char*)file.GetData();
+    const char* end = data + file.GetSize();
+    std::string* targets[2] = { &source.VertexShader, &source.FragmentShader };
+    targets[0]->reserve((size_t)file.GetSize());
+    targets[1]->reserve((size_t)file.GetSize());
+
+    auto contains = [](const char* begin, const char* end, const char* word)
+    {
+        return std::search(begin, end, word, word + strlen(word)) != end;
+    };
+
     ShaderType type = ShaderType::NONE;
-    while (std::getline(stream, line))
+    for (const char* line = data; line < end;)
     {
-        if (line.find("#shader") != std::string::npos)
+        const char* lineEnd = (const char*)memchr(line, '\n', end - line);
+        if (!lineEnd)
+            lineEnd = end;
+
+        const size_t length = lineEnd - line;
+        if (contains(line, lineEnd, "#shader"))
         {
-            if (line.find("vertex") != std::string::npos)
+            if (contains(line, lineEnd, "vertex"))
             {
                 type = ShaderType::VERTEX;
             }
-            else if (line.find("fragment") != std::string::npos)
+            else if (contains(line, lineEnd, "fragment"))
             {
                 type = ShaderType::FRAGMENT;
             }
         }
-        else
+        else if (type != ShaderType::NONE)
         {
-            ss[(int)type] << line << '\n';
+            /* The text mode stream used to drop the '\r' of CRLF files, keep doing that */
+            size_t kept = length && line[length - 1] == '\r' ? length - 1 : length;
+            targets[(int)type]->append(line, kept);
+            targets[(int)type]->push_back('\n');
         }
+
+        line = lineEnd + 1;
     }
 
-    return { ss[0].str(), ss[1].str() };
+    return source;
 }
 
 unsigned int Shader::CompileShader(unsigned int type, const std::string& source)
@@ -117,13 +180,14 @@ unsigned int Shader::CompileShader(unsigned int type, const std::string& source)
     {
         int length;
         glGetShaderiv(id, GL_INFO_LOG_LENGTH, &length);
-        char* message = (char*)malloc(length * sizeof(char));
+        std::vector<char> message(length > 0 ? length : 1, '\0');
 
-        glGetShaderInfoLog(id, length, &length, message);
+        glGetShaderInfoLog(id, length, &length, message.data());
         std::cout << "Failed to compile "
             << (type == GL_VERTEX_SHADER ? "vertex" : "fragment")
             << " shader." << std::endl;
-        std::cout << message << std::endl;
+        std::cout << message.data() << std::endl;
+        glDeleteShader(id);
         return 0;
     }
 
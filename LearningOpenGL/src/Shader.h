@@ -2,7 +2,7 @@
 #include <string>
 #include <unordered_map>
 
-#include "glm\glm.hpp"
+#include "glm/glm.hpp"
 
 struct ShaderProgramSource
 {
@@ -24,6 +24,15 @@ public:
 
 	~Shader();
 
+	// Move only, a moved-from object owns GL name 0
+	Shader(Shader&& other) noexcept;
+
+	Shader& operator=(Shader&& other) noexcept;
+
+	Shader(const Shader&) = delete;
+
+	Shader& operator=(const Shader&) = delete;
+
 	void Bind() const;
 
 	void Unbind() const;
@@ -35,6 +44,8 @@ public:
 
 	void SetUniformMat4f(const std::string& name, const glm::mat4& matrix);
 
+	inline unsigned int GetRendererID() const { return m_RendererID; }
+
 private:
 	int GetUniformLocation(const std::string& name);
 
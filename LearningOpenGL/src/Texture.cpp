@@ -1,5 +1,5 @@
 #include "Texture.h"
-#include "stb_image\stb_image.h"
+#include "stb_image/stb_image.h"
 
 Texture::Texture(const std::string& filePath)
 	: m_RendererID(0),
@@ -12,6 +12,24 @@ Texture::Texture(const std::string& filePath)
 	stbi_set_flip_vertically_on_load(1);
 	m_LocalBuffer = stbi_load(m_filePath.c_str(), &m_Width, &m_Height, &m_BPP, 4); // Load RGBA image.
 
+	Upload();
+}
+
+Texture::Texture(const unsigned char* encoded, unsigned int size)
+	: m_RendererID(0),
+	  m_LocalBuffer(nullptr),
+	  m_Width(0),
+	  m_Height(0),
+	  m_BPP(0)
+{
+	stbi_set_flip_vertically_on_load(1);
+	m_LocalBuffer = stbi_load_from_memory(encoded, (int)size, &m_Width, &m_Height, &m_BPP, 4);
+
+	Upload();
+}
+
+void Texture::Upload()
+{
 	GLCall(glGenTextures(1, &m_RendererID));
 	GLCall(glBindTexture(GL_TEXTURE_2D, m_RendererID));
 
@@ -21,20 +39,60 @@ Texture::Texture(const std::string& filePath)
 	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
 
 	GLCall(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_Width, m_Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, m_LocalBuffer));
+	RenderStats::Add(RenderCounter::TextureBytesUploaded, (unsigned long long)m_Width * m_Height * 4);
 	GLCall(glBindTexture(GL_TEXTURE_2D, 0));
 }
 
+Texture::Texture(Texture&& other) noexcept
+	: m_RendererID(other.m_RendererID),
+	  m_filePath(std::move(other.m_filePath)),
+	  m_LocalBuffer(other.m_LocalBuffer),
+	  m_Width(other.m_Width),
+	  m_Height(other.m_Height),
+	  m_BPP(other.m_BPP)
+{
+	other.m_RendererID = 0;
+	other.m_LocalBuffer = nullptr;
+}
+
+Texture& Texture::operator=(Texture&& other) noexcept
+{
+	if (this != &other)
+	{
+		if (m_LocalBuffer)
+			stbi_image_free(m_LocalBuffer);
+		if (m_RendererID)
+		{
+			GLCall(glDeleteTextures(1, &m_RendererID));
+		}
+
+		m_RendererID = other.m_RendererID;
+		m_filePath = std::move(other.m_filePath);
+		m_LocalBuffer = other.m_LocalBuffer;
+		m_Width = other.m_Width;
+		m_Height = other.m_Height;
+		m_BPP = other.m_BPP;
+		other.m_RendererID = 0;
+		other.m_LocalBuffer = nullptr;
+	}
+	return *this;
+}
+
 Texture::~Texture()
 {
 	if (m_LocalBuffer)
 	{
 		stbi_image_free(m_LocalBuffer);
 	}
-	GLCall(glDeleteTextures(1, &m_RendererID));
+	if (m_RendererID)
+	{
+		GLCall(glDeleteTextures(1, &m_RendererID));
+	}
 }
 
 void Texture::Bind(unsigned int slot) const
 {
+	RenderStats::Add(RenderCounter::TextureBinds);
 	GLCall(glActiveTexture(GL_TEXTURE0 + slot));
 	GLCall(glBindTexture(GL_TEXTURE_2D, m_RendererID));
 }
@@ -13,11 +13,25 @@ private:
 
 	int m_Width, m_Height, m_BPP;
 
+	void Upload();
+
 public:
 	Texture(const std::string& filePath);
+
+	// Decode an image file that is already in memory (png, jpg...), e.g. embedded in a .glb
+	Texture(const unsigned char* encoded, unsigned int size);
 	
 	~Texture();
 
+	// Move only, a moved-from object owns GL name 0
+	Texture(Texture&& other) noexcept;
+
+	Texture& operator=(Texture&& other) noexcept;
+
+	Texture(const Texture&) = delete;
+
+	Texture& operator=(const Texture&) = delete;
+
 	void Bind(unsigned int slot = 0) const;
 
 	void Unbind() const;
@@ -25,4 +39,6 @@ public:
 	inline int GetWidth() const { return m_Width; }
 
 	inline int GetHeight() const { return m_Height; }
+
+	inline unsigned int GetRendererID() const { return m_RendererID; }
 };
@@ -0,0 +1,203 @@
+#include "TransformHierarchy.h"
+#include "ParallelFor.h"
+#include "Renderer.h"
+
+#include <cstring>
+#include <type_traits>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define TRANSFORM_SSE 1
+#include <xmmintrin.h>
+#endif
+
+const unsigned int TransformHierarchy::InvalidNode;
+const unsigned int TransformHierarchy::BatchSize;
+
+/* Removed nodes keep their slot until the next sort */
+static const unsigned char Removed = 0x80;
+
+/* out = parent * T * R * S */
+static void ComposeWorld(const glm::mat4& parent, const glm::vec3& position, const glm::quat& rotation,
+    const glm::vec3& scale, glm::mat4& out)
+{
+    glm::mat3 basis = glm::mat3_cast(rotation);
+    glm::mat4 local(glm::vec4(basis[0] * scale.x, 0.0f), glm::vec4(basis[1] * scale.y, 0.0f),
+        glm::vec4(basis[2] * scale.z, 0.0f), glm::vec4(position, 1.0f));
+
+#ifdef TRANSFORM_SSE
+    /* glm stores columns contiguously, each output column is parent * local column */
+    const float* p = &parent[0][0];
+    const __m128 p0 = _mm_loadu_ps(p), p1 = _mm_loadu_ps(p + 4), p2 = _mm_loadu_ps(p + 8), p3 = _mm_loadu_ps(p + 12);
+    for (int c = 0; c < 4; ++c)
+    {
+        __m128 result = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(p0, _mm_set1_ps(local[c].x)), _mm_mul_ps(p1, _mm_set1_ps(local[c].y))),
+            _mm_add_ps(_mm_mul_ps(p2, _mm_set1_ps(local[c].z)), _mm_mul_ps(p3, _mm_set1_ps(local[c].w))));
+        _mm_storeu_ps(&out[c][0], result);
+    }
+#else
+    out = parent * local;
+#endif
+}
+
+TransformHierarchy::TransformHierarchy()
+    : m_NeedsSort(false)
+{
+}
+
+unsigned int TransformHierarchy::Add(unsigned int parent)
+{
+    unsigned int parentIndex = parent == InvalidNode ? InvalidNode : m_HandleToIndex[parent];
+    unsigned int depth = parentIndex == InvalidNode ? 0 : m_Depth[parentIndex] + 1;
+
+    unsigned int handle;
+    if (!m_FreeHandles.empty())
+    {
+        handle = m_FreeHandles.back();
+        m_FreeHandles.pop_back();
+    }
+    else
+    {
+        handle = (unsigned int)m_HandleToIndex.size();
+        m_HandleToIndex.push_back(InvalidNode);
+    }
+
+    /* Appending keeps depth order only while the new node is at least as deep as the last one */
+    if (!m_Depth.empty() && depth < m_Depth.back())
+        m_NeedsSort = true;
+
+    unsigned int index = (unsigned int)m_Parent.size();
+    m_HandleToIndex[handle] = index;
+    m_IndexToHandle.push_back(handle);
+    m_Parent.push_back(parentIndex);
+    m_Depth.push_back(depth);
+    m_LocalPosition.push_back(glm::vec3(0.0f));
+    m_LocalRotation.push_back(glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+    m_LocalScale.push_back(glm::vec3(1.0f));
+    m_World.push_back(glm::mat4(1.0f));
+    m_Dirty.push_back(1);
+
+    if (!m_NeedsSort)
+    {
+        if (m_LevelStart.size() < depth + 2)
+            m_LevelStart.resize(depth + 2, index);
+        m_LevelStart[depth + 1] = index + 1;
+    }
+    return handle;
+}
+
+void TransformHierarchy::Remove(unsigned int node)
+{
+    m_Dirty[m_HandleToIndex[node]] |= Removed;
+    m_NeedsSort = true;
+}
+
+unsigned int TransformHierarchy::GetParent(unsigned int node) const
+{
+    unsigned int parent = m_Parent[m_HandleToIndex[node]];
+    return parent == InvalidNode ? InvalidNode : m_IndexToHandle[parent];
+}
+
+/* Stable counting sort by depth that also drops removed subtrees */
+void TransformHierarchy::Sort()
+{
+    m_NeedsSort = false;
+    const unsigned int count = GetCount();
+
+    /* Parents always sit before their children here too, one pass finds removed subtrees */
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        if (m_Parent[i] != InvalidNode && (m_Dirty[m_Parent[i]] & Removed))
+            m_Dirty[i] |= Removed;
+    }
+
+    unsigned int levels = 0;
+    for (unsigned int i = 0; i < count; ++i)
+        levels = std::max(levels, m_Depth[i] + 1);
+
+    std::vector<unsigned int> start(levels + 1, 0);
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        if (!(m_Dirty[i] & Removed))
+            ++start[m_Depth[i] + 1];
+    }
+    for (unsigned int d = 0; d < levels; ++d)
+        start[d + 1] += start[d];
+    m_LevelStart = start;
+
+    std::vector<unsigned int> newIndex(count, InvalidNode);
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        if (!(m_Dirty[i] & Removed))
+            newIndex[i] = start[m_Depth[i]]++;
+        else
+        {
+            m_HandleToIndex[m_IndexToHandle[i]] = InvalidNode;
+            m_FreeHandles.push_back(m_IndexToHandle[i]);
+        }
+    }
+
+    const unsigned int newCount = m_LevelStart.back();
+    auto permute = [&](auto& values)
+    {
+        typename std::remove_reference<decltype(values)>::type sorted(newCount);
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            if (newIndex[i] != InvalidNode)
+                sorted[newIndex[i]] = values[i];
+        }
+        values.swap(sorted);
+    };
+
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        if (m_Parent[i] != InvalidNode)
+            m_Parent[i] = newIndex[m_Parent[i]];
+    }
+    permute(m_Parent);
+    permute(m_Depth);
+    permute(m_LocalPosition);
+    permute(m_LocalRotation);
+    permute(m_LocalScale);
+    permute(m_World);
+    permute(m_Dirty);
+    permute(m_IndexToHandle);
+
+    for (unsigned int i = 0; i < newCount; ++i)
+        m_HandleToIndex[m_IndexToHandle[i]] = i;
+}
+
+void TransformHierarchy::UpdateRange(unsigned int begin, unsigned int end)
+{
+    for (unsigned int i = begin; i < end; ++i)
+    {
+        unsigned int parent = m_Parent[i];
+        if (parent != InvalidNode)
+            m_Dirty[i] |= m_Dirty[parent];
+        if (!m_Dirty[i])
+            continue;
+
+        static const glm::mat4 identity(1.0f);
+        ComposeWorld(parent != InvalidNode ? m_World[parent] : identity,
+            m_LocalPosition[i], m_LocalRotation[i], m_LocalScale[i], m_World[i]);
+    }
+}
+
+void TransformHierarchy::Update()
+{
+    if (m_NeedsSort)
+        Sort();
+
+    /* Nodes of one level only read the previous one, so each level is a parallel loop */
+    for (unsigned int level = 0; level + 1 < m_LevelStart.size(); ++level)
+    {
+        unsigned int begin = m_LevelStart[level], end = m_LevelStart[level + 1];
+        ParallelFor(end - begin, BatchSize, [this, begin](unsigned int first, unsigned int last)
+        {
+            UpdateRange(begin + first, begin + last);
+        });
+    }
+
+    if (!m_Dirty.empty())
+        memset(m_Dirty.data(), 0, m_Dirty.size());
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include <vector>
+
+#include "glm/glm.hpp"
+#include "glm/gtc/quaternion.hpp"
+
+/* Scene transforms as structure of arrays. Nodes are stored sorted by depth in the
+ * hierarchy, so every parent comes before its children and a whole depth level can be
+ * updated in parallel. Only nodes whose local transform changed, and everything below
+ * them, get a new world matrix in Update.
+ *
+ * Handles are stable, dense indices change whenever nodes are added or removed.
+ */
+class TransformHierarchy
+{
+public:
+	static const unsigned int InvalidNode = 0xffffffff;
+
+	// Nodes per thread when a level is updated in parallel
+	static const unsigned int BatchSize = 4096;
+
+private:
+	std::vector<unsigned int> m_Parent;    // dense index, InvalidNode for roots
+	std::vector<unsigned int> m_Depth;
+	std::vector<glm::vec3> m_LocalPosition;
+	std::vector<glm::quat> m_LocalRotation;
+	std::vector<glm::vec3> m_LocalScale;
+	std::vector<glm::mat4> m_World;
+	std::vector<unsigned char> m_Dirty;
+
+	// First dense index of every depth, plus the end
+	std::vector<unsigned int> m_LevelStart;
+
+	std::vector<unsigned int> m_HandleToIndex;
+	std::vector<unsigned int> m_IndexToHandle;
+	std::vector<unsigned int> m_FreeHandles;
+
+	bool m_NeedsSort;
+
+	void Sort();
+
+	void UpdateRange(unsigned int begin, unsigned int end);
+
+public:
+	TransformHierarchy();
+
+	unsigned int Add(unsigned int parent = InvalidNode);
+
+	/* Removes the node together with everything below it */
+	void Remove(unsigned int node);
+
+	inline void SetLocalPosition(unsigned int node, const glm::vec3& position)
+	{
+		unsigned int index = m_HandleToIndex[node];
+		m_LocalPosition[index] = position;
+		m_Dirty[index] |= 1;
+	}
+
+	inline void SetLocalRotation(unsigned int node, const glm::quat& rotation)
+	{
+		unsigned int index = m_HandleToIndex[node];
+		m_LocalRotation[index] = rotation;
+		m_Dirty[index] |= 1;
+	}
+
+	inline void SetLocalScale(unsigned int node, const glm::vec3& scale)
+	{
+		unsigned int index = m_HandleToIndex[node];
+		m_LocalScale[index] = scale;
+		m_Dirty[index] |= 1;
+	}
+
+	inline const glm::vec3& GetLocalPosition(unsigned int node) const { return m_LocalPosition[m_HandleToIndex[node]]; }
+
+	inline const glm::quat& GetLocalRotation(unsigned int node) const { return m_LocalRotation[m_HandleToIndex[node]]; }
+
+	inline const glm::vec3& GetLocalScale(unsigned int node) const { return m_LocalScale[m_HandleToIndex[node]]; }
+
+	// Valid after Update
+	inline const glm::mat4& GetWorldMatrix(unsigned int node) const { return m_World[m_HandleToIndex[node]]; }
+
+	unsigned int GetParent(unsigned int node) const;
+
+	/* Recomputes world matrices of dirty subtrees, level by level */
+	void Update();
+
+	inline unsigned int GetCount() const { return (unsigned int)m_Parent.size(); }
+
+	inline unsigned int GetLevelCount() const { return m_LevelStart.empty() ? 0 : (unsigned int)m_LevelStart.size() - 1; }
+};
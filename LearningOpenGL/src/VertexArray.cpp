@@ -8,32 +8,80 @@ VertexArray::VertexArray()
 	GLCall(glGenVertexArrays(1, &m_RendererID));
 }
 
+VertexArray::VertexArray(VertexArray&& other) noexcept
+	: m_RendererID(other.m_RendererID)
+{
+	other.m_RendererID = 0;
+}
+
+VertexArray& VertexArray::operator=(VertexArray&& other) noexcept
+{
+	if (this != &other)
+	{
+		if (m_RendererID)
+		{
+			GLCall(glDeleteVertexArrays(1, &m_RendererID));
+		}
+		m_RendererID = other.m_RendererID;
+		other.m_RendererID = 0;
+	}
+	return *this;
+}
+
 VertexArray::~VertexArray()
 {
-	GLCall(glDeleteVertexArrays(1, &m_RendererID));
+	if (m_RendererID)
+	{
+		GLCall(glDeleteVertexArrays(1, &m_RendererID));
+	}
 }
 
-void VertexArray::AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout)
+void VertexArray::AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout, unsigned int offset)
 {
 	Bind();
 	vb.Bind();
 
 	const auto& elements = layout.GetElements();
-	unsigned int offset = 0;
 	for (unsigned i = 0; i < elements.size(); ++i)
 	{
 		const auto& element = elements[i];
 		GLCall(glEnableVertexAttribArray(i));
 		GLCall(glVertexAttribPointer(
 			i, element.count, element.type, element.normalized, 
-			layout.GetStride(), (const void*)offset
+			layout.GetStride(), (const void*)(size_t)offset
 		));
 		offset += element.count * VertexBufferElement::GetSizeOfType(element.type);
 	}
 }
 
+void VertexArray::SetFormat(const VertexBufferLayout& layout, unsigned int binding)
+{
+	Bind();
+
+	const auto& elements = layout.GetElements();
+	unsigned int offset = 0;
+	for (unsigned i = 0; i < elements.size(); ++i)
+	{
+		const auto& element = elements[i];
+		GLCall(glEnableVertexAttribArray(i));
+		/* Unlike glVertexAttribPointer, offset is relative to the start of a vertex
+		 * and no buffer is captured here.
+		 */
+		GLCall(glVertexAttribFormat(i, element.count, element.type, element.normalized, offset));
+		GLCall(glVertexAttribBinding(i, binding));
+		offset += element.count * VertexBufferElement::GetSizeOfType(element.type);
+	}
+}
+
+void VertexArray::BindVertexBuffer(const VertexBuffer& vb, unsigned int stride, unsigned int offset, unsigned int binding)
+{
+	Bind();
+	GLCall(glBindVertexBuffer(binding, vb.GetRendererID(), offset, stride));
+}
+
 void VertexArray::Bind() const
 {
+	RenderStats::Add(RenderCounter::VertexArrayBinds);
 	GLCall(glBindVertexArray(m_RendererID));
 }
 
@@ -13,7 +13,23 @@ public:
 
 	~VertexArray();
 
-	void AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout);
+	// Move only, a moved-from object owns GL name 0
+	VertexArray(VertexArray&& other) noexcept;
+
+	VertexArray& operator=(VertexArray&& other) noexcept;
+
+	VertexArray(const VertexArray&) = delete;
+
+	VertexArray& operator=(const VertexArray&) = delete;
+
+	void AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout, unsigned int offset = 0);
+
+	/* Separate attribute format (ARB_vertex_attrib_binding): the format is specified
+	 * once and buffers are attached to a binding point afterwards.
+	 */
+	void SetFormat(const VertexBufferLayout& layout, unsigned int binding = 0);
+
+	void BindVertexBuffer(const VertexBuffer& vb, unsigned int stride, unsigned int offset = 0, unsigned int binding = 0);
 
 	void Bind() const;
 
@@ -0,0 +1,64 @@
+#include "VertexArrayCache.h"
+
+#include "Renderer.h"
+
+VertexArrayCache::VertexArrayCache()
+    : m_SeparateFormat(GLEW_ARB_vertex_attrib_binding || GLEW_VERSION_4_3)
+{
+}
+
+VertexArrayCache::Entry& VertexArrayCache::GetEntry(const VertexBufferLayout& layout)
+{
+    auto it = m_Cache.find(layout.GetHash());
+    if (it != m_Cache.end())
+    {
+        // Two different formats hashing to the same value would silently share a VAO
+        ASSERT(it->second.Layout == layout);
+        return it->second;
+    }
+
+    Entry& entry = m_Cache[layout.GetHash()];
+    entry.Layout = layout;
+    entry.BoundBuffer = 0;
+    entry.BoundOffset = 0;
+
+    if (m_SeparateFormat)
+    {
+        entry.VAO.SetFormat(layout);
+    }
+    return entry;
+}
+
+const VertexArray& VertexArrayCache::Get(const VertexBufferLayout& layout)
+{
+    return GetEntry(layout).VAO;
+}
+
+const VertexArray& VertexArrayCache::Bind(const VertexBufferLayout& layout, const VertexBuffer& vb, unsigned int offset)
+{
+    Entry& entry = GetEntry(layout);
+
+    if (entry.BoundBuffer == vb.GetRendererID() && entry.BoundOffset == offset)
+    {
+        entry.VAO.Bind();
+        return entry.VAO;
+    }
+
+    if (m_SeparateFormat)
+    {
+        entry.VAO.BindVertexBuffer(vb, layout.GetStride(), offset);
+    }
+    else
+    {
+        entry.VAO.AddBuffer(vb, layout, offset);
+    }
+
+    entry.BoundBuffer = vb.GetRendererID();
+    entry.BoundOffset = offset;
+    return entry.VAO;
+}
+
+void VertexArrayCache::Clear()
+{
+    m_Cache.clear();
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <memory>
+#include <unordered_map>
+
+#include "VertexArray.h"
+#include "VertexBufferLayout.h"
+
+/* One VAO per vertex format instead of one per mesh.
+ * With ARB_vertex_attrib_binding the attribute format is specified once when the
+ * VAO is created, and switching between meshes of the same format only costs a
+ * glBindVertexBuffer. Without it we fall back to re-specifying the attribute
+ * pointers, which still saves creating a VAO per mesh.
+ */
+class VertexArrayCache
+{
+private:
+	struct Entry
+	{
+		VertexBufferLayout Layout;
+		VertexArray VAO;
+
+		// Buffer currently attached to binding 0, so redundant switches are skipped
+		unsigned int BoundBuffer;
+		unsigned int BoundOffset;
+	};
+
+	std::unordered_map<unsigned long long, Entry> m_Cache;
+
+	bool m_SeparateFormat;
+
+	Entry& GetEntry(const VertexBufferLayout& layout);
+
+public:
+	VertexArrayCache();
+
+	// Returns the shared VAO for this format, creating it on first use
+	const VertexArray& Get(const VertexBufferLayout& layout);
+
+	// Binds the shared VAO and attaches vb (starting at offset bytes) to it
+	const VertexArray& Bind(const VertexBufferLayout& layout, const VertexBuffer& vb, unsigned int offset = 0);
+
+	void Clear();
+
+	inline unsigned int GetSize() const { return (unsigned int)m_Cache.size(); }
+
+	inline bool IsSeparateFormatSupported() const { return m_SeparateFormat; }
+};
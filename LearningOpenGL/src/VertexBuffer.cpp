@@ -7,15 +7,41 @@ VertexBuffer::VertexBuffer(const void* data, unsigned int size)
     GLCall(glGenBuffers(1, &m_RenderedID));
     GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_RenderedID));
     GLCall(glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW));    // Look for usage in document(https://docs.gl/)
+    if (data)
+        RenderStats::Add(RenderCounter::BufferBytesUploaded, size);
+}
+
+VertexBuffer::VertexBuffer(VertexBuffer&& other) noexcept
+    : m_RenderedID(other.m_RenderedID)
+{
+    other.m_RenderedID = 0;
+}
+
+VertexBuffer& VertexBuffer::operator=(VertexBuffer&& other) noexcept
+{
+    if (this != &other)
+    {
+        if (m_RenderedID)
+        {
+            GLCall(glDeleteBuffers(1, &m_RenderedID));
+        }
+        m_RenderedID = other.m_RenderedID;
+        other.m_RenderedID = 0;
+    }
+    return *this;
 }
 
 VertexBuffer::~VertexBuffer()
 {
-    GLCall(glDeleteBuffers(1, &m_RenderedID));
+    if (m_RenderedID)
+    {
+        GLCall(glDeleteBuffers(1, &m_RenderedID));
+    }
 }
 
 void VertexBuffer::Bind() const
 {
+    RenderStats::Add(RenderCounter::BufferBinds);
     GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_RenderedID));
 }
 
@@ -23,3 +49,10 @@ void VertexBuffer::Unbind() const
 {
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
+
+void VertexBuffer::SetData(const void* data, unsigned int size, unsigned int offset)
+{
+    Bind();
+    GLCall(glBufferSubData(GL_ARRAY_BUFFER, offset, size, data));
+    RenderStats::Add(RenderCounter::BufferBytesUploaded, size);
+}
@@ -10,7 +10,21 @@ public:
 
 	~VertexBuffer();
 
+	// Move only, a moved-from object owns GL name 0
+	VertexBuffer(VertexBuffer&& other) noexcept;
+
+	VertexBuffer& operator=(VertexBuffer&& other) noexcept;
+
+	VertexBuffer(const VertexBuffer&) = delete;
+
+	VertexBuffer& operator=(const VertexBuffer&) = delete;
+
 	void Bind() const;
 
 	void Unbind() const;
+
+	// Overwrite part of the buffer, offset and size in bytes
+	void SetData(const void* data, unsigned int size, unsigned int offset = 0);
+
+	inline unsigned int GetRendererID() const { return m_RenderedID; }
 };
\ No newline at end of file
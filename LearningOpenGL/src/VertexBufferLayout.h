@@ -28,39 +28,77 @@ private:
 
 	unsigned int m_Stride;
 
+	// FNV-1a over every element, updated on Push so lookups by format are cheap
+	unsigned long long m_Hash;
+
+	void AddElement(unsigned int type, unsigned int count, unsigned char normalized)
+	{
+		m_Elements.push_back({ type, count, normalized });
+		m_Stride += count * VertexBufferElement::GetSizeOfType(type);
+
+		const unsigned int values[] = { type, count, normalized };
+		for (unsigned int value : values)
+		{
+			m_Hash ^= value;
+			m_Hash *= 1099511628211ull;
+		}
+	}
+
 public:
 	VertexBufferLayout()
-		: m_Stride(0)
+		: m_Stride(0), m_Hash(14695981039346656037ull)
 	{}
 
 	template<typename T>
 	void Push(unsigned int count)
 	{
-		static_assert(false);
+		static_assert(sizeof(T) == 0, "No vertex attribute type for T");
 	}
 
-	template<>
-	void Push<float>(unsigned int count)
+	// For layouts that are only known at runtime, e.g. read from a mesh file
+	void PushElement(const VertexBufferElement& element)
 	{
-		m_Elements.push_back({ GL_FLOAT, count, GL_FALSE });
-		m_Stride += count * VertexBufferElement::GetSizeOfType(GL_FLOAT);
+		AddElement(element.type, element.count, element.normalized);
 	}
 
-	template<>
-	void Push<unsigned int>(unsigned int count)
-	{
-		m_Elements.push_back({ GL_UNSIGNED_INT, count, GL_FALSE });
-		m_Stride += count * VertexBufferElement::GetSizeOfType(GL_UNSIGNED_INT);
-	}
+	inline const std::vector<VertexBufferElement>& GetElements() const { return m_Elements; }
+
+	inline unsigned int GetStride() const { return m_Stride; }
 
-	template<>
-	void Push<unsigned char>(unsigned int count)
+	inline unsigned long long GetHash() const { return m_Hash; }
+
+	bool operator==(const VertexBufferLayout& other) const
 	{
-		m_Elements.push_back({ GL_UNSIGNED_BYTE, count, GL_TRUE });
-		m_Stride += count * VertexBufferElement::GetSizeOfType(GL_UNSIGNED_BYTE);
+		if (m_Stride != other.m_Stride || m_Elements.size() != other.m_Elements.size())
+			return false;
+
+		for (unsigned int i = 0; i < m_Elements.size(); ++i)
+		{
+			const auto& a = m_Elements[i];
+			const auto& b = other.m_Elements[i];
+			if (a.type != b.type || a.count != b.count || a.normalized != b.normalized)
+				return false;
+		}
+		return true;
 	}
 
-	inline std::vector<VertexBufferElement> GetElements() const { return m_Elements; }
+	bool operator!=(const VertexBufferLayout& other) const { return !(*this == other); }
+};
 
-	inline unsigned int GetStride() const { return m_Stride; }
-};
\ No newline at end of file
+template<>
+inline void VertexBufferLayout::Push<float>(unsigned int count)
+{
+	AddElement(GL_FLOAT, count, GL_FALSE);
+}
+
+template<>
+inline void VertexBufferLayout::Push<unsigned int>(unsigned int count)
+{
+	AddElement(GL_UNSIGNED_INT, count, GL_FALSE);
+}
+
+template<>
+inline void VertexBufferLayout::Push<unsigned char>(unsigned int count)
+{
+	AddElement(GL_UNSIGNED_BYTE, count, GL_TRUE);
+}
@@ -0,0 +1,87 @@
+#include "BuddyAllocator.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+static int s_Failures = 0;
+
+static void Check(bool condition, const char* what)
+{
+    if (!condition)
+    {
+        std::cout << "Error: " << what << std::endl;
+        ++s_Failures;
+    }
+}
+
+struct Block
+{
+    unsigned int Offset;
+    unsigned int Size;  // rounded up to the block that was handed out
+};
+
+int main()
+{
+    Check(BuddyAllocator::NextPowerOfTwo(1) == 1 && BuddyAllocator::NextPowerOfTwo(5) == 8 && BuddyAllocator::NextPowerOfTwo(64) == 64,
+        "NextPowerOfTwo rounds wrong");
+    Check(BuddyAllocator::NextPowerOfTwo(0x80000001u) == 0, "NextPowerOfTwo does not report overflow");
+
+    /* Sizes round up to a power of two of min blocks, and the block is aligned to that size */
+    BuddyAllocator allocator(1024, 4);
+    unsigned int first = allocator.Allocate(5);
+    Check(first != BuddyAllocator::InvalidOffset && first % 8 == 0 && allocator.GetUsed() == 8, "5 units do not get an aligned block of 8");
+    unsigned int second = allocator.Allocate(100);
+    Check(second != BuddyAllocator::InvalidOffset && second % 128 == 0 && allocator.GetUsed() == 136, "100 units do not get an aligned block of 128");
+    Check(allocator.Allocate(0) == BuddyAllocator::InvalidOffset, "empty allocation succeeds");
+    Check(allocator.Allocate(1025) == BuddyAllocator::InvalidOffset, "allocation larger than the capacity succeeds");
+    Check(allocator.Allocate(1024) == BuddyAllocator::InvalidOffset, "full capacity is handed out twice");
+    allocator.Free(first);
+    allocator.Free(second);
+    Check(allocator.GetUsed() == 0, "usage is not back to 0");
+
+    /* Random allocations never overlap or leave the capacity, and once everything is
+     * freed the buddies have merged back into one block */
+    std::vector<unsigned char> owner(1024, 0);
+    std::vector<Block> blocks;
+    std::srand(1);
+    bool overlap = false, outside = false;
+    for (int i = 0; i < 20000; ++i)
+    {
+        if (blocks.empty() || std::rand() % 2)
+        {
+            unsigned int size = 1 + std::rand() % 60;
+            unsigned int offset = allocator.Allocate(size);
+            if (offset == BuddyAllocator::InvalidOffset)
+                continue;
+
+            Block block = { offset, BuddyAllocator::NextPowerOfTwo((size + 3) / 4) * 4 };
+            outside |= block.Offset + block.Size > 1024 || block.Offset % block.Size != 0;
+            for (unsigned int u = block.Offset; u < block.Offset + block.Size && u < 1024; ++u)
+            {
+                overlap |= owner[u] != 0;
+                owner[u] = 1;
+            }
+            blocks.push_back(block);
+        }
+        else
+        {
+            size_t index = std::rand() % blocks.size();
+            allocator.Free(blocks[index].Offset);
+            for (unsigned int u = blocks[index].Offset; u < blocks[index].Offset + blocks[index].Size; ++u)
+                owner[u] = 0;
+            blocks.erase(blocks.begin() + index);
+        }
+    }
+    Check(!overlap, "allocations overlap");
+    Check(!outside, "allocation is misaligned or past the capacity");
+
+    for (const Block& block : blocks)
+        allocator.Free(block.Offset);
+    Check(allocator.GetUsed() == 0, "usage is not back to 0 after random allocations");
+    Check(allocator.Allocate(1024) == 0, "freed buddies did not merge back into the whole range");
+
+    if (s_Failures == 0)
+        std::cout << "BuddyAllocator: all checks passed" << std::endl;
+    return s_Failures == 0 ? 0 : 1;
+}
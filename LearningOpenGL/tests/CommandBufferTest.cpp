@@ -0,0 +1,112 @@
+#include "CommandBuffer.h"
+#include "JobSystem.h"
+#include "ParallelFor.h"
+
+#include <algorithm>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+static int s_Failures = 0;
+
+static void Check(bool condition, const char* what)
+{
+    if (!condition)
+    {
+        std::cout << "Error: " << what << std::endl;
+        ++s_Failures;
+    }
+}
+
+/* Draw i has a key with plenty of ties and order i, FirstIndex tells the draws apart */
+static unsigned long long GetKey(unsigned int i)
+{
+    return DrawQueue::MakeSortKey(i % 3, (i * 7919) % 5, 0);
+}
+
+static void Record(CommandRecorder& recorder, unsigned int count)
+{
+    recorder.Reset();
+    ParallelFor(count, 37, [&recorder](unsigned int begin, unsigned int end)
+    {
+        CommandBuffer& buffer = recorder.GetThreadBuffer();
+        for (unsigned int i = begin; i < end; ++i)
+        {
+            DrawItem item = {};
+            item.SortKey = GetKey(i);
+            item.Mesh.FirstIndex = i;
+            buffer.Draw(item, i);
+        }
+    });
+}
+
+/* FirstIndex of every draw in the list, other commands are skipped */
+static std::vector<unsigned int> GetDraws(const CommandList& list)
+{
+    std::vector<unsigned int> draws;
+    list.ForEach([&draws](const CommandHeader& header, const void* payload)
+    {
+        if (header.Type == CommandType::Draw)
+            draws.push_back(((const DrawCommand*)payload)->Item.Mesh.FirstIndex);
+    });
+    return draws;
+}
+
+int main()
+{
+    JobSystem jobs(4);
+    CommandRecorder recorder;
+    const unsigned int count = 20000;
+
+    /* What a single thread sorting by key, then order would produce */
+    std::vector<unsigned int> expected(count);
+    for (unsigned int i = 0; i < count; ++i)
+        expected[i] = i;
+    std::sort(expected.begin(), expected.end(), [](unsigned int a, unsigned int b)
+    {
+        return GetKey(a) != GetKey(b) ? GetKey(a) < GetKey(b) : a < b;
+    });
+
+    /* Which worker recorded a draw changes from run to run, the merged order must not */
+    for (int run = 0; run < 5; ++run)
+    {
+        Record(recorder, count);
+        CommandList list;
+        list.Clear(glm::vec4(0.0f));
+        Check(recorder.Merge(list) == count && list.GetCount() == count + 1, "Merge lost draws");
+
+        std::vector<CommandType> types;
+        list.ForEach([&types](const CommandHeader& header, const void*) { types.push_back(header.Type); });
+        Check(!types.empty() && types[0] == CommandType::Clear, "Merge did not append after the commands already in the list");
+        Check(GetDraws(list) == expected, "merged draws are not sorted by key, then order");
+    }
+
+    /* Threads outside the job system record into their own buffers */
+    recorder.Reset();
+    std::thread outside([&recorder]()
+    {
+        DrawItem item = {};
+        item.SortKey = GetKey(1);
+        item.Mesh.FirstIndex = 1;
+        recorder.GetThreadBuffer().Draw(item, 1);
+    });
+    outside.join();
+    DrawItem item = {};
+    item.SortKey = GetKey(0);
+    item.Mesh.FirstIndex = 0;
+    recorder.GetThreadBuffer().Draw(item, 0);
+
+    CommandList list;
+    Check(recorder.Merge(list) == 2, "draws of a thread outside the job system are lost");
+    std::vector<unsigned int> draws = GetDraws(list);
+    Check(draws.size() == 2 && (GetKey(0) < GetKey(1) ? draws[0] == 0 : draws[0] == 1), "draws of other threads are not merged in order");
+
+    /* Reset drops everything recorded before */
+    recorder.Reset();
+    list.Reset();
+    Check(recorder.Merge(list) == 0 && list.GetCount() == 0, "Reset kept draws");
+
+    if (s_Failures == 0)
+        std::cout << "CommandBuffer: all checks passed" << std::endl;
+    return s_Failures == 0 ? 0 : 1;
+}
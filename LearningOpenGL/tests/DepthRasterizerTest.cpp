@@ -0,0 +1,45 @@
+#include "DepthRasterizer.h"
+
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <iostream>
+
+static int s_Failures = 0;
+
+static void Check(bool condition, const char* what)
+{
+    if (!condition)
+    {
+        std::cout << "Error: " << what << std::endl;
+        ++s_Failures;
+    }
+}
+
+int main()
+{
+    glm::mat4 viewProjection = glm::perspective(1.2f, 2.0f, 0.1f, 100.0f)
+        * glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    const BoundingBox behind = { glm::vec3(-1.0f, -1.0f, -21.0f), glm::vec3(1.0f, 1.0f, -19.0f) };
+    const unsigned int indices[6] = { 0, 1, 2, 2, 3, 0 };
+    DepthRasterizer rasterizer;
+
+    /* A wall between the camera and the box hides it */
+    const glm::vec3 wall[4] = { { -5.0f, -5.0f, -10.0f }, { 5.0f, -5.0f, -10.0f }, { 5.0f, 5.0f, -10.0f }, { -5.0f, 5.0f, -10.0f } };
+    rasterizer.Begin(viewProjection);
+    rasterizer.AddOccluder(wall, 4, indices, 6, glm::mat4(1.0f));
+    rasterizer.Rasterize();
+    Check(!rasterizer.IsVisible(behind), "box behind a wall is visible");
+
+    /* A large quad crossing the near plane: the part past it lies above the screen, the part in
+     * front of it is clipped by the GPU and hides nothing, so the box behind it stays visible */
+    const BoundingBox above = { glm::vec3(-1.0f, 2.0f, -21.0f), glm::vec3(1.0f, 4.0f, -19.0f) };
+    const glm::vec3 crossing[4] = { { -1.0f, 0.0f, -0.05f }, { 1.0f, 0.0f, -0.05f }, { 1.0f, 3.0f, -2.0f }, { -1.0f, 3.0f, -2.0f } };
+    rasterizer.Begin(viewProjection);
+    rasterizer.AddOccluder(crossing, 4, indices, 6, glm::mat4(1.0f));
+    rasterizer.Rasterize();
+    Check(rasterizer.IsVisible(above), "occluder crossing the near plane hides a box behind it");
+
+    if (s_Failures == 0)
+        std::cout << "DepthRasterizer: all checks passed" << std::endl;
+    return s_Failures == 0 ? 0 : 1;
+}
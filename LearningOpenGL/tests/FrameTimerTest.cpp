@@ -0,0 +1,67 @@
+#include "FrameTimer.h"
+
+#include <cmath>
+#include <iostream>
+
+static int s_Failures = 0;
+
+static void Check(bool condition, const char* what)
+{
+    if (!condition)
+    {
+        std::cout << "Error: " << what << std::endl;
+        ++s_Failures;
+    }
+}
+
+int main()
+{
+    /* Buckets tile the whole range without gaps, every value lands in the bucket it reports */
+    bool tiled = FrameHistogram::GetLowest(0) == 0;
+    for (unsigned int i = 0; i < FrameHistogram::BucketCount; ++i)
+    {
+        tiled &= FrameHistogram::GetIndex(FrameHistogram::GetLowest(i)) == i && FrameHistogram::GetIndex(FrameHistogram::GetHighest(i)) == i;
+        if (i + 1 < FrameHistogram::BucketCount)
+            tiled &= FrameHistogram::GetLowest(i + 1) == FrameHistogram::GetHighest(i) + 1;
+    }
+    Check(tiled, "histogram buckets do not tile the value range");
+
+    FrameHistogram histogram;
+    Check(histogram.GetPercentile(50.0) == 0 && histogram.GetMean() == 0, "empty histogram does not report 0");
+
+    /* Small values get buckets of their own, so percentiles are exact there */
+    for (unsigned long long value = 1; value <= 100; ++value)
+        histogram.Record(value);
+    Check(histogram.GetPercentile(50.0) == 50 && histogram.GetPercentile(99.0) == 99, "percentiles of small values are not exact");
+    Check(histogram.GetPercentile(0.0) == 1 && histogram.GetPercentile(100.0) == 100, "lowest and highest percentile are not the extremes");
+    Check(histogram.GetCount() == 100 && histogram.GetMean() == 50 && histogram.GetMax() == 100, "count, mean or max are wrong");
+
+    /* Large values come out as the upper bound of their bucket, never more than 1/64 above
+     * the exact percentile of the recorded values */
+    histogram.Reset();
+    Check(histogram.GetCount() == 0 && histogram.GetPercentile(50.0) == 0, "Reset kept values");
+    const unsigned long long count = 100000;
+    for (unsigned long long value = 1; value <= count; ++value)
+        histogram.Record(value * 1000);
+    const double percentiles[5] = { 1.0, 50.0, 90.0, 99.0, 99.9 };
+    for (double percentile : percentiles)
+    {
+        const unsigned long long exact = (unsigned long long)std::ceil(percentile / 100.0 * count) * 1000;
+        const unsigned long long reported = histogram.GetPercentile(percentile);
+        Check(reported >= exact && reported <= exact + exact / 64, "percentile is off by more than a bucket");
+    }
+
+    /* The maximum is exact even though its bucket is wide */
+    histogram.Record(123456789);
+    Check(histogram.GetPercentile(100.0) == 123456789 && histogram.GetMax() == 123456789, "maximum is not exact");
+
+    /* Values past the top bucket are counted there instead of indexing past the array */
+    histogram.Reset();
+    histogram.Record(1ull << 50);
+    Check(histogram.GetCount() == 1 && histogram.GetPercentile(50.0) == FrameHistogram::GetHighest(FrameHistogram::BucketCount - 1),
+        "values past the range are not clamped to the top bucket");
+
+    if (s_Failures == 0)
+        std::cout << "FrameTimer: all checks passed" << std::endl;
+    return s_Failures == 0 ? 0 : 1;
+}
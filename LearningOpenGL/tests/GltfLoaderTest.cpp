@@ -0,0 +1,180 @@
+#include "GltfLoader.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static int s_Failures = 0;
+
+static void Check(bool condition, const char* what)
+{
+    if (!condition)
+    {
+        std::cout << "Error: " << what << std::endl;
+        ++s_Failures;
+    }
+}
+
+static const char* s_FilePath = "GltfLoaderTest.gltf";
+
+static std::string Base64(const std::vector<unsigned char>& data)
+{
+    static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string text;
+    for (size_t i = 0; i < data.size(); i += 3)
+    {
+        unsigned int bits = data[i] << 16;
+        if (i + 1 < data.size()) bits |= data[i + 1] << 8;
+        if (i + 2 < data.size()) bits |= data[i + 2];
+        text += alphabet[(bits >> 18) & 63];
+        text += alphabet[(bits >> 12) & 63];
+        text += i + 1 < data.size() ? alphabet[(bits >> 6) & 63] : '=';
+        text += i + 2 < data.size() ? alphabet[bits & 63] : '=';
+    }
+    return text;
+}
+
+template<typename T>
+static void Append(std::vector<unsigned char>& buffer, const T& value)
+{
+    const unsigned char* bytes = (const unsigned char*)&value;
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+/* 60 byte buffer: three float3 positions at 0, three unsigned short indices at 36,
+ * one sparse index (2) at 44 and its float3 value (5, 5, 5) at 48 */
+static std::string CreateBuffer(unsigned short lastIndex)
+{
+    std::vector<unsigned char> buffer;
+    const float positions[9] = { 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f };
+    Append(buffer, positions);
+    const unsigned short indices[4] = { 0, 1, lastIndex, 0 };
+    Append(buffer, indices);
+    Append(buffer, 2u);
+    const float sparse[3] = { 5.0f, 5.0f, 5.0f };
+    Append(buffer, sparse);
+    return Base64(buffer);
+}
+
+static const char* s_BufferViews =
+    "{ \"buffer\": 0, \"byteOffset\": 0, \"byteLength\": 36 }, { \"buffer\": 0, \"byteOffset\": 36, \"byteLength\": 6 },"
+    "{ \"buffer\": 0, \"byteOffset\": 44, \"byteLength\": 4 }, { \"buffer\": 0, \"byteOffset\": 48, \"byteLength\": 12 }";
+
+static const char* s_Accessors =
+    "{ \"bufferView\": 0, \"componentType\": 5126, \"count\": 3, \"type\": \"VEC3\" },"
+    "{ \"bufferView\": 1, \"componentType\": 5123, \"count\": 3, \"type\": \"SCALAR\" }";
+
+static bool Load(GltfScene& scene, const std::string& bufferViews = s_BufferViews, const std::string& accessors = s_Accessors,
+    unsigned short lastIndex = 2)
+{
+    {
+        std::ofstream stream(s_FilePath);
+        stream << "{ \"asset\": { \"version\": \"2.0\" },"
+            << " \"buffers\": [{ \"byteLength\": 60, \"uri\": \"data:application/octet-stream;base64," << CreateBuffer(lastIndex) << "\" }],"
+            << " \"bufferViews\": [" << bufferViews << "], \"accessors\": [" << accessors << "],"
+            << " \"meshes\": [{ \"name\": \"triangle\", \"primitives\": [{ \"attributes\": { \"POSITION\": 0 }, \"indices\": 1 }] }],"
+            << " \"nodes\": [{ \"mesh\": 0 }], \"scenes\": [{ \"nodes\": [0] }], \"scene\": 0 }";
+    }
+    scene = GltfScene();
+    return GltfLoader::Load(s_FilePath, scene);
+}
+
+static bool LoadText(const char* text)
+{
+    {
+        std::ofstream stream(s_FilePath);
+        stream << text;
+    }
+    GltfScene scene;
+    return GltfLoader::Load(s_FilePath, scene);
+}
+
+int main()
+{
+    GltfScene scene;
+    Check(Load(scene) && scene.Meshes.size() == 1 && scene.Instances.size() == 1, "valid triangle does not load");
+    if (!scene.Meshes.empty())
+    {
+        const MeshData& mesh = scene.Meshes[0].Mesh;
+        Check(mesh.GetVertexCount() == 3 && mesh.Indices.size() == 3, "valid triangle has the wrong size");
+        Check(mesh.GetVertexCount() == 3 && mesh.GetPosition(1) == glm::vec3(1.0f, 0.0f, 0.0f), "valid triangle has the wrong positions");
+    }
+
+    /* Sparse values replace the element they index, the others are kept */
+    const std::string sparse =
+        "{ \"bufferView\": 0, \"componentType\": 5126, \"count\": 3, \"type\": \"VEC3\","
+        " \"sparse\": { \"count\": 1, \"indices\": { \"bufferView\": 2, \"componentType\": 5125 }, \"values\": { \"bufferView\": 3 } } },"
+        "{ \"bufferView\": 1, \"componentType\": 5123, \"count\": 3, \"type\": \"SCALAR\" }";
+    Check(Load(scene, s_BufferViews, sparse), "sparse accessor does not load");
+    if (!scene.Meshes.empty() && scene.Meshes[0].Mesh.GetVertexCount() == 3)
+    {
+        const MeshData& mesh = scene.Meshes[0].Mesh;
+        Check(mesh.GetPosition(2) == glm::vec3(5.0f), "sparse value was not substituted");
+        Check(mesh.GetPosition(1) == glm::vec3(1.0f, 0.0f, 0.0f), "sparse accessor changed an element it does not index");
+        Check(mesh.Bounds.Max == glm::vec3(5.0f), "bounds ignore the sparse value");
+    }
+
+    /* Sparse ranges are validated like the dense ones */
+    const std::string sparseOutOfRange =
+        "{ \"bufferView\": 0, \"componentType\": 5126, \"count\": 3, \"type\": \"VEC3\","
+        " \"sparse\": { \"count\": 2, \"indices\": { \"bufferView\": 2, \"componentType\": 5125 }, \"values\": { \"bufferView\": 3 } } },"
+        "{ \"bufferView\": 1, \"componentType\": 5123, \"count\": 3, \"type\": \"SCALAR\" }";
+    Check(!Load(scene, s_BufferViews, sparseOutOfRange), "sparse accessor past its bufferView loads");
+
+    /* An index past the vertices is replaced, never left for the GPU to read */
+    Check(Load(scene, s_BufferViews, s_Accessors, 9), "triangle with an out of range index does not load");
+    if (!scene.Meshes.empty())
+    {
+        const MeshData& mesh = scene.Meshes[0].Mesh;
+        for (unsigned int index : mesh.Indices)
+            Check(index < mesh.GetVertexCount(), "out of range index was kept");
+    }
+
+    /* bufferViews past their buffer, including offsets that would wrap around */
+    Check(!Load(scene, "{ \"buffer\": 0, \"byteOffset\": 4294967295, \"byteLength\": 36 }, { \"buffer\": 0, \"byteOffset\": 36, \"byteLength\": 6 }"),
+        "bufferView offset past the buffer loads");
+    Check(!Load(scene, "{ \"buffer\": 0, \"byteOffset\": 18446744073709551615, \"byteLength\": 36 }, { \"buffer\": 0, \"byteOffset\": 36, \"byteLength\": 6 }"),
+        "bufferView offset that wraps around loads");
+    Check(!Load(scene, "{ \"buffer\": 0, \"byteOffset\": 40, \"byteLength\": 36 }, { \"buffer\": 0, \"byteOffset\": 36, \"byteLength\": 6 }"),
+        "bufferView longer than the buffer loads");
+    Check(!Load(scene, "{ \"buffer\": 1, \"byteLength\": 36 }, { \"buffer\": 0, \"byteOffset\": 36, \"byteLength\": 6 }"),
+        "bufferView of a missing buffer loads");
+
+    /* Negative and fractional integers are rejected instead of cast */
+    Check(!Load(scene, "{ \"buffer\": 0, \"byteOffset\": -4, \"byteLength\": 36 }, { \"buffer\": 0, \"byteOffset\": 36, \"byteLength\": 6 }"),
+        "negative bufferView offset loads");
+    Check(!Load(scene, s_BufferViews,
+        "{ \"bufferView\": 0.5, \"componentType\": 5126, \"count\": 3, \"type\": \"VEC3\" }, { \"bufferView\": 1, \"componentType\": 5123, \"count\": 3, \"type\": \"SCALAR\" }"),
+        "fractional accessor bufferView loads");
+    Check(!Load(scene, s_BufferViews,
+        "{ \"bufferView\": 0, \"componentType\": 5126, \"count\": -1, \"type\": \"VEC3\" }, { \"bufferView\": 1, \"componentType\": 5123, \"count\": 3, \"type\": \"SCALAR\" }"),
+        "negative accessor count loads");
+
+    /* Accessors past their bufferView */
+    Check(!Load(scene, s_BufferViews,
+        "{ \"bufferView\": 0, \"componentType\": 5126, \"count\": 4, \"type\": \"VEC3\" }, { \"bufferView\": 1, \"componentType\": 5123, \"count\": 3, \"type\": \"SCALAR\" }"),
+        "accessor with too many elements loads");
+    Check(!Load(scene, s_BufferViews,
+        "{ \"bufferView\": 0, \"byteOffset\": 40, \"componentType\": 5126, \"count\": 1, \"type\": \"VEC3\" }, { \"bufferView\": 1, \"componentType\": 5123, \"count\": 3, \"type\": \"SCALAR\" }"),
+        "accessor offset past its bufferView loads");
+    Check(!Load(scene, s_BufferViews,
+        "{ \"bufferView\": 0, \"componentType\": 5126, \"count\": 4294967295, \"type\": \"VEC3\" }, { \"bufferView\": 1, \"componentType\": 5123, \"count\": 3, \"type\": \"SCALAR\" }"),
+        "accessor whose size wraps around loads");
+
+    /* Malformed files */
+    Check(!LoadText("{ \"asset\": { \"version\": \"2.0\" }, \"meshes\": ["), "truncated JSON loads");
+    Check(!LoadText("{ \"asset\": { \"version\": \"1.0\" } }"), "glTF 1.0 loads");
+    Check(!LoadText("{ \"asset\": { \"version\": \"2.0\" }, \"buffers\": [{ \"uri\": \"data:application/octet-stream;base64,AAAA\" }] }"),
+        "buffer without byteLength loads");
+    Check(!LoadText("{ \"asset\": { \"version\": \"2.0\" }, \"buffers\": [{ \"byteLength\": 64, \"uri\": \"data:application/octet-stream;base64,AAAA\" }] }"),
+        "buffer shorter than its byteLength loads");
+    Check(!GltfLoader::Load("GltfLoaderTest.missing.gltf", scene), "missing file loads");
+
+    std::remove(s_FilePath);
+
+    if (s_Failures == 0)
+        std::cout << "GltfLoader: all checks passed" << std::endl;
+    return s_Failures == 0 ? 0 : 1;
+}
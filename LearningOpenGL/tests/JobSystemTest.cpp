@@ -0,0 +1,121 @@
+#include "JobSystem.h"
+
+#include <atomic>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+static int s_Failures = 0;
+
+static void Check(bool condition, const char* what)
+{
+    if (!condition)
+    {
+        std::cout << "Error: " << what << std::endl;
+        ++s_Failures;
+    }
+}
+
+int main()
+{
+    JobSystem jobs(4);
+    Check(jobs.GetWorkerCount() == 4 && JobSystem::Get() == &jobs, "JobSystem does not have the requested workers");
+    Check(JobSystem::GetWorkerIndex() == 0, "creating thread is not worker 0");
+
+    /* More jobs than a worker's ring holds, every one runs exactly once */
+    {
+        const unsigned int count = JobSystem::JobPoolSize * 3;
+        std::vector<std::atomic<unsigned int>> runs(count);
+        for (auto& run : runs)
+            run.store(0);
+        JobCounter counter;
+        for (unsigned int i = 0; i < count; ++i)
+            jobs.Submit([&runs, i]() { ++runs[i]; }, &counter);
+        jobs.Wait(counter);
+
+        bool once = counter.IsDone();
+        for (auto& run : runs)
+            once &= run.load() == 1;
+        Check(once, "submitted jobs do not all run exactly once");
+    }
+
+    /* Jobs submitted from jobs, e.g. by a worker stealing the parent */
+    {
+        std::atomic<unsigned int> leaves(0);
+        JobCounter counter;
+        for (unsigned int i = 0; i < 64; ++i)
+        {
+            jobs.Submit([&jobs, &leaves, &counter]()
+            {
+                for (unsigned int j = 0; j < 16; ++j)
+                    jobs.Submit([&leaves]() { ++leaves; }, &counter);
+            }, &counter);
+        }
+        jobs.Wait(counter);
+        Check(leaves.load() == 64 * 16, "nested jobs are lost");
+    }
+
+    /* Continuations start only after every job of their dependency finished */
+    {
+        std::atomic<unsigned int> done(0);
+        std::atomic<bool> early(false);
+        JobCounter dependency, counter;
+        for (unsigned int i = 0; i < 256; ++i)
+        {
+            jobs.Submit([&done]()
+            {
+                std::this_thread::yield();
+                ++done;
+            }, &dependency);
+        }
+        jobs.SubmitAfter(dependency, [&done, &early]() { early = done.load() != 256; }, &counter);
+        jobs.Wait(counter);
+        jobs.Wait(dependency);
+        Check(!early, "continuation ran before its dependency finished");
+
+        /* Dependency already done, the continuation is pushed right away */
+        std::atomic<bool> ran(false);
+        jobs.SubmitAfter(dependency, [&ran]() { ran = true; }, &counter);
+        jobs.Wait(counter);
+        Check(ran.load(), "continuation of a finished dependency does not run");
+    }
+
+    /* Main thread jobs run on the creating thread while it waits */
+    {
+        std::thread::id runner;
+        JobCounter counter;
+        jobs.Submit([&jobs, &runner, &counter]()
+        {
+            jobs.SubmitMainThread([&runner]() { runner = std::this_thread::get_id(); }, &counter);
+        }, &counter);
+        jobs.Wait(counter);
+        Check(runner == std::this_thread::get_id(), "main thread job ran on another thread");
+    }
+
+    /* Every index once, for batch sizes that do and do not divide the count */
+    const unsigned int counts[3] = { 1, 1000, 4097 };
+    const unsigned int batchSizes[3] = { 0, 7, 64 };
+    for (unsigned int count : counts)
+    {
+        for (unsigned int batchSize : batchSizes)
+        {
+            std::vector<std::atomic<unsigned int>> hits(count);
+            for (auto& hit : hits)
+                hit.store(0);
+            jobs.ParallelFor(count, batchSize, [&hits](unsigned int begin, unsigned int end)
+            {
+                for (unsigned int i = begin; i < end; ++i)
+                    ++hits[i];
+            });
+
+            bool once = true;
+            for (auto& hit : hits)
+                once &= hit.load() == 1;
+            Check(once, "ParallelFor does not visit every index exactly once");
+        }
+    }
+
+    if (s_Failures == 0)
+        std::cout << "JobSystem: all checks passed" << std::endl;
+    return s_Failures == 0 ? 0 : 1;
+}
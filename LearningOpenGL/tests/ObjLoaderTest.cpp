@@ -0,0 +1,84 @@
+#include "ObjLoader.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+static int s_Failures = 0;
+
+static void Check(bool condition, const char* what)
+{
+    if (!condition)
+    {
+        std::cout << "Error: " << what << std::endl;
+        ++s_Failures;
+    }
+}
+
+static const char* s_FilePath = "ObjLoaderTest.obj";
+
+static bool Load(const std::string& text, MeshData& mesh)
+{
+    {
+        std::ofstream stream(s_FilePath, std::ios::binary);
+        stream << text;
+    }
+    mesh = MeshData();
+    return ObjLoader::Load(s_FilePath, mesh);
+}
+
+/* Positions of the triangle'th triangle equal a, b and c */
+static bool IsTriangle(const MeshData& mesh, unsigned int triangle, const glm::vec3& a, const glm::vec3& b, const glm::vec3& c)
+{
+    if (mesh.Indices.size() < (triangle + 1) * 3)
+        return false;
+    const unsigned int* indices = &mesh.Indices[triangle * 3];
+    return mesh.GetPosition(indices[0]) == a && mesh.GetPosition(indices[1]) == b && mesh.GetPosition(indices[2]) == c;
+}
+
+int main()
+{
+    const std::string triangle = "v 0 0 0\nv 1 0 0\nv 0 1 0\nvt 0 0\nvt 1 0\nvt 0 1\nvn 0 0 1\n";
+    const glm::vec3 a(0.0f), b(1.0f, 0.0f, 0.0f), c(0.0f, 1.0f, 0.0f);
+    MeshData mesh;
+
+    Check(Load(triangle + "f 1/1/1 2/2/1 3/3/1\n", mesh) && IsTriangle(mesh, 0, a, b, c), "plain triangle does not load");
+
+    /* Quads are split into a fan sharing the first corner */
+    Check(Load(triangle + "v 1 1 0\nf 1 2 4 3\n", mesh) && mesh.Indices.size() == 6 && mesh.GetVertexCount() == 4,
+        "quad is not split into two triangles");
+
+    /* Negative indices count back from the last element read so far, per attribute */
+    Check(Load(triangle + "f -3/-3/-1 -2/-2/-1 -1/-1/-1\n", mesh) && IsTriangle(mesh, 0, a, b, c), "negative indices do not resolve");
+    Check(Load(triangle + "f -3//-1 -2//-1 -1//-1\nv 5 5 5\nf -4 -3 -1\n", mesh) &&
+        IsTriangle(mesh, 0, a, b, c) && IsTriangle(mesh, 1, a, b, glm::vec3(5.0f)), "negative indices ignore vertices added later");
+
+    /* A chunk only knows its own vertices, relative indices have to be rebased across chunks */
+    std::string large = triangle;
+    const std::string comment = "# padding to push the next face into another chunk of the parser\n";
+    while (large.size() < (5 << 20))
+        large += comment;
+    large += "v 5 5 5\nf -4 -3 -1\n";
+    Check(Load(large, mesh) && IsTriangle(mesh, 0, a, b, glm::vec3(5.0f)), "negative indices are not rebased across chunks");
+
+    /* Indices past any attribute stream reject the file */
+    Check(!Load(triangle + "f 1 2 4\n", mesh), "position index past the end loads");
+    Check(!Load(triangle + "f -4 -3 -2\n", mesh), "negative index before the first position loads");
+    Check(!Load(triangle + "f 1/4 2/1 3/1\n", mesh), "texcoord index past the end loads");
+    Check(!Load(triangle + "f 1//2 2//1 3//1\n", mesh), "normal index past the end loads");
+    Check(!Load(triangle + "f 0 1 2\n", mesh), "index 0 loads");
+    Check(!Load(triangle + "f 1 2 99999999999\n", mesh), "index that does not fit an int loads");
+
+    /* Malformed files */
+    Check(Load(triangle + "f 1 2\nf 1 2 3\n", mesh) && mesh.Indices.size() == 3, "face with two vertices is not skipped");
+    Check(!Load(triangle, mesh), "file without faces loads");
+    Check(!Load("", mesh), "empty file loads");
+    Check(!ObjLoader::Load("ObjLoaderTest.missing.obj", mesh), "missing file loads");
+
+    std::remove(s_FilePath);
+
+    if (s_Failures == 0)
+        std::cout << "ObjLoader: all checks passed" << std::endl;
+    return s_Failures == 0 ? 0 : 1;
+}